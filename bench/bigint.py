@@ -0,0 +1,67 @@
+from fasttimer import timeit
+import sys
+
+if hasattr(sys, "set_int_max_str_digits"):
+    sys.set_int_max_str_digits(0)
+
+def product(lo, hi):
+    if hi - lo < 8:
+        out = 1
+        for i in range(lo, hi):
+            out *= i
+        return out
+    mid = (lo + hi) // 2
+    return product(lo, mid) * product(mid, hi)
+
+def make(digits, seed):
+    # Build a number of roughly the requested size in 31-bit digits without
+    # going through division or string conversion.
+    out = seed
+    while out.bit_length() < digits * 31:
+        out = out * out + seed
+    return out & ((1 << (digits * 31)) - 1)
+
+if True:
+    for size in [20, 40, 80, 160, 320, 640, 1280, 5000]:
+        a = make(size, 0x5DEECE66D)
+        b = make(size, 0x2545F4914F6CDD1D)
+        n = max(1, 20000 // size)
+        def mul():
+            for i in range(n):
+                a * b
+        def sqr():
+            for i in range(n):
+                a * a
+        print(min(timeit(mul,number=1) for x in range(5)), f"mul {size} digits x{n}")
+        print(min(timeit(sqr,number=1) for x in range(5)), f"square {size} digits x{n}")
+        c = make(size // 2, 0x9E3779B97F4A7C15)
+        def div():
+            for i in range(n):
+                a * b // c
+        def mod():
+            for i in range(n):
+                a * b % c
+        print(min(timeit(div,number=1) for x in range(5)), f"div {size*2}/{size//2} digits x{n}")
+        print(min(timeit(mod,number=1) for x in range(5)), f"mod {size*2}/{size//2} digits x{n}")
+
+    print(timeit(lambda: product(1, 30000),number=1), "factorial 30000")
+    print(timeit(lambda: 7 ** 300000,number=1), "7 ** 300000")
+
+    big = 10 ** 100000
+    digits = str(big)
+    print(timeit(lambda: str(big),number=1), "str(10 ** 100000)")
+    print(timeit(lambda: int(digits),number=1), "int() of 100001 digits")
+
+    def stamps():
+        t = 1700000000000000
+        total = 0
+        for i in range(200000):
+            t = t + 1234567
+            total += t % 1000000 + (t // 1000000) - (i << 20)
+        return total
+    print(timeit(stamps,number=1), "microsecond timestamp arithmetic")
+
+    modulus = 2 ** 2048 - 3 ** 300
+    exponent = 2 ** 2047 - 5 ** 400
+    print(timeit(lambda: pow(3 ** 1200 + 12345, exponent, modulus),number=1), "pow() modulo a 2048-bit odd number")
+    print(timeit(lambda: pow(3 ** 1200 + 12345, exponent, modulus + 1),number=1), "pow() modulo a 2048-bit even number")
@@ -22,7 +22,7 @@ KrkValue krk_dirObject(int argc, const KrkValue argv[], int hasKw) {
 	if (IS_INSTANCE(argv[0])) {
 		/* Obtain self-reference */
 		KrkInstance * self = AS_INSTANCE(argv[0]);
-		for (size_t i = 0; i < self->fields.capacity; ++i) {
+		for (size_t i = 0; i < self->fields.used; ++i) {
 			if (!IS_KWARGS(self->fields.entries[i].key)) {
 				krk_writeValueArray(AS_LIST(myList),
 					self->fields.entries[i].key);
@@ -31,7 +31,7 @@ KrkValue krk_dirObject(int argc, const KrkValue argv[], int hasKw) {
 	} else if (IS_CLOSURE(argv[0])) {
 		/* Why not just make closures instances... */
 		KrkClosure * self = AS_CLOSURE(argv[0]);
-		for (size_t i = 0; i < self->fields.capacity; ++i) {
+		for (size_t i = 0; i < self->fields.used; ++i) {
 			if (!IS_KWARGS(self->fields.entries[i].key)) {
 				krk_writeValueArray(AS_LIST(myList),
 					self->fields.entries[i].key);
@@ -40,7 +40,7 @@ KrkValue krk_dirObject(int argc, const KrkValue argv[], int hasKw) {
 	} else if (IS_CLASS(argv[0])) {
 		KrkClass * _class = AS_CLASS(argv[0]);
 		while (_class) {
-			for (size_t i = 0; i < _class->methods.capacity; ++i) {
+			for (size_t i = 0; i < _class->methods.used; ++i) {
 				if (!IS_KWARGS(_class->methods.entries[i].key)) {
 					krk_writeValueArray(AS_LIST(myList),
 						_class->methods.entries[i].key);
@@ -53,7 +53,7 @@ KrkValue krk_dirObject(int argc, const KrkValue argv[], int hasKw) {
 	KrkClass * type = krk_getType(argv[0]);
 
 	while (type) {
-		for (size_t i = 0; i < type->methods.capacity; ++i) {
+		for (size_t i = 0; i < type->methods.used; ++i) {
 			if (!IS_KWARGS(type->methods.entries[i].key)) {
 				krk_writeValueArray(AS_LIST(myList),
 					type->methods.entries[i].key);
@@ -265,7 +265,7 @@ KRK_Function(dir) {
 
 		/* Put all the keys from the globals table in it */
 		KrkTable * globals = krk_currentThread.frames[krk_currentThread.frameCount-1].globals;
-		for (size_t i = 0; i < globals->capacity; ++i) {
+		for (size_t i = 0; i < globals->used; ++i) {
 			KrkTableEntry * entry = &globals->entries[i];
 			if (IS_KWARGS(entry->key)) continue;
 			krk_writeValueArray(AS_LIST(myList), entry->key);
@@ -328,27 +328,26 @@ KRK_Function(bin) {
 	return TYPE_ERROR(int,argv[0]);
 }
 
-#define KRK_STRING_FAST(string,offset)  (uint32_t)\
-	((string->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) <= (KRK_OBJ_FLAGS_STRING_UCS1) ? ((uint8_t*)string->codes)[offset] : \
-	((string->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) == (KRK_OBJ_FLAGS_STRING_UCS2) ? ((uint16_t*)string->codes)[offset] : \
-	((uint32_t*)string->codes)[offset]))
-
 int krk_unpackIterable(KrkValue iterable, void * context, int callback(void *, const KrkValue *, size_t)) {
 	if (IS_TUPLE(iterable)) {
 		if (callback(context, AS_TUPLE(iterable)->values.values, AS_TUPLE(iterable)->values.count)) return 1;
 	} else if (IS_list(iterable)) {
 		if (callback(context, AS_LIST(iterable)->values, AS_LIST(iterable)->count)) return 1;
 	} else if (IS_dict(iterable)) {
-		for (size_t i = 0; i < AS_DICT(iterable)->capacity; ++i) {
+		for (size_t i = 0; i < AS_DICT(iterable)->used; ++i) {
 			if (!IS_KWARGS(AS_DICT(iterable)->entries[i].key)) {
 				if (callback(context, &AS_DICT(iterable)->entries[i].key, 1)) return 1;
 			}
 		}
 	} else if (IS_STRING(iterable)) {
-		krk_unicodeString(AS_STRING(iterable));
-		for (size_t i = 0; i < AS_STRING(iterable)->codesLength; ++i) {
-			KrkValue s = krk_string_get(2, (KrkValue[]){iterable,INTEGER_VAL(i)}, i);
-			if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 1;
+		/* Walk the UTF-8 directly, so we never need a codepoint representation. */
+		KrkString * str = AS_STRING(iterable);
+		for (size_t offset = 0; offset < str->length;) {
+			size_t width = UTF8_LEAD_BYTES((unsigned char)str->chars[offset]);
+			/* A truncated sequence at the end is not counted as a codepoint. */
+			if (width > str->length - offset) break;
+			KrkValue s = OBJECT_VAL(krk_copyString(str->chars + offset, width));
+			offset += width;
 			krk_push(s);
 			if (callback(context, &s, 1)) {
 				krk_pop();
@@ -656,7 +655,6 @@ KRK_Method(enumerate,__iter__) {
 	return OBJECT_VAL(self);
 }
 
-extern KrkValue krk_operator_add (KrkValue a, KrkValue b);
 KRK_Method(enumerate,__call__) {
 	METHOD_TAKES_NONE();
 	size_t stackOffset = krk_currentThread.stackTop - krk_currentThread.stack;
@@ -695,10 +693,131 @@ KRK_Method(enumerate,__call__) {
 	return out;
 }
 
+/*
+ * Unboxed kernels for sum(), min() and max() over bytes-like objects,
+ * including arrays. Buffers of unsigned 64-bit items that do not fit in
+ * an int64_t report failure and are iterated normally instead.
+ */
+#define BUFFER_ITEM_TYPES \
+	X('b', signed char,        SIGNED) \
+	X('B', unsigned char,      UNSIGNED) \
+	X('h', short,              SIGNED) \
+	X('H', unsigned short,     UNSIGNED) \
+	X('i', int,                SIGNED) \
+	X('I', unsigned int,       UNSIGNED) \
+	X('l', long,               SIGNED) \
+	X('L', unsigned long,      UNSIGNED) \
+	X('q', long long,          SIGNED) \
+	X('Q', unsigned long long, UNSIGNED) \
+	X('f', float,              FLOAT) \
+	X('d', double,             FLOAT)
+
+static inline int _fits_int64(uint64_t v) {
+	return v <= INT64_MAX;
+}
+#define FITS_SIGNED(v) 1
+#define FITS_UNSIGNED(v) _fits_int64(v)
+
+static int _buffer_sum(const KrkBuffer * buffer, int64_t start, KrkValue * out) {
+	size_t count = buffer->length / buffer->itemsize;
+	switch (buffer->format) {
+#define SUM_SIGNED(t) SUM_INT(t,SIGNED)
+#define SUM_UNSIGNED(t) SUM_INT(t,UNSIGNED)
+#define SUM_INT(t,kind) { \
+		int64_t acc = start; \
+		for (size_t i = 0; i < count; ++i) { \
+			t v; memcpy(&v, buffer->data + i * sizeof(t), sizeof(t)); \
+			if (!FITS_ ## kind(v) || __builtin_add_overflow(acc, (int64_t)v, &acc)) return 0; \
+		} \
+		*out = krk_int_from_int64(acc); \
+		return 1; }
+#define SUM_FLOAT(t) { \
+		if (!count) { *out = INTEGER_VAL(start); return 1; } \
+		double acc = (double)start; \
+		for (size_t i = 0; i < count; ++i) { \
+			t v; memcpy(&v, buffer->data + i * sizeof(t), sizeof(t)); \
+			acc += v; \
+		} \
+		*out = FLOATING_VAL(acc); \
+		return 1; }
+#define X(c,t,kind) case c: SUM_ ## kind(t)
+		BUFFER_ITEM_TYPES
+#undef X
+	}
+	return 0;
+}
+
+static int _buffer_minmax(const KrkBuffer * buffer, int wantMax, KrkValue * out) {
+	size_t count = buffer->length / buffer->itemsize;
+	if (!count) return 0;
+	switch (buffer->format) {
+#define MINMAX_SIGNED(t) MINMAX_INT(t,SIGNED)
+#define MINMAX_UNSIGNED(t) MINMAX_INT(t,UNSIGNED)
+#define MINMAX_INT(t,kind) { \
+		t best; memcpy(&best, buffer->data, sizeof(t)); \
+		for (size_t i = 1; i < count; ++i) { \
+			t v; memcpy(&v, buffer->data + i * sizeof(t), sizeof(t)); \
+			if (wantMax ? v > best : v < best) best = v; \
+		} \
+		if (!FITS_ ## kind(best)) return 0; \
+		*out = krk_int_from_int64(best); \
+		return 1; }
+#define MINMAX_FLOAT(t) { \
+		t best; memcpy(&best, buffer->data, sizeof(t)); \
+		for (size_t i = 1; i < count; ++i) { \
+			t v; memcpy(&v, buffer->data + i * sizeof(t), sizeof(t)); \
+			if (wantMax ? v > best : v < best) best = v; \
+		} \
+		*out = FLOATING_VAL(best); \
+		return 1; }
+#define X(c,t,kind) case c: MINMAX_ ## kind(t)
+		BUFFER_ITEM_TYPES
+#undef X
+	}
+	return 0;
+}
+
+/* Non-contiguous memoryviews can't export a buffer, so leave them to iteration. */
+static int _has_buffer(KrkValue value, KrkBuffer * buffer) {
+	if (!IS_OBJECT(value) || IS_list(value) || IS_TUPLE(value)) return 0;
+	KrkClass * type = krk_getType(value);
+	if (!type->_ongetbuffer || krk_isInstanceOf(value, vm.baseClasses->memoryviewClass)) return 0;
+	return krk_getBuffer(value, buffer);
+}
+
+/*
+ * Add as many of @p values to @p base as possible without boxing: a run of
+ * ints onto an int, or of ints and floats onto a float. Stops at anything
+ * else, or when an int sum would overflow, and returns how many were used.
+ */
+static size_t _sum_numbers(KrkValue * base, const KrkValue * values, size_t count) {
+	size_t i = 0;
+	if (IS_INTEGER(*base)) {
+		int64_t acc = AS_INTEGER(*base), next;
+		for (; i < count && IS_INTEGER(values[i]); ++i) {
+			if (__builtin_add_overflow(acc, (int64_t)AS_INTEGER(values[i]), &next)) break;
+			acc = next;
+		}
+		if (i) *base = krk_int_from_int64(acc);
+	} else if (IS_FLOATING(*base)) {
+		double acc = AS_FLOATING(*base);
+		for (; i < count; ++i) {
+			if (IS_FLOATING(values[i])) acc += AS_FLOATING(values[i]);
+			else if (IS_INTEGER(values[i])) acc += (double)AS_INTEGER(values[i]);
+			else break;
+		}
+		*base = FLOATING_VAL(acc);
+	}
+	return i;
+}
+
 static int _sum_callback(void * context, const KrkValue * values, size_t count) {
 	struct SimpleContext * _context = context;
-	for (size_t i = 0; i < count; ++i) {
-		_context->base = krk_operator_add(_context->base, values[i]);
+	size_t i = 0;
+	while (i < count) {
+		i += _sum_numbers(&_context->base, values + i, count - i);
+		if (i == count) break;
+		_context->base = krk_operator_add(_context->base, values[i++]);
 		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 1;
 	}
 	return 0;
@@ -710,55 +829,86 @@ KRK_Function(sum) {
 	if (hasKw) {
 		krk_tableGet(AS_DICT(argv[argc]), OBJECT_VAL(S("start")), &base);
 	}
+	KrkBuffer buffer;
+	KrkValue result;
+	if (IS_INTEGER(base) && _has_buffer(argv[0], &buffer) && _buffer_sum(&buffer, AS_INTEGER(base), &result)) return result;
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
 	struct SimpleContext context = { base };
 	if (krk_unpackIterable(argv[0], &context, _sum_callback)) return NONE_VAL();
 	return context.base;
 }
 
-static int _min_callback(void * context, const KrkValue * values, size_t count) {
-	struct SimpleContext * _context = context;
-	for (size_t i = 0; i < count; ++i) {
-		if (IS_KWARGS(_context->base)) _context->base = values[i];
-		else {
-			KrkValue check = krk_operator_lt(values[i], _context->base);
-			if (!IS_BOOLEAN(check)) return 1;
-			else if (AS_BOOLEAN(check) == 1) _context->base = values[i];
+/*
+ * Shared by min() and max(). Ints against ints and floats against floats
+ * are compared directly; anything else goes through the comparison operator.
+ */
+static int _minmax(struct SimpleContext * _context, const KrkValue * values, size_t count, int wantMax) {
+	size_t i = 0;
+	if (IS_KWARGS(_context->base) && count) _context->base = values[i++];
+	for (; i < count; ++i) {
+		KrkValue best = _context->base;
+		if (IS_INTEGER(best)) {
+			krk_integer_type b = AS_INTEGER(best);
+			for (; i < count && IS_INTEGER(values[i]); ++i) {
+				krk_integer_type v = AS_INTEGER(values[i]);
+				if (wantMax ? v > b : v < b) {
+					b = v;
+					best = values[i];
+				}
+			}
+		} else if (IS_FLOATING(best)) {
+			double b = AS_FLOATING(best);
+			for (; i < count && IS_FLOATING(values[i]); ++i) {
+				double v = AS_FLOATING(values[i]);
+				if (wantMax ? v > b : v < b) {
+					b = v;
+					best = values[i];
+				}
+			}
 		}
+		_context->base = best;
+		if (i == count) break;
+		KrkValue check = wantMax ? krk_operator_gt(values[i], best) : krk_operator_lt(values[i], best);
+		if (!IS_BOOLEAN(check)) return 1;
+		else if (AS_BOOLEAN(check) == 1) _context->base = values[i];
 	}
 	return 0;
 }
 
+static int _min_callback(void * context, const KrkValue * values, size_t count) {
+	return _minmax(context, values, count, 0);
+}
+
+static int _max_callback(void * context, const KrkValue * values, size_t count) {
+	return _minmax(context, values, count, 1);
+}
+
 KRK_Function(min) {
 	FUNCTION_TAKES_AT_LEAST(1);
 	struct SimpleContext context = { KWARGS_VAL(0) };
+	KrkBuffer buffer;
 	if (argc > 1) {
 		if (_min_callback(&context, argv, argc)) return NONE_VAL();
+	} else if (_has_buffer(argv[0], &buffer) && _buffer_minmax(&buffer, 0, &context.base)) {
+		return context.base;
 	} else {
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
 		if (krk_unpackIterable(argv[0], &context, _min_callback)) return NONE_VAL();
 	}
 	if (IS_KWARGS(context.base)) return krk_runtimeError(vm.exceptions->valueError, "empty argument to %s()", "min");
 	return context.base;
 }
 
-static int _max_callback(void * context, const KrkValue * values, size_t count) {
-	struct SimpleContext * _context = context;
-	for (size_t i = 0; i < count; ++i) {
-		if (IS_KWARGS(_context->base)) _context->base = values[i];
-		else {
-			KrkValue check = krk_operator_gt(values[i], _context->base);
-			if (!IS_BOOLEAN(check)) return 1;
-			else if (AS_BOOLEAN(check) == 1) _context->base = values[i];
-		}
-	}
-	return 0;
-}
-
 KRK_Function(max) {
 	FUNCTION_TAKES_AT_LEAST(1);
 	struct SimpleContext context = { KWARGS_VAL(0) };
+	KrkBuffer buffer;
 	if (argc > 1) {
 		if (_max_callback(&context, argv, argc)) return NONE_VAL();
+	} else if (_has_buffer(argv[0], &buffer) && _buffer_minmax(&buffer, 1, &context.base)) {
+		return context.base;
 	} else {
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
 		if (krk_unpackIterable(argv[0], &context, _max_callback)) return NONE_VAL();
 	}
 	if (IS_KWARGS(context.base)) return krk_runtimeError(vm.exceptions->valueError, "empty argument to %s()", "max");
@@ -1185,6 +1335,62 @@ KRK_Function(abs) {
 	}
 }
 
+KRK_Function(divmod) {
+	FUNCTION_TAKES_EXACTLY(2);
+	KrkClass * type = krk_getType(argv[0]);
+	KrkValue method;
+	while (type) {
+		if (krk_tableGet(&type->methods, OBJECT_VAL(S("__divmod__")), &method)) {
+			krk_push(method);
+			krk_push(argv[0]);
+			krk_push(argv[1]);
+			KrkValue result = krk_callStack(2);
+			if (!IS_NOTIMPL(result)) return result;
+			break;
+		}
+		type = type->base;
+	}
+
+	/* No combined operation available, fall back to the separate operators */
+	KrkValue quot = krk_operator_floordiv(argv[0], argv[1]);
+	if (krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION) return NONE_VAL();
+	krk_push(quot);
+	KrkValue rem = krk_operator_mod(argv[0], argv[1]);
+	if (krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION) return NONE_VAL();
+	krk_push(rem);
+	KrkTuple * out = krk_newTuple(2);
+	out->values.values[out->values.count++] = quot;
+	out->values.values[out->values.count++] = rem;
+	krk_pop();
+	krk_pop();
+	return OBJECT_VAL(out);
+}
+
+extern KrkValue krk_long_pow_mod (KrkValue base, KrkValue exp, KrkValue mod);
+KRK_Function(pow) {
+	FUNCTION_TAKES_AT_LEAST(2);
+	FUNCTION_TAKES_AT_MOST(3);
+	if (argc < 3 || IS_NONE(argv[2])) return krk_operator_pow(argv[0], argv[1]);
+
+	KrkValue result = krk_long_pow_mod(argv[0], argv[1], argv[2]);
+	if (!IS_NOTIMPL(result)) return result;
+
+	KrkClass * type = krk_getType(argv[0]);
+	KrkValue method;
+	while (type) {
+		if (krk_tableGet(&type->methods, OBJECT_VAL(S("__pow__")), &method)) {
+			krk_push(method);
+			krk_push(argv[0]);
+			krk_push(argv[1]);
+			krk_push(argv[2]);
+			return krk_callStack(3);
+		}
+		type = type->base;
+	}
+
+	return krk_runtimeError(vm.exceptions->typeError, "unsupported operand types for pow(): '%T', '%T', '%T'", argv[0], argv[1], argv[2]);
+}
+
 KRK_Function(format) {
 	FUNCTION_TAKES_AT_LEAST(1);
 	FUNCTION_TAKES_AT_MOST(2);
@@ -1482,6 +1688,15 @@ void _createAndBind_builtins(void) {
 	BUILTIN_FUNCTION("abs", FUNC_NAME(krk,abs),
 		"@brief Obtain the absolute value of a numeric.\n"
 		"@arguments iterable");
+	BUILTIN_FUNCTION("divmod", FUNC_NAME(krk,divmod),
+		"@brief Obtain the quotient and remainder of a floor division.\n"
+		"@arguments a,b\n\n"
+		"Equivalent to @c (a//b,a%b), but computed in one step for types that support it.");
+	BUILTIN_FUNCTION("pow", FUNC_NAME(krk,pow),
+		"@brief Raise a number to a power, optionally modulo a third.\n"
+		"@arguments base,exp,mod=None\n\n"
+		"With @p mod, computes @c (base**exp)%mod without building the full power. "
+		"A negative @p exp raises the inverse of @p base modulo @p mod.");
 	BUILTIN_FUNCTION("format", FUNC_NAME(krk,format),
 		"@brief Format a value for string printing.\n"
 		"@arguments value[,format_spec]");
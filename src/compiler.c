@@ -410,6 +410,7 @@ static void complexAssignment(struct GlobalState * state, ChunkRecorder before,
 static void complexAssignmentTargets(struct GlobalState * state, KrkScanner oldScanner, Parser oldParser, size_t targetCount, int parenthesized);
 static int invalidTarget(struct GlobalState * state, int exprType, const char * description);
 static void call(struct GlobalState * state, int exprType, RewindState *rewind);
+static void namedVariable(struct GlobalState * state, KrkToken name, int exprType);
 
 static void finishError(struct GlobalState * state, KrkToken * token) {
 	if (!token->linePtr) token->linePtr = token->start;
@@ -770,9 +771,16 @@ static void number(struct GlobalState * state, int exprType) {
 	const char * start = state->parser.previous.start;
 	invalidTarget(state, exprType, "literal");
 
-	for (size_t j = 0; j < state->parser.previous.length; ++j) {
-		if (state->parser.previous.start[j] == '.') {
-			double value = strtod(start, NULL);
+	/* Anything with a decimal point or an exponent is a float, but 0x1e is hex. */
+	size_t width = state->parser.previous.literalWidth;
+	int isHex = width > 1 && start[0] == '0' && (start[1] == 'x' || start[1] == 'X');
+	for (size_t j = 0; !isHex && j < width; ++j) {
+		if (start[j] == '.' || start[j] == 'e' || start[j] == 'E') {
+			double value;
+			if (krk_parseDouble(start, width, &value)) {
+				error("invalid numeric literal");
+				return;
+			}
 			emitConstant(FLOATING_VAL(value));
 			return;
 		}
@@ -1858,7 +1866,7 @@ static void emitLoop(struct GlobalState * state, int loopStart, uint8_t loopType
 
 	emitByte(loopType);
 
-	int offset = currentChunk()->count - loopStart + ((loopType == OP_LOOP_ITER) ? -1 : 2);
+	int offset = currentChunk()->count - loopStart + ((loopType == OP_LOOP_ITER || loopType == OP_RANGE_LOOP) ? -1 : 2);
 	if (offset > 0xFFFF) error("Loop jump offset is too large for opcode.");
 	emitBytes(offset >> 8, offset);
 
@@ -2067,6 +2075,71 @@ static void whileStatement(struct GlobalState * state) {
 	patchBreaks(state, loopStart);
 }
 
+/**
+ * @brief Check if a 'for' loop iterates directly over a call to 'range'.
+ *
+ * Scans ahead without consuming anything for 'range(...)' followed by
+ * the ':' that opens the loop body, with one to three plain positional
+ * arguments. 'range' must not name a local or upvalue; whether it really
+ * is the builtin is checked at runtime by OP_RANGE_START.
+ *
+ * @return The number of arguments to 'range', or 0 if this is not a 'range' loop.
+ */
+static int rangeLoopArgs(struct GlobalState * state) {
+	KrkToken name = state->parser.current;
+	if (name.type != TOKEN_IDENTIFIER || name.length != 5 || memcmp(name.start, "range", 5)) return 0;
+	if (state->current->type == TYPE_CLASS) return 0;
+	for (Compiler * compiler = state->current; compiler; compiler = compiler->enclosing) {
+		for (size_t i = 0; i < compiler->localCount; ++i) {
+			if (identifiersEqual(&name, &compiler->locals[i].name)) return 0;
+		}
+	}
+
+	KrkScanner ahead = krk_tellScanner(&state->scanner);
+	if (krk_scanToken(&ahead).type != TOKEN_LEFT_PAREN) return 0;
+
+	int depth = 0, argCount = 1, expectArg = 1;
+	for (;;) {
+		KrkToken token = krk_scanToken(&ahead);
+		switch (token.type) {
+			case TOKEN_EOF:
+			case TOKEN_ERROR:
+				return 0;
+			case TOKEN_INDENTATION:
+			case TOKEN_EOL:
+			case TOKEN_RETRY:
+				continue;
+			case TOKEN_LEFT_PAREN:
+			case TOKEN_LEFT_SQUARE:
+			case TOKEN_LEFT_BRACE:
+				depth++;
+				break;
+			case TOKEN_RIGHT_PAREN:
+			case TOKEN_RIGHT_SQUARE:
+			case TOKEN_RIGHT_BRACE:
+				if (depth == 0) {
+					/* Empty argument list, or trailing comma */
+					if (expectArg || argCount > 3) return 0;
+					return krk_scanToken(&ahead).type == TOKEN_COLON ? argCount : 0;
+				}
+				depth--;
+				break;
+			default:
+				if (depth) break;
+				if (token.type == TOKEN_COMMA) {
+					argCount++;
+					expectArg = 1;
+					continue;
+				}
+				/* Unpacking, keyword arguments, and generator expressions take the normal path. */
+				if (expectArg && (token.type == TOKEN_ASTERISK || token.type == TOKEN_POW)) return 0;
+				if (token.type == TOKEN_EQUAL || token.type == TOKEN_FOR) return 0;
+				break;
+		}
+		expectArg = 0;
+	}
+}
+
 static void forStatement(struct GlobalState * state) {
 	/* I'm not sure if I want this to be more like Python or C/Lox/etc. */
 	size_t blockWidth = (state->parser.previous.type == TOKEN_INDENTATION) ? state->parser.previous.length : 0;
@@ -2103,8 +2176,35 @@ static void forStatement(struct GlobalState * state) {
 	int loopStart;
 	int exitJump;
 	int isIter = 0;
+	int rangeArgs = 0;
+	int isIn = !matchedEquals && match(TOKEN_IN);
+
+	if (isIn && varCount == 1 && !sawComma && (rangeArgs = rangeLoopArgs(state))) {
+		/*
+		 * for i in range(...): count in the loop slots directly instead of
+		 * building a range iterator; see rangeStart() in the VM.
+		 */
+		beginScope(state);
+		advance();
+		namedVariable(state, state->parser.previous, EXPR_NORMAL);
+		consume(TOKEN_LEFT_PAREN, "Expected '(' after 'range'.");
+		startEatingWhitespace();
+		for (int i = 0; i < rangeArgs; ++i) {
+			if (i) consume(TOKEN_COMMA, "Expected ',' between arguments.");
+			expression(state);
+		}
+		stopEatingWhitespace();
+		consume(TOKEN_RIGHT_PAREN, "Expected ')' after arguments.");
+		endScope(state);
 
-	if (!matchedEquals && match(TOKEN_IN)) {
+		anonymousLocal(state);
+		anonymousLocal(state);
+		anonymousLocal(state);
+		EMIT_OPERAND_OP(OP_RANGE_START, rangeArgs);
+		loopStart = currentChunk()->count;
+		exitJump = emitJump(OP_RANGE_ITER);
+
+	} else if (isIn) {
 
 		beginScope(state);
 		expression(state);
@@ -2160,9 +2260,9 @@ static void forStatement(struct GlobalState * state) {
 	endScope(state);
 
 	state->current->loopLocalCount = oldLocalCount;
-	emitLoop(state, loopStart, isIter ? OP_LOOP_ITER : OP_LOOP);
+	emitLoop(state, loopStart, rangeArgs ? OP_RANGE_LOOP : (isIter ? OP_LOOP_ITER : OP_LOOP));
 	patchJump(exitJump);
-	emitByte(OP_POP);
+	if (!rangeArgs) emitByte(OP_POP);
 	optionalElse(state, blockWidth);
 	patchBreaks(state, loopStart);
 	endScope(state);
@@ -0,0 +1,442 @@
+/**
+ * @file    dtoa.c
+ * @brief   Conversions between doubles and decimal strings.
+ *
+ * Formatting produces the shortest string that reads back as the same
+ * double, using Florian Loitsch's Grisu3 ("Printing Floating-Point Numbers
+ * Quickly and Accurately with Integers", PLDI 2010). Grisu3 knows when it
+ * can't guarantee the shortest result, which happens for around 0.5% of
+ * doubles; those go through snprintf and strtod instead.
+ *
+ * Parsing uses the Clinger fast path for short inputs with small exponents,
+ * then the Eisel-Lemire algorithm (Daniel Lemire, "Number Parsing at a
+ * Gigabyte per Second", 2021) for anything with up to 19 significant
+ * digits, and only falls back to strtod for longer inputs or the rare
+ * cases Eisel-Lemire can not decide.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+
+#include <kuroko/vm.h>
+
+#include "private.h"
+#include "dtoa_tables.h"
+
+typedef struct {
+	uint64_t f;
+	int e;
+} DiyFp;
+
+#define DOUBLE_HIDDEN_BIT   ((uint64_t)1 << 52)
+#define DOUBLE_FRAC_MASK    (DOUBLE_HIDDEN_BIT - 1)
+
+/**
+ * @brief Full 64x64 multiplication; returns the low half and stores the high half.
+ */
+static inline uint64_t _mul128(uint64_t a, uint64_t b, uint64_t * hi) {
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef unsigned __int128 uint128;
+	uint128 r = (uint128)a * b;
+	*hi = r >> 64;
+	return (uint64_t)r;
+#else
+	uint64_t a_lo = (uint32_t)a, a_hi = a >> 32, b_lo = (uint32_t)b, b_hi = b >> 32;
+	uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+	uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+	*hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+	return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+/**
+ * @brief Product of two DiyFps, keeping the rounded upper 64 bits.
+ */
+static DiyFp _diy_mul(DiyFp x, DiyFp y) {
+	uint64_t hi, lo = _mul128(x.f, y.f, &hi);
+	DiyFp out = { hi + (lo >> 63), x.e + y.e + 64 };
+	return out;
+}
+
+static DiyFp _diy_normalize(DiyFp x) {
+	int shift = __builtin_clzll(x.f);
+	x.f <<= shift;
+	x.e -= shift;
+	return x;
+}
+
+static const uint32_t small_powers_of_ten[] = {
+	0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+/**
+ * @brief Narrow down the last digit towards @p w, and check that the result is safe.
+ *
+ * All distances are relative to @c too_high, the upper end of the interval
+ * that is widened to account for the imprecision of the scaled values.
+ */
+static int _round_weed(char * buffer, int length, uint64_t distance_too_high_w, uint64_t unsafe_interval,
+                       uint64_t rest, uint64_t ten_kappa, uint64_t unit) {
+	uint64_t small_distance = distance_too_high_w - unit;
+	uint64_t big_distance = distance_too_high_w + unit;
+
+	while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+	       (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+		buffer[length-1]--;
+		rest += ten_kappa;
+	}
+
+	/* If we could still move closer to the upper bound of the error we don't know which is right. */
+	if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+	    (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) {
+		return 0;
+	}
+
+	return (2 * unit <= rest) && (rest <= unsafe_interval - 4 * unit);
+}
+
+/**
+ * @brief Generate the shortest digits between @p low and @p high.
+ *
+ * The scaled values share an exponent in [-60,-32], so the integer part
+ * fits in 32 bits and each fractional digit can be peeled off with a
+ * multiply by ten.
+ */
+static int _digit_gen(DiyFp low, DiyFp w, DiyFp high, char * buffer, int * length, int * kappa) {
+	uint64_t unit = 1;
+	DiyFp too_low = { low.f - unit, low.e };
+	DiyFp too_high = { high.f + unit, high.e };
+	uint64_t unsafe_interval = too_high.f - too_low.f;
+	int shift = -w.e;
+	uint64_t one = (uint64_t)1 << shift;
+	uint32_t integrals = too_high.f >> shift;
+	uint64_t fractionals = too_high.f & (one - 1);
+
+	/* Largest power of ten that is at most integrals */
+	int guess = (((64 - shift) + 1) * 1233 >> 12) + 1;
+	if (integrals < small_powers_of_ten[guess]) guess--;
+	uint32_t divisor = small_powers_of_ten[guess];
+	*kappa = guess;
+	*length = 0;
+
+	while (*kappa > 0) {
+		buffer[(*length)++] = '0' + integrals / divisor;
+		integrals %= divisor;
+		(*kappa)--;
+		uint64_t rest = ((uint64_t)integrals << shift) + fractionals;
+		if (rest < unsafe_interval) {
+			return _round_weed(buffer, *length, too_high.f - w.f, unsafe_interval, rest, (uint64_t)divisor << shift, unit);
+		}
+		divisor /= 10;
+	}
+
+	for (;;) {
+		fractionals *= 10;
+		unit *= 10;
+		unsafe_interval *= 10;
+		buffer[(*length)++] = '0' + (fractionals >> shift);
+		fractionals &= one - 1;
+		(*kappa)--;
+		if (fractionals < unsafe_interval) {
+			return _round_weed(buffer, *length, (too_high.f - w.f) * unit, unsafe_interval, fractionals, one, unit);
+		}
+	}
+}
+
+/**
+ * @brief Shortest digits for a positive, finite @p value.
+ *
+ * @return 1 on success, with @p value == 0.digits * 10**(@p decimal_exponent + @p length),
+ *         or 0 if Grisu3 could not prove its result is the shortest.
+ */
+static int _grisu3(double value, char * buffer, int * length, int * decimal_exponent) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	int biased = (bits >> 52) & 0x7FF;
+	uint64_t frac = bits & DOUBLE_FRAC_MASK;
+	DiyFp v = biased ? (DiyFp){ frac | DOUBLE_HIDDEN_BIT, biased - 1075 } : (DiyFp){ frac, -1074 };
+
+	/* The neighbouring doubles' midpoints; the lower gap is half as wide at powers of two. */
+	DiyFp plus = _diy_normalize((DiyFp){ (v.f << 1) + 1, v.e - 1 });
+	DiyFp minus = (frac == 0 && biased > 1) ? (DiyFp){ (v.f << 2) - 1, v.e - 2 } : (DiyFp){ (v.f << 1) - 1, v.e - 1 };
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+	DiyFp w = _diy_normalize(v);
+
+	/* Pick a cached power of ten that brings w's exponent into [-60,-32] */
+	int min_exponent = -60 - (w.e + 64);
+	double estimate = (min_exponent + 63) * 0.30102999566398114;
+	int k = (int)estimate;
+	if (estimate > k) k++;
+	const struct CachedPower * cached = &cached_powers[(-CACHED_POWERS_MIN + k - 1) / CACHED_POWERS_STEP + 1];
+	DiyFp ten_mk = { cached->f, cached->e };
+
+	int kappa;
+	int result = _digit_gen(_diy_mul(minus, ten_mk), _diy_mul(w, ten_mk), _diy_mul(plus, ten_mk), buffer, length, &kappa);
+	*decimal_exponent = kappa - cached->k;
+	return result;
+}
+
+/**
+ * @brief Shortest round-trip digits via the C library, for when Grisu3 gives up.
+ */
+static void _fallback_digits(double value, char * buffer, int * length, int * decimal_exponent) {
+	char tmp[40];
+	for (int precision = 15; precision <= 17; ++precision) {
+		snprintf(tmp, sizeof(tmp), "%.*e", precision - 1, value);
+		if (strtod(tmp, NULL) == value) break;
+	}
+
+	/* d.ddddde[+-]xx */
+	char * e = strchr(tmp, 'e');
+	int n = 0;
+	for (char * c = tmp; c < e; ++c) {
+		if (*c != '.') buffer[n++] = *c;
+	}
+	while (n > 1 && buffer[n-1] == '0') n--;
+	*length = n;
+	*decimal_exponent = atoi(e + 1) - n + 1;
+}
+
+size_t krk_doubleToString(double value, char * out) {
+	char * writer = out;
+	if (value != value) return (size_t)(stpcpy(out, "nan") - out);
+	if (signbit(value)) {
+		*writer++ = '-';
+		value = -value;
+	}
+	if (value == INFINITY) return (size_t)(stpcpy(writer, "inf") - out);
+	if (value == 0.0) return (size_t)(stpcpy(writer, "0.0") - out);
+
+	char digits[20];
+	int length, exponent;
+	if (!_grisu3(value, digits, &length, &exponent)) {
+		_fallback_digits(value, digits, &length, &exponent);
+	}
+
+	/* Same layout as Python's repr: positional for 1e-4 <= |value| < 1e16 */
+	int point = length + exponent;
+	if (point > -4 && point <= 16) {
+		if (point <= 0) {
+			*writer++ = '0';
+			*writer++ = '.';
+			for (int i = point; i < 0; ++i) *writer++ = '0';
+			memcpy(writer, digits, length);
+			writer += length;
+		} else if (point < length) {
+			memcpy(writer, digits, point);
+			writer += point;
+			*writer++ = '.';
+			memcpy(writer, digits + point, length - point);
+			writer += length - point;
+		} else {
+			memcpy(writer, digits, length);
+			writer += length;
+			for (int i = length; i < point; ++i) *writer++ = '0';
+			*writer++ = '.';
+			*writer++ = '0';
+		}
+	} else {
+		*writer++ = digits[0];
+		if (length > 1) {
+			*writer++ = '.';
+			memcpy(writer, digits + 1, length - 1);
+			writer += length - 1;
+		}
+		writer += sprintf(writer, "e%c%02d", point - 1 < 0 ? '-' : '+', abs(point - 1));
+	}
+
+	*writer = '\0';
+	return writer - out;
+}
+
+/**
+ * @brief Eisel-Lemire: convert @p w * 10**@p q, for nonzero @p w.
+ *
+ * @return 0 if the result could not be determined without more precision.
+ */
+static int _eisel_lemire(uint64_t w, int64_t q, uint64_t * bits) {
+	if (q < POW5_TABLE_MIN) {
+		*bits = 0;
+		return 1;
+	}
+	if (q > POW5_TABLE_MAX) {
+		*bits = (uint64_t)0x7FF << 52;
+		return 1;
+	}
+
+	int lz = __builtin_clzll(w);
+	w <<= lz;
+
+	/* w * 5**q, to just enough precision to round to 53 bits, most of the time */
+	const uint64_t * power = pow5_128[q - POW5_TABLE_MIN];
+	uint64_t hi, lo = _mul128(w, power[0], &hi);
+	if ((hi & 0x1FF) == 0x1FF) {
+		uint64_t hi2;
+		_mul128(w, power[1], &hi2);
+		lo += hi2;
+		if (hi2 > lo) hi++;
+		if (lo == UINT64_MAX && (q < -27 || q > 55)) return 0;
+	}
+
+	int upper = hi >> 63;
+	uint64_t mantissa = hi >> (upper + 9);
+	int64_t power2 = ((152170 + 65536) * q >> 16) + 63 + upper - lz + 1023;
+
+	if (power2 <= 0) {
+		/* Subnormal */
+		if (-power2 + 1 >= 64) {
+			*bits = 0;
+			return 1;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		*bits = mantissa;
+		return 1;
+	}
+
+	/* Exactly halfway between two doubles; round to even */
+	if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << (upper + 9)) == hi) {
+		mantissa &= ~(uint64_t)1;
+	}
+
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= ((uint64_t)2 << 52)) {
+		mantissa = (uint64_t)1 << 52;
+		power2++;
+	}
+	mantissa &= DOUBLE_FRAC_MASK;
+	if (power2 >= 0x7FF) {
+		power2 = 0x7FF;
+		mantissa = 0;
+	}
+	*bits = mantissa | ((uint64_t)power2 << 52);
+	return 1;
+}
+
+static const double exact_powers_of_ten[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static int _is_digit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+static int _matches(const char * c, const char * end, const char * word) {
+	size_t len = strlen(word);
+	if ((size_t)(end - c) != len) return 0;
+	for (size_t i = 0; i < len; ++i) {
+		if ((c[i] | 0x20) != word[i]) return 0;
+	}
+	return 1;
+}
+
+int krk_parseDouble(const char * str, size_t len, double * out) {
+	const char * c = str;
+	const char * end = str + len;
+	int negative = 0;
+
+	while (c < end && (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r')) c++;
+	while (end > c && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' || end[-1] == '\r')) end--;
+
+	if (c < end && (*c == '-' || *c == '+')) negative = *c++ == '-';
+
+	if (_matches(c, end, "inf") || _matches(c, end, "infinity")) {
+		*out = negative ? -INFINITY : INFINITY;
+		return 0;
+	}
+	if (_matches(c, end, "nan")) {
+		*out = NAN;
+		return 0;
+	}
+
+	const char * start = c;
+	uint64_t w = 0;
+	int digits = 0, any = 0, truncated = 0;
+	int64_t exponent = 0;
+
+	/* Up to 19 significant digits fit in w; beyond that, only note whether they were zero. */
+#define TAKE_DIGIT(in_fraction) do { \
+		int d = *c - '0'; \
+		any = 1; \
+		if (w == 0 && d == 0) { \
+			exponent -= in_fraction; \
+		} else if (digits < 19) { \
+			w = w * 10 + d; \
+			digits++; \
+			exponent -= in_fraction; \
+		} else { \
+			truncated |= d; \
+			exponent += !in_fraction; \
+		} \
+	} while (0)
+#define UNDERSCORE_OK (*c == '_' && c > start && _is_digit(c[-1]) && c + 1 < end && _is_digit(c[1]))
+
+	for (; c < end && (_is_digit(*c) || UNDERSCORE_OK); ++c) {
+		if (*c != '_') TAKE_DIGIT(0);
+	}
+	if (c < end && *c == '.') {
+		c++;
+		for (; c < end && (_is_digit(*c) || (UNDERSCORE_OK && c[-1] != '.')); ++c) {
+			if (*c != '_') TAKE_DIGIT(1);
+		}
+	}
+	if (!any) return 1;
+
+	if (c < end && (*c == 'e' || *c == 'E')) {
+		c++;
+		int exp_negative = 0;
+		if (c < end && (*c == '-' || *c == '+')) exp_negative = *c++ == '-';
+		if (c == end || !_is_digit(*c)) return 1;
+		start = c;
+		int64_t value = 0;
+		for (; c < end && (_is_digit(*c) || UNDERSCORE_OK); ++c) {
+			if (*c != '_' && value < 100000) value = value * 10 + (*c - '0');
+		}
+		exponent += exp_negative ? -value : value;
+	}
+#undef TAKE_DIGIT
+#undef UNDERSCORE_OK
+
+	if (c != end) return 1;
+
+	if (w == 0) {
+		*out = negative ? -0.0 : 0.0;
+		return 0;
+	}
+
+	if (!truncated) {
+#if FLT_EVAL_METHOD == 0
+		/* Both w and the power of ten are exact, so a single rounding gives the right answer. */
+		if (w <= ((uint64_t)1 << 53) && exponent >= -22 && exponent <= 22) {
+			double value = (double)w;
+			value = exponent < 0 ? value / exact_powers_of_ten[-exponent] : value * exact_powers_of_ten[exponent];
+			*out = negative ? -value : value;
+			return 0;
+		}
+#endif
+		uint64_t bits;
+		if (_eisel_lemire(w, exponent, &bits)) {
+			if (negative) bits |= (uint64_t)1 << 63;
+			memcpy(out, &bits, sizeof(bits));
+			return 0;
+		}
+	}
+
+	/* Slow path: let the C library deal with it, without the underscores. */
+	char * tmp = malloc(end - str + 1);
+	char * writer = tmp;
+	for (c = str; c < end; ++c) {
+		if (*c != '_') *writer++ = *c;
+	}
+	*writer = '\0';
+	*out = strtod(tmp, NULL);
+	free(tmp);
+	return 0;
+}
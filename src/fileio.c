@@ -399,9 +399,30 @@ KRK_Method(BinaryFile,read) {
 	return OBJECT_VAL(out);
 }
 
+KRK_Method(BinaryFile,readinto) {
+	METHOD_TAKES_EXACTLY(1);
+	KrkBuffer buffer;
+	if (!krk_getBuffer(argv[1], &buffer)) return NONE_VAL();
+	if (buffer.readonly) return krk_runtimeError(vm.exceptions->typeError, "readinto() argument must be read-write");
+
+	FILE * file = self->filePtr;
+
+	if (!file || feof(file)) {
+		return INTEGER_VAL(0);
+	}
+
+	size_t sizeRead = fread(buffer.data, 1, buffer.length, file);
+	if (sizeRead < buffer.length && ferror(file)) {
+		return krk_runtimeError(vm.exceptions->ioError, "Read error.");
+	}
+
+	return INTEGER_VAL(sizeRead);
+}
+
 KRK_Method(BinaryFile,write) {
 	METHOD_TAKES_EXACTLY(1);
-	if (!IS_BYTES(argv[1])) return TYPE_ERROR(bytes,argv[1]);
+	KrkBuffer buffer;
+	if (!krk_getBuffer(argv[1], &buffer)) return NONE_VAL();
 	/* Find the file ptr reference */
 	FILE * file = self->filePtr;
 
@@ -409,7 +430,7 @@ KRK_Method(BinaryFile,write) {
 		return NONE_VAL();
 	}
 
-	return INTEGER_VAL(fwrite(AS_BYTES(argv[1])->bytes, 1, AS_BYTES(argv[1])->length, file));
+	return INTEGER_VAL(fwrite(buffer.data, 1, buffer.length, file));
 }
 
 #undef CURRENT_CTYPE
@@ -543,7 +564,12 @@ void krk_module_init_fileio(void) {
 	BIND_METHOD(BinaryFile,read);
 	BIND_METHOD(BinaryFile,readline);
 	BIND_METHOD(BinaryFile,readlines);
-	BIND_METHOD(BinaryFile,write);
+	KRK_DOC(BIND_METHOD(BinaryFile,readinto), "@brief Read directly into a writable buffer.\n"
+		"@arguments buffer\n\n"
+		"Reads up to the size of @p buffer, which may be a @ref bytearray or a @ref memoryview of one, "
+		"and returns the number of bytes read.");
+	KRK_DOC(BIND_METHOD(BinaryFile,write), "@brief Write the contents of a bytes-like object to the file.\n"
+		"@arguments data");
 	krk_finalizeClass(BinaryFile);
 
 	KrkClass * Directory = krk_makeClass(module, &KRK_BASE_CLASS(Directory), "Directory", KRK_BASE_CLASS(object));
@@ -245,7 +245,7 @@ static void tab_complete_func(rline_context_t * c) {
 				KrkInstance * modules = krk_newInstance(vm.baseClasses->objectClass);
 				root = OBJECT_VAL(modules);
 				krk_push(root);
-				for (size_t i = 0; i < vm.modules.capacity; ++i) {
+				for (size_t i = 0; i < vm.modules.used; ++i) {
 					KrkTableEntry * entry = &vm.modules.entries[i];
 					if (IS_KWARGS(entry->key)) continue;
 					krk_attachNamedValue(&modules->fields, AS_CSTRING(entry->key), NONE_VAL());
@@ -920,6 +920,7 @@ _finishArgs:
 	BUNDLED(math);
 	BUNDLED(socket);
 	BUNDLED(timeit);
+	BUNDLED(_collections);
 #endif
 
 	KrkValue result = INTEGER_VAL(0);
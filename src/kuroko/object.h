@@ -51,6 +51,14 @@ typedef struct KrkObj {
 #define KRK_OBJ_FLAGS_STRING_UCS2   0x0002
 #define KRK_OBJ_FLAGS_STRING_UCS4   0x0003
 
+/**
+ * @brief Number of codepoints between entries in a string's sparse index.
+ *
+ * A non-ASCII string's @c index, once built, is an array of byte offsets,
+ * one for every @c KRK_STRING_INDEX_STRIDE codepoints.
+ */
+#define KRK_STRING_INDEX_STRIDE 64
+
 #define KRK_OBJ_FLAGS_CODEOBJECT_COLLECTS_ARGS 0x0001
 #define KRK_OBJ_FLAGS_CODEOBJECT_COLLECTS_KWS  0x0002
 #define KRK_OBJ_FLAGS_CODEOBJECT_IS_GENERATOR  0x0004
@@ -96,6 +104,7 @@ typedef struct KrkString {
 	size_t codesLength;  /**< @brief String length in Unicode codepoints */
 	char * chars;        /**< @brief UTF8 canonical data */
 	void * codes;        /**< @brief Codepoint data */
+	size_t * index;      /**< @brief Sparse codepoint-to-byte offset index, built on demand */
 } KrkString;
 
 /**
@@ -179,6 +188,30 @@ typedef struct {
 
 typedef void (*KrkCleanupCallback)(struct KrkInstance *);
 
+/**
+ * @brief Raw view of the memory behind a bytes-like object.
+ *
+ * Filled in by a class's @c _ongetbuffer callback. The pointer is only valid
+ * until the next call back into the VM, as the exporter may resize or move
+ * its storage; consumers that hold on to a buffer should keep a reference to
+ * @c owner and ask for the buffer again before each use.
+ */
+typedef struct {
+	KrkValue owner;   /**< @brief Object that owns the memory */
+	uint8_t * data;   /**< @brief Start of the exported memory */
+	size_t length;    /**< @brief Length of the exported memory in bytes */
+	size_t itemsize;  /**< @brief Size of one item, as described by @c format */
+	char format;      /**< @brief Item type, as an @c array type code; @c 'B' for plain bytes */
+	int readonly;     /**< @brief Whether the memory must not be written to */
+} KrkBuffer;
+
+/**
+ * @brief Fill in a @ref KrkBuffer for an object.
+ *
+ * Returns 1 on success, or 0 with an exception set.
+ */
+typedef int (*KrkBufferCallback)(KrkValue, KrkBuffer *);
+
 /**
  * @brief Type object.
  * @extends KrkObj
@@ -240,6 +273,7 @@ typedef struct KrkClass {
 	KrkObj * _format;
 
 	size_t cacheIndex;
+	KrkBufferCallback _ongetbuffer; /**< @brief C function to call to export the memory of an instance as a @ref KrkBuffer */
 } KrkClass;
 
 /**
@@ -443,9 +477,10 @@ extern void * krk_unicodeString(KrkString * string);
  * @brief Obtain the codepoint at a given index in a string.
  * @memberof KrkString
  *
- * This is a convenience function which ensures that a Unicode codepoint
- * representation has been generated and returns the codepoint value at
- * the requested index. If you need to find multiple codepoints, it
+ * This is a convenience function which returns the codepoint value at
+ * the requested index, using the full codepoint representation if one
+ * is available or the sparse index otherwise. If you need to find
+ * multiple codepoints, it
  * is recommended that you use the KRK_STRING_FAST macro after calling
  * krk_unicodeString instead.
  *
@@ -457,6 +492,23 @@ extern void * krk_unicodeString(KrkString * string);
  */
 extern uint32_t krk_unicodeCodepoint(KrkString * string, size_t index);
 
+/**
+ * @brief Obtain the byte offset of a codepoint index in a string.
+ * @memberof KrkString
+ *
+ * Finds where the UTF-8 sequence for the codepoint at @p index begins
+ * in the string's canonical data. For non-ASCII strings without a full
+ * codepoint representation, a sparse checkpoint index is built on first
+ * use so that lookups only need to scan a short run of bytes.
+ *
+ * @note An @p index equal to or beyond the codepoint length returns the byte length.
+ *
+ * @param string String to index into.
+ * @param index  Codepoint offset to convert.
+ * @return Byte offset into @c chars.
+ */
+extern size_t krk_unicodeOffset(KrkString * string, size_t index);
+
 /**
  * @brief Convert an integer codepoint to a UTF-8 byte representation.
  * @memberof KrkString
@@ -590,6 +642,16 @@ extern KrkTuple *       krk_newTuple(size_t length);
  */
 extern KrkBytes *       krk_newBytes(size_t length, uint8_t * source);
 
+/**
+ * @brief Get the memory behind a bytes-like object.
+ *
+ * Works for any value whose type provides @c _ongetbuffer, such as
+ * @ref bytes, @ref bytearray and @ref memoryview.
+ *
+ * @return 1 on success, or 0 with a @ref TypeError set if @p value does not export a buffer.
+ */
+extern int krk_getBuffer(KrkValue value, KrkBuffer * out);
+
 #define krk_isObjType(v,t) (IS_OBJECT(v) && (AS_OBJECT(v)->type == (t)))
 #define OBJECT_TYPE(value) (AS_OBJECT(value)->type)
 #define IS_STRING(value)   krk_isObjType(value, KRK_OBJ_STRING)
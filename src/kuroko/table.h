@@ -16,6 +16,8 @@
 
 /**
  * @brief One (key,value) pair in a table.
+ *
+ * Entries with a @c kwargs key are unused: either deleted or not yet filled.
  */
 typedef struct {
 	KrkValue key;
@@ -24,11 +26,20 @@ typedef struct {
 
 /**
  * @brief Simple hash table of arbitrary keys to values.
+ *
+ * Tables use a compact layout: @c entries is a dense array of (key,value) pairs
+ * in insertion order, and a separate hash index of 1, 2, 4, or 8-byte slots
+ * maps hashes to positions in @c entries. The index is stored in the same
+ * allocation, directly after the @c capacity entries.
+ *
+ * To iterate over a table, walk @c entries up to @c used and skip any entry
+ * with a @c kwargs key, which marks a deleted pair.
  */
 typedef struct {
-	size_t count;
-	size_t capacity;
-	KrkTableEntry * entries;
+	size_t count;             /**< @brief Number of live entries */
+	size_t capacity;          /**< @brief Size of the entries array */
+	size_t used;              /**< @brief Number of entries consumed, including deleted ones */
+	KrkTableEntry * entries;  /**< @brief Dense, insertion-ordered entry storage, followed by the hash index */
 } KrkTable;
 
 /**
@@ -132,7 +143,8 @@ extern int krk_tableGet_fast(KrkTable * table, struct KrkString * str, KrkValue
  * @memberof KrkTable
  *
  * Scans the table 'table' for the key 'key' and, if found, removes
- * the entry, replacing it with a tombstone value.
+ * the entry. The entry's slot in the dense array is left marked as
+ * deleted until the table is next resized.
  *
  * @param table Table to delete from.
  * @param key   Key to delete.
@@ -145,7 +157,7 @@ extern int krk_tableDelete(KrkTable * table, KrkValue key);
  * @memberof KrkTable
  *
  * Scans the table 'table' for the key 'key' and, if found, removes
- * the entry, replacing it with a tombstone value.
+ * the entry, as with krk_tableDelete(), but compares keys by identity.
  *
  * @param table Table to delete from.
  * @param key   Key to delete.
@@ -157,16 +169,19 @@ extern int krk_tableDeleteExact(KrkTable * table, KrkValue key);
  * @brief Internal table scan function.
  * @memberof KrkTable
  *
- * Scans through the the entry array 'entries' to find the appropriate entry
- * for 'key', return a pointer to the entry, which may be or may not have
- * an associated pair.
+ * Looks up 'key' in 'table' and returns a pointer to its entry.
+ *
+ * @note This used to take an entry array and its capacity, and returned the
+ *       slot where 'key' was or would be inserted; the compact layout has no
+ *       such slot. Extensions built against that form, or against the
+ *       unexported @c krk_findEntryExact, must be rebuilt. To read or update
+ *       a table, use krk_tableGet() and krk_tableSet() instead.
  *
- * @param entries  Table entry array to scan.
- * @param capacity Size of the table entry array, in entries.
- * @param key      Key to locate.
- * @return A pointer to the entry for 'key'.
+ * @param table Table to scan.
+ * @param key   Key to locate.
+ * @return A pointer to the entry for 'key', or NULL if it is not present or could not be hashed.
  */
-extern KrkTableEntry * krk_findEntry(KrkTableEntry * entries, size_t capacity, KrkValue key);
+extern KrkTableEntry * krk_findEntry(KrkTable * table, KrkValue key);
 
 /**
  * @brief Calculate the hash for a value.
@@ -184,10 +199,11 @@ extern int krk_hashValue(KrkValue value, uint32_t *hashOut);
  * @brief Preset the size of a table.
  * @memberof KrkTable
  *
- * Reserves space for a large table.
+ * Reserves space for a large table. Existing entries are
+ * compacted into insertion order in the new storage.
  *
  * @param table Table to resize.
- * @param capacity Target capacity.
+ * @param capacity Number of entries to reserve space for.
  */
 extern void krk_tableAdjustCapacity(KrkTable * table, size_t capacity);
 
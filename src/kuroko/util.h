@@ -226,7 +226,7 @@ static inline KrkValue discardStringBuilder(struct StringBuilder * sb) {
 #define AS_str(o)     (KrkString*)AS_OBJECT(o)
 
 #define IS_striterator(o) (krk_isInstanceOf(o,vm.baseClasses->striteratorClass))
-#define AS_striterator(o) (AS_INSTANCE(o))
+#define AS_striterator(o) ((struct StrIterator*)AS_OBJECT(o))
 
 #define IS_dict(o)    ((IS_INSTANCE(o) && AS_INSTANCE(o)->_class == vm.baseClasses->dictClass) || krk_isInstanceOf(o,vm.baseClasses->dictClass))
 #define AS_dict(o)    (KrkDict*)AS_OBJECT(o)
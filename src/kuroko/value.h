@@ -183,6 +183,38 @@ extern int krk_valuesSameOrEqual(KrkValue a, KrkValue b);
 
 extern KrkValue krk_parse_int(const char * start, size_t width, unsigned int base);
 
+/**
+ * @brief Convert a C integer to an @c int, promoting to a @c long if it does not fit.
+ * @memberof KrkValue
+ */
+extern KrkValue krk_int_from_int64(int64_t val);
+
+/**
+ * @brief Convert an unsigned C integer to an @c int, promoting to a @c long if it does not fit.
+ * @memberof KrkValue
+ */
+extern KrkValue krk_int_from_uint64(uint64_t val);
+
+/**
+ * @brief Extract a signed 64-bit value from an @c int or @c long.
+ * @memberof KrkValue
+ *
+ * Does not raise; the caller decides how to report a failure.
+ *
+ * @param val Value to convert.
+ * @param out Receives the converted value on success.
+ * @return 1 on success, 0 if @p val is not an integer or is out of range.
+ */
+extern int krk_int_to_int64(KrkValue val, int64_t * out);
+
+/**
+ * @brief Extract an unsigned 64-bit value from an @c int or @c long.
+ * @memberof KrkValue
+ *
+ * Like @ref krk_int_to_int64, but fails for negative values.
+ */
+extern int krk_int_to_uint64(KrkValue val, uint64_t * out);
+
 typedef union {
 	KrkValue val;
 	double   dbl;
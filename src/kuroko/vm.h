@@ -31,6 +31,37 @@
  */
 #define KRK_THREAD_SCRATCH_SIZE 3
 
+/**
+ * @def KRK_CACHE_TUPLE_LENGTHS
+ * @brief Tuples with fewer than this many slots are recycled through per-thread free lists.
+ *
+ * @def KRK_CACHE_INSTANCE_SIZES
+ * @brief Number of instance size classes, one per pointer-sized step above @c sizeof(KrkInstance), that are recycled.
+ *
+ * @def KRK_CACHE_DEPTH
+ * @brief Number of objects each free list may hold regardless of demand.
+ */
+#define KRK_CACHE_TUPLE_LENGTHS 8
+#define KRK_CACHE_INSTANCE_SIZES 8
+#define KRK_CACHE_DEPTH 256
+
+/**
+ * @brief Free list of recycled objects of one size class.
+ *
+ * Objects swept by the garbage collector are pushed here, chained through
+ * their @c next pointers, instead of being released, and are handed back out
+ * by the allocator. Their bytes are not counted in @c vm.bytesAllocated
+ * while they sit in the list. Each collection limits a list to the number
+ * of objects taken from it since the previous one, so a burst of garbage
+ * is not held on to once the program stops allocating that kind of object.
+ */
+typedef struct KrkObjectCache {
+	KrkObj * head;      /**< Most recently recycled object */
+	size_t count;       /**< Number of objects in the list */
+	size_t limit;       /**< Number of objects the current sweep may add */
+	size_t taken;       /**< Objects handed out since the last collection */
+} KrkObjectCache;
+
 /**
  * @brief Represents a managed call state in a VM thread.
  *
@@ -144,6 +175,7 @@ struct BaseClasses {
 	KrkClass * ThreadClass;          /**< Threading.Thread */
 	KrkClass * LockClass;            /**< Threading.Lock */
 	KrkClass * CompilerStateClass;   /**< Compiler global state */
+	KrkClass * memoryviewClass;      /**< Zero-copy view of the memory of a bytes-like object */
 };
 
 /**
@@ -172,6 +204,10 @@ typedef struct KrkThreadState {
 	KrkValue * stackMax;       /**< End of allocated stack space. */
 
 	KrkValue scratchSpace[KRK_THREAD_SCRATCH_SIZE]; /**< A place to store a few values to keep them from being prematurely GC'd. */
+
+	KrkObjectCache tupleCache[KRK_CACHE_TUPLE_LENGTHS];       /**< Recycled tuples, by capacity; their value arrays are kept. */
+	KrkObjectCache boundMethodCache;                          /**< Recycled bound methods. */
+	KrkObjectCache instanceCache[KRK_CACHE_INSTANCE_SIZES];   /**< Recycled instances, by allocation size. */
 } KrkThreadState;
 
 /**
@@ -859,6 +895,48 @@ extern KrkValue krk_valueDelAttribute(KrkValue owner, char * name);
  */
 extern void krk_addObjects(void);
 
+/**
+ * @brief Add two values.
+ *
+ * This is equivalent to the opcode instruction OP_ADD.
+ */
+extern KrkValue krk_operator_add(KrkValue,KrkValue);
+
+/**
+ * @brief Subtract the right value from the left.
+ *
+ * This is equivalent to the opcode instruction OP_SUBTRACT.
+ */
+extern KrkValue krk_operator_sub(KrkValue,KrkValue);
+
+/**
+ * @brief Multiply two values.
+ *
+ * This is equivalent to the opcode instruction OP_MULTIPLY.
+ */
+extern KrkValue krk_operator_mul(KrkValue,KrkValue);
+
+/**
+ * @brief Divide the left value by the right, rounding down.
+ *
+ * This is equivalent to the opcode instruction OP_FLOORDIV.
+ */
+extern KrkValue krk_operator_floordiv(KrkValue,KrkValue);
+
+/**
+ * @brief Compute the remainder of dividing the left value by the right.
+ *
+ * This is equivalent to the opcode instruction OP_MODULO.
+ */
+extern KrkValue krk_operator_mod(KrkValue,KrkValue);
+
+/**
+ * @brief Raise the left value to the power of the right.
+ *
+ * This is equivalent to the opcode instruction OP_POW.
+ */
+extern KrkValue krk_operator_pow(KrkValue,KrkValue);
+
 /**
  * @brief Compare two values, returning @ref True if the left is less than the right.
  *
@@ -887,6 +965,45 @@ extern KrkValue krk_operator_le(KrkValue,KrkValue);
  */
 extern KrkValue krk_operator_ge(KrkValue,KrkValue);
 
+/**
+ * @brief Compare two values for ordering, as a C truth value.
+ *
+ * Pairs of ints, floats or strings are compared inline; anything else goes
+ * through krk_operator_lt, which may run arbitrary code and raise. Callers
+ * should check for an exception after comparing non-primitive values.
+ *
+ * @return 1 if @p a is less than @p b, 0 otherwise.
+ */
+extern int krk_lessThan(KrkValue a, KrkValue b);
+
+/**
+ * @brief Get the length of a sequence.
+ *
+ * Lists and tuples are read directly; other types are asked through @c __len__,
+ * which must return an int. Subclasses of @c list are read directly too, so an
+ * overridden @c __len__ on them is not called.
+ *
+ * @param seq Sequence to measure.
+ * @param out Receives the length.
+ * @return 1 on success, 0 with an exception set on failure.
+ */
+extern int krk_sequenceLength(KrkValue seq, krk_integer_type * out);
+
+/**
+ * @brief Get @p seq[@p i] for a non-negative index.
+ *
+ * Lists are bounds-checked on each call, since they can shrink between
+ * accesses; tuple indexes are not checked. Other types go through @c __getitem__.
+ * As with krk_sequenceLength, subclasses of @c list are read directly and an
+ * overridden @c __getitem__ on them is not called.
+ * The result is not rooted.
+ *
+ * @param seq Sequence to index.
+ * @param i   Index, which must be non-negative.
+ * @return The item, or @c None with an exception set on failure.
+ */
+extern KrkValue krk_sequenceItem(KrkValue seq, krk_integer_type i);
+
 /**
  * @brief Set the maximum recursion call depth.
  *
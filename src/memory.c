@@ -151,12 +151,11 @@ void krk_gcTakeBytes(const void * ptr, size_t size) {
 	vm.bytesAllocated += size;
 }
 
-void * krk_reallocate(void * ptr, size_t old, size_t new) {
-
-	vm.bytesAllocated -= old;
-	vm.bytesAllocated += new;
-
-	if (new > old && ptr != krk_currentThread.stack && &krk_currentThread == vm.threads && !(vm.globalFlags & KRK_GLOBAL_GC_PAUSED)) {
+/**
+ * Run a collection if one is due. Only the main thread collects.
+ */
+static void maybeCollect(void) {
+	if (&krk_currentThread == vm.threads && !(vm.globalFlags & KRK_GLOBAL_GC_PAUSED)) {
 #ifndef KRK_NO_STRESS_GC
 		if (vm.globalFlags & KRK_GLOBAL_ENABLE_STRESS_GC) {
 			krk_collectGarbage();
@@ -166,6 +165,16 @@ void * krk_reallocate(void * ptr, size_t old, size_t new) {
 			krk_collectGarbage();
 		}
 	}
+}
+
+void * krk_reallocate(void * ptr, size_t old, size_t new) {
+
+	vm.bytesAllocated -= old;
+	vm.bytesAllocated += new;
+
+	if (new > old && ptr != krk_currentThread.stack) {
+		maybeCollect();
+	}
 
 	void * out;
 	if (new == 0) {
@@ -204,6 +213,7 @@ static void freeObject(KrkObj * object) {
 			KrkString * string = (KrkString*)object;
 			FREE_ARRAY(char, string->chars, string->length + 1);
 			if (string->codes && string->codes != string->chars) free(string->codes);
+			free(string->index);
 			FREE(KrkString, object);
 			break;
 		}
@@ -407,6 +417,113 @@ static void traceReferences() {
 	}
 }
 
+/**
+ * Free lists
+ *
+ * Tuples, bound methods and small instances (which includes the iterators
+ * of all of the builtin collection types) are very often allocated only to be
+ * thrown away a moment later - think of the pairs produced by @c dict.items
+ * or @c enumerate, or a method looked up but not immediately called. Rather
+ * than returning these to the system allocator when they are swept, we keep
+ * a limited number of them in per-thread free lists and hand them back out
+ * from @c krk_takeCachedObject. Tuples keep their value arrays, so recycling
+ * one saves two allocations.
+ *
+ * Only the main thread collects, so only its lists are ever filled.
+ *
+ * Cached objects are not counted as allocated, so the collector's schedule
+ * is the same as if they had been freed. Since a sweep can release tens of
+ * thousands of objects at once, a fixed depth would only let a sliver of
+ * them be reused; instead each list may grow to match what was taken from
+ * it during the last cycle, and anything beyond that is released.
+ */
+static void releaseCachedObject(KrkObjectCache * cache) {
+	KrkObj * object = cache->head;
+	cache->head = object->next;
+	cache->count--;
+	if (object->type == KRK_OBJ_TUPLE) {
+		free(((KrkTuple*)object)->values.values);
+	}
+	free(object);
+}
+
+static void resizeCache(KrkObjectCache * cache) {
+	cache->limit = cache->taken > KRK_CACHE_DEPTH ? cache->taken : KRK_CACHE_DEPTH;
+	cache->taken = 0;
+	while (cache->count > cache->limit) releaseCachedObject(cache);
+}
+
+static void resizeCaches(void) {
+	for (int i = 0; i < KRK_CACHE_TUPLE_LENGTHS; ++i) resizeCache(&krk_currentThread.tupleCache[i]);
+	resizeCache(&krk_currentThread.boundMethodCache);
+	for (int i = 0; i < KRK_CACHE_INSTANCE_SIZES; ++i) resizeCache(&krk_currentThread.instanceCache[i]);
+}
+
+static int cacheObject(KrkObjectCache * cache, KrkObj * object, size_t size) {
+	if (cache->count >= cache->limit) return 0;
+	object->next = cache->head;
+	cache->head = object;
+	cache->count++;
+	vm.bytesAllocated -= size;
+	return 1;
+}
+
+static int recycleObject(KrkObj * object) {
+#if !defined(KRK_EXTENSIVE_MEMORY_DEBUGGING)
+	switch (object->type) {
+		case KRK_OBJ_TUPLE: {
+			KrkTuple * tuple = (KrkTuple*)object;
+			size_t capacity = tuple->values.capacity;
+			if (capacity >= KRK_CACHE_TUPLE_LENGTHS) return 0;
+			return cacheObject(&krk_currentThread.tupleCache[capacity], object,
+				sizeof(KrkTuple) + sizeof(KrkValue) * capacity);
+		}
+		case KRK_OBJ_BOUND_METHOD:
+			return cacheObject(&krk_currentThread.boundMethodCache, object, sizeof(KrkBoundMethod));
+		case KRK_OBJ_INSTANCE: {
+			KrkInstance * inst = (KrkInstance*)object;
+			size_t size = inst->_class->allocSize;
+			size_t extra = size - sizeof(KrkInstance);
+			if (extra % sizeof(void*) || extra / sizeof(void*) >= KRK_CACHE_INSTANCE_SIZES) return 0;
+			if (inst->_class->_ongcsweep) {
+				inst->_class->_ongcsweep(inst);
+			}
+			krk_freeTable(&inst->fields);
+			if (!cacheObject(&krk_currentThread.instanceCache[extra / sizeof(void*)], object, size)) {
+				krk_reallocate(object, size, 0);
+			}
+			return 1;
+		}
+		default:
+			break;
+	}
+#endif
+	return 0;
+}
+
+KrkObj * krk_takeCachedObject(KrkObjectCache * cache, size_t size) {
+	cache->taken++;
+	if (!cache->head) return NULL;
+	vm.bytesAllocated += size;
+	maybeCollect();
+	KrkObj * object = cache->head;
+	cache->head = object->next;
+	cache->count--;
+	return object;
+}
+
+static void emptyCache(KrkObjectCache * cache) {
+	while (cache->head) releaseCachedObject(cache);
+	cache->limit = 0;
+	cache->taken = 0;
+}
+
+void krk_freeObjectCaches(void) {
+	for (int i = 0; i < KRK_CACHE_TUPLE_LENGTHS; ++i) emptyCache(&krk_currentThread.tupleCache[i]);
+	emptyCache(&krk_currentThread.boundMethodCache);
+	for (int i = 0; i < KRK_CACHE_INSTANCE_SIZES; ++i) emptyCache(&krk_currentThread.instanceCache[i]);
+}
+
 static size_t sweep() {
 	KrkObj * previous = NULL;
 	KrkObj * object = vm.objects;
@@ -424,7 +541,7 @@ static size_t sweep() {
 			} else {
 				vm.objects = object;
 			}
-			freeObject(unreached);
+			if (!recycleObject(unreached)) freeObject(unreached);
 			count++;
 		} else {
 			object->flags |= KRK_OBJ_FLAGS_SECOND_CHANCE;
@@ -436,7 +553,7 @@ static size_t sweep() {
 }
 
 void krk_markTable(KrkTable * table) {
-	for (size_t i = 0; i < table->capacity; ++i) {
+	for (size_t i = 0; i < table->used; ++i) {
 		KrkTableEntry * entry = &table->entries[i];
 		krk_markValue(entry->key);
 		krk_markValue(entry->value);
@@ -444,7 +561,7 @@ void krk_markTable(KrkTable * table) {
 }
 
 static void tableRemoveWhite(KrkTable * table) {
-	for (size_t i = 0; i < table->capacity; ++i) {
+	for (size_t i = 0; i < table->used; ++i) {
 		KrkTableEntry * entry = &table->entries[i];
 		if (IS_OBJECT(entry->key) && !((AS_OBJECT(entry->key))->flags & KRK_OBJ_FLAGS_IS_MARKED)) {
 			krk_tableDeleteExact(table, entry->key);
@@ -519,6 +636,7 @@ size_t krk_collectGarbage(void) {
 	markRoots();
 	traceReferences();
 	tableRemoveWhite(&vm.strings);
+	resizeCaches();
 	size_t out = sweep();
 
 	/**
@@ -0,0 +1,635 @@
+/**
+ * @file    module__collections.c
+ * @brief   Native implementations of container types for @c collections.
+ *
+ * Provides @c deque, a double-ended queue stored as a doubly-linked list
+ * of fixed-size blocks. Pushing or popping at either end never moves
+ * existing elements, and only touches the allocator when a block fills
+ * up or empties out.
+ */
+#include <string.h>
+#include <kuroko/vm.h>
+#include <kuroko/util.h>
+#include <kuroko/memory.h>
+
+#define DEQUE_BLOCK  64
+#define DEQUE_CENTER ((DEQUE_BLOCK - 1) / 2)
+
+struct DequeBlock {
+	struct DequeBlock * prev;
+	struct DequeBlock * next;
+	KrkValue items[DEQUE_BLOCK];
+};
+
+/**
+ * @brief Block-based ring deque.
+ *
+ * Live items run from @c left->items[leftIndex] to @c right->items[rightIndex].
+ * An empty deque keeps a single block with the indices crossed at its center,
+ * so that it can grow equally well in either direction.
+ */
+struct Deque {
+	KrkInstance inst;
+	struct DequeBlock * left;
+	struct DequeBlock * right;
+	ssize_t leftIndex;
+	ssize_t rightIndex;
+	size_t len;
+	ssize_t maxlen;           /**< @brief -1 if unbounded */
+	size_t state;             /**< @brief Bumped on every mutation, checked by iterators */
+	struct DequeBlock * spare;/**< @brief One cached block, to avoid churn at a block boundary */
+};
+
+struct DequeIterator {
+	KrkInstance inst;
+	KrkValue deque;
+	struct DequeBlock * block;
+	ssize_t index;
+	size_t remaining;
+	size_t state;
+};
+
+static KrkClass * deque;
+static KrkClass * dequeiterator;
+
+#define IS_deque(o) (krk_isInstanceOf(o,deque))
+#define AS_deque(o) ((struct Deque*)AS_OBJECT(o))
+#define IS_dequeiterator(o) (krk_isInstanceOf(o,dequeiterator))
+#define AS_dequeiterator(o) ((struct DequeIterator*)AS_OBJECT(o))
+
+static struct DequeBlock * newBlock(struct Deque * self) {
+	struct DequeBlock * block = self->spare;
+	if (block) {
+		self->spare = NULL;
+	} else {
+		block = ALLOCATE(struct DequeBlock, 1);
+	}
+	block->prev = NULL;
+	block->next = NULL;
+	return block;
+}
+
+static void freeBlock(struct Deque * self, struct DequeBlock * block) {
+	if (!self->spare) {
+		self->spare = block;
+	} else {
+		FREE(struct DequeBlock, block);
+	}
+}
+
+static void _deque_gcscan(KrkInstance * _self) {
+	struct Deque * self = (struct Deque*)_self;
+	struct DequeBlock * block = self->left;
+	ssize_t index = self->leftIndex;
+	for (size_t i = 0; i < self->len; ++i) {
+		krk_markValue(block->items[index]);
+		if (++index == DEQUE_BLOCK) {
+			block = block->next;
+			index = 0;
+		}
+	}
+}
+
+static void _deque_gcsweep(KrkInstance * _self) {
+	struct Deque * self = (struct Deque*)_self;
+	struct DequeBlock * block = self->left;
+	while (block) {
+		struct DequeBlock * next = block->next;
+		FREE(struct DequeBlock, block);
+		block = next;
+	}
+	if (self->spare) FREE(struct DequeBlock, self->spare);
+	self->left = self->right = self->spare = NULL;
+	self->len = 0;
+}
+
+/* Instances come out of the allocator zeroed, so the first block is set up lazily. */
+static void dequeReady(struct Deque * self) {
+	if (self->left) return;
+	self->left = self->right = newBlock(self);
+	self->leftIndex = DEQUE_CENTER + 1;
+	self->rightIndex = DEQUE_CENTER;
+}
+
+static KrkValue dequePopRight(struct Deque * self) {
+	KrkValue item = self->right->items[self->rightIndex];
+	self->rightIndex--;
+	self->len--;
+	self->state++;
+	if (self->rightIndex < 0) {
+		if (self->len) {
+			struct DequeBlock * prev = self->right->prev;
+			freeBlock(self, self->right);
+			prev->next = NULL;
+			self->right = prev;
+			self->rightIndex = DEQUE_BLOCK - 1;
+		} else {
+			self->leftIndex = DEQUE_CENTER + 1;
+			self->rightIndex = DEQUE_CENTER;
+		}
+	}
+	return item;
+}
+
+static KrkValue dequePopLeft(struct Deque * self) {
+	KrkValue item = self->left->items[self->leftIndex];
+	self->leftIndex++;
+	self->len--;
+	self->state++;
+	if (self->leftIndex == DEQUE_BLOCK) {
+		if (self->len) {
+			struct DequeBlock * next = self->left->next;
+			freeBlock(self, self->left);
+			next->prev = NULL;
+			self->left = next;
+			self->leftIndex = 0;
+		} else {
+			self->leftIndex = DEQUE_CENTER + 1;
+			self->rightIndex = DEQUE_CENTER;
+		}
+	}
+	return item;
+}
+
+static void dequePushRight(struct Deque * self, KrkValue item) {
+	dequeReady(self);
+	if (self->rightIndex == DEQUE_BLOCK - 1) {
+		struct DequeBlock * block = newBlock(self);
+		block->prev = self->right;
+		self->right->next = block;
+		self->right = block;
+		self->rightIndex = -1;
+	}
+	self->right->items[++self->rightIndex] = item;
+	self->len++;
+	self->state++;
+	if (self->maxlen >= 0 && self->len > (size_t)self->maxlen) dequePopLeft(self);
+}
+
+static void dequePushLeft(struct Deque * self, KrkValue item) {
+	dequeReady(self);
+	if (self->leftIndex == 0) {
+		struct DequeBlock * block = newBlock(self);
+		block->next = self->left;
+		self->left->prev = block;
+		self->left = block;
+		self->leftIndex = DEQUE_BLOCK;
+	}
+	self->left->items[--self->leftIndex] = item;
+	self->len++;
+	self->state++;
+	if (self->maxlen >= 0 && self->len > (size_t)self->maxlen) dequePopRight(self);
+}
+
+/* Find the slot for item @p i (which must be in range), walking from the nearer end. */
+static KrkValue * dequeSlot(struct Deque * self, size_t i) {
+	if (i < self->len / 2) {
+		size_t n = self->leftIndex + i;
+		struct DequeBlock * block = self->left;
+		for (size_t b = n / DEQUE_BLOCK; b; --b) block = block->next;
+		return &block->items[n % DEQUE_BLOCK];
+	} else {
+		size_t n = (DEQUE_BLOCK - 1 - self->rightIndex) + (self->len - 1 - i);
+		struct DequeBlock * block = self->right;
+		for (size_t b = n / DEQUE_BLOCK; b; --b) block = block->prev;
+		return &block->items[DEQUE_BLOCK - 1 - n % DEQUE_BLOCK];
+	}
+}
+
+struct DequeCursor {
+	struct DequeBlock * block;
+	ssize_t index;
+};
+
+static inline KrkValue * cursorNext(struct DequeCursor * c) {
+	KrkValue * out = &c->block->items[c->index];
+	if (++c->index == DEQUE_BLOCK) {
+		c->block = c->block->next;
+		c->index = 0;
+	}
+	return out;
+}
+
+static KrkValue dequeToList(struct Deque * self) {
+	KrkValue list = krk_list_of(0, NULL, 0);
+	krk_push(list);
+	struct DequeCursor c = {self->left, self->leftIndex};
+	for (size_t i = 0; i < self->len; ++i) krk_writeValueArray(AS_LIST(list), *cursorNext(&c));
+	return krk_pop();
+}
+
+/* Move the last @p n items to the front, or the first -n to the back. */
+static void dequeRotate(struct Deque * self, krk_integer_type n) {
+	if (self->len < 2) return;
+	krk_integer_type len = self->len;
+	n %= len;
+	if (n > len / 2) n -= len;
+	else if (n < -len / 2) n += len;
+	size_t state = self->state;
+	for (; n > 0; --n) dequePushLeft(self, dequePopRight(self));
+	for (; n < 0; ++n) dequePushRight(self, dequePopLeft(self));
+	self->state = state + 1;
+}
+
+static int _deque_extend_callback(void * context, const KrkValue * values, size_t count) {
+	for (size_t i = 0; i < count; ++i) dequePushRight(context, values[i]);
+	return 0;
+}
+
+static int _deque_extendleft_callback(void * context, const KrkValue * values, size_t count) {
+	for (size_t i = 0; i < count; ++i) dequePushLeft(context, values[i]);
+	return 0;
+}
+
+#define CURRENT_CTYPE struct Deque *
+#define CURRENT_NAME  self
+
+#define DEQUE_WRAP_INDEX() \
+	if (index < 0) index += self->len; \
+	if (unlikely(index < 0 || index >= (krk_integer_type)self->len)) return krk_runtimeError(vm.exceptions->indexError, "deque index out of range")
+
+KRK_Method(deque,__init__) {
+	KrkValue iterable = NONE_VAL();
+	KrkValue maxlen = NONE_VAL();
+	if (!krk_parseArgs(".|VV", (const char*[]){"iterable","maxlen"}, &iterable, &maxlen)) return NONE_VAL();
+
+	if (IS_NONE(maxlen)) {
+		self->maxlen = -1;
+	} else if (IS_INTEGER(maxlen)) {
+		if (AS_INTEGER(maxlen) < 0) return krk_runtimeError(vm.exceptions->valueError, "maxlen must be non-negative");
+		self->maxlen = AS_INTEGER(maxlen);
+	} else {
+		return krk_runtimeError(vm.exceptions->typeError, "%s must be int, not '%T'", "maxlen", maxlen);
+	}
+
+	while (self->len) dequePopRight(self);
+	dequeReady(self);
+
+	if (!IS_NONE(iterable)) {
+		krk_unpackIterable(iterable, self, _deque_extend_callback);
+	}
+
+	return argv[0];
+}
+
+KRK_Method(deque,maxlen) {
+	return self->maxlen < 0 ? NONE_VAL() : INTEGER_VAL(self->maxlen);
+}
+
+KRK_Method(deque,__len__) {
+	METHOD_TAKES_NONE();
+	return INTEGER_VAL(self->len);
+}
+
+KRK_Method(deque,append) {
+	METHOD_TAKES_EXACTLY(1);
+	dequePushRight(self, argv[1]);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,appendleft) {
+	METHOD_TAKES_EXACTLY(1);
+	dequePushLeft(self, argv[1]);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,pop) {
+	METHOD_TAKES_NONE();
+	if (!self->len) return krk_runtimeError(vm.exceptions->indexError, "pop from an empty deque");
+	return dequePopRight(self);
+}
+
+KRK_Method(deque,popleft) {
+	METHOD_TAKES_NONE();
+	if (!self->len) return krk_runtimeError(vm.exceptions->indexError, "pop from an empty deque");
+	return dequePopLeft(self);
+}
+
+KRK_Method(deque,extend) {
+	METHOD_TAKES_EXACTLY(1);
+	KrkValue other = argv[1];
+	if (krk_valuesSame(argv[0], other)) {
+		other = dequeToList(self);
+		krk_push(other);
+	}
+	krk_unpackIterable(other, self, _deque_extend_callback);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,extendleft) {
+	METHOD_TAKES_EXACTLY(1);
+	KrkValue other = argv[1];
+	if (krk_valuesSame(argv[0], other)) {
+		other = dequeToList(self);
+		krk_push(other);
+	}
+	krk_unpackIterable(other, self, _deque_extendleft_callback);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,clear) {
+	METHOD_TAKES_NONE();
+	while (self->len) dequePopRight(self);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,copy) {
+	METHOD_TAKES_NONE();
+	krk_push(OBJECT_VAL(self->inst._class));
+	krk_push(argv[0]);
+	krk_push(self->maxlen < 0 ? NONE_VAL() : INTEGER_VAL(self->maxlen));
+	return krk_callStack(2);
+}
+
+KRK_Method(deque,rotate) {
+	METHOD_TAKES_AT_MOST(1);
+	krk_integer_type n = 1;
+	if (argc > 1) {
+		CHECK_ARG(1,int,krk_integer_type,_n);
+		n = _n;
+	}
+	dequeRotate(self, n);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,reverse) {
+	METHOD_TAKES_NONE();
+	if (self->len < 2) return NONE_VAL();
+	struct DequeBlock * lb = self->left, * rb = self->right;
+	ssize_t li = self->leftIndex, ri = self->rightIndex;
+	for (size_t n = self->len / 2; n; --n) {
+		KrkValue tmp = lb->items[li];
+		lb->items[li] = rb->items[ri];
+		rb->items[ri] = tmp;
+		if (++li == DEQUE_BLOCK) { lb = lb->next; li = 0; }
+		if (--ri < 0) { rb = rb->prev; ri = DEQUE_BLOCK - 1; }
+	}
+	self->state++;
+	return NONE_VAL();
+}
+
+/* Linear search shared by count, index, remove and __contains__; -1 with an exception set on failure. */
+static ssize_t dequeFind(struct Deque * self, KrkValue value, size_t start, size_t stop, size_t * count) {
+	size_t state = self->state;
+	struct DequeCursor c = {self->left, self->leftIndex};
+	for (size_t i = 0; i < stop; ++i) {
+		KrkValue * item = cursorNext(&c);
+		if (i >= start) {
+			int same = krk_valuesSameOrEqual(*item, value);
+			if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
+			if (unlikely(state != self->state)) {
+				krk_runtimeError(vm.exceptions->valueError, "deque mutated during iteration");
+				return -1;
+			}
+			if (same) {
+				if (!count) return i;
+				(*count)++;
+			}
+		}
+	}
+	return count ? 0 : -1;
+}
+
+KRK_Method(deque,count) {
+	METHOD_TAKES_EXACTLY(1);
+	size_t count = 0;
+	if (dequeFind(self, argv[1], 0, self->len, &count) < 0) return NONE_VAL();
+	return INTEGER_VAL(count);
+}
+
+KRK_Method(deque,__contains__) {
+	METHOD_TAKES_EXACTLY(1);
+	ssize_t i = dequeFind(self, argv[1], 0, self->len, NULL);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	return BOOLEAN_VAL(i >= 0);
+}
+
+KRK_Method(deque,index) {
+	METHOD_TAKES_AT_LEAST(1);
+	METHOD_TAKES_AT_MOST(3);
+	krk_integer_type start = 0;
+	krk_integer_type stop = self->len;
+	if (argc > 2) {
+		CHECK_ARG(2,int,krk_integer_type,_start);
+		start = _start;
+	}
+	if (argc > 3) {
+		CHECK_ARG(3,int,krk_integer_type,_stop);
+		stop = _stop;
+	}
+	krk_integer_type len = self->len;
+	if (start < 0) { start += len; if (start < 0) start = 0; }
+	if (stop < 0) { stop += len; if (stop < 0) stop = 0; }
+	if (stop > len) stop = len;
+	if (start < stop) {
+		ssize_t i = dequeFind(self, argv[1], start, stop, NULL);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+		if (i >= 0) return INTEGER_VAL(i);
+	}
+	return krk_runtimeError(vm.exceptions->valueError, "not found");
+}
+
+KRK_Method(deque,insert) {
+	METHOD_TAKES_EXACTLY(2);
+	CHECK_ARG(1,int,krk_integer_type,index);
+	if (self->maxlen >= 0 && self->len == (size_t)self->maxlen) {
+		return krk_runtimeError(vm.exceptions->indexError, "deque already at its maximum size");
+	}
+	krk_integer_type len = self->len;
+	if (index < 0) { index += len; if (index < 0) index = 0; }
+	if (index >= len) {
+		dequePushRight(self, argv[2]);
+	} else {
+		dequeRotate(self, -index);
+		dequePushLeft(self, argv[2]);
+		dequeRotate(self, index);
+	}
+	return NONE_VAL();
+}
+
+static void dequeDelete(struct Deque * self, size_t index) {
+	dequeRotate(self, -(krk_integer_type)index);
+	dequePopLeft(self);
+	dequeRotate(self, index);
+}
+
+KRK_Method(deque,remove) {
+	METHOD_TAKES_EXACTLY(1);
+	ssize_t i = dequeFind(self, argv[1], 0, self->len, NULL);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	if (i < 0) return krk_runtimeError(vm.exceptions->valueError, "not found");
+	dequeDelete(self, i);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,__getitem__) {
+	METHOD_TAKES_EXACTLY(1);
+	CHECK_ARG(1,int,krk_integer_type,index);
+	DEQUE_WRAP_INDEX();
+	return *dequeSlot(self, index);
+}
+
+KRK_Method(deque,__setitem__) {
+	METHOD_TAKES_EXACTLY(2);
+	CHECK_ARG(1,int,krk_integer_type,index);
+	DEQUE_WRAP_INDEX();
+	*dequeSlot(self, index) = argv[2];
+	return NONE_VAL();
+}
+
+KRK_Method(deque,__delitem__) {
+	METHOD_TAKES_EXACTLY(1);
+	CHECK_ARG(1,int,krk_integer_type,index);
+	DEQUE_WRAP_INDEX();
+	dequeDelete(self, index);
+	return NONE_VAL();
+}
+
+KRK_Method(deque,__eq__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (!IS_deque(argv[1])) return NOTIMPL_VAL();
+	struct Deque * them = AS_deque(argv[1]);
+	if (self->len != them->len) return BOOLEAN_VAL(0);
+	size_t state = self->state, theirState = them->state;
+	struct DequeCursor a = {self->left, self->leftIndex};
+	struct DequeCursor b = {them->left, them->leftIndex};
+	for (size_t i = 0; i < self->len; ++i) {
+		int same = krk_valuesSameOrEqual(*cursorNext(&a), *cursorNext(&b));
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+		if (unlikely(state != self->state || theirState != them->state)) {
+			return krk_runtimeError(vm.exceptions->valueError, "deque mutated during iteration");
+		}
+		if (!same) return BOOLEAN_VAL(0);
+	}
+	return BOOLEAN_VAL(1);
+}
+
+KRK_Method(deque,__repr__) {
+	METHOD_TAKES_NONE();
+	if (((KrkObj*)self)->flags & KRK_OBJ_FLAGS_IN_REPR) return OBJECT_VAL(S("[...]"));
+	((KrkObj*)self)->flags |= KRK_OBJ_FLAGS_IN_REPR;
+	struct StringBuilder sb = {0};
+	pushStringBuilderStr(&sb, self->inst._class->name->chars, self->inst._class->name->length);
+	pushStringBuilderStr(&sb, "([", 2);
+
+	size_t state = self->state;
+	struct DequeCursor c = {self->left, self->leftIndex};
+	for (size_t i = 0; i < self->len; ++i) {
+		KrkValue item = *cursorNext(&c);
+		KrkClass * type = krk_getType(item);
+		krk_push(item);
+		KrkValue result = krk_callDirect(type->_reprer, 1);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) break;
+		if (unlikely(state != self->state)) {
+			krk_runtimeError(vm.exceptions->valueError, "deque mutated during iteration");
+			break;
+		}
+		if (IS_STRING(result)) {
+			pushStringBuilderStr(&sb, AS_STRING(result)->chars, AS_STRING(result)->length);
+		}
+		if (i + 1 < self->len) pushStringBuilderStr(&sb, ", ", 2);
+	}
+
+	((KrkObj*)self)->flags &= ~(KRK_OBJ_FLAGS_IN_REPR);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) {
+		discardStringBuilder(&sb);
+		return NONE_VAL();
+	}
+
+	pushStringBuilder(&sb, ']');
+	if (self->maxlen >= 0) {
+		char tmp[64];
+		size_t len = snprintf(tmp, 64, ", maxlen=%zd", self->maxlen);
+		pushStringBuilderStr(&sb, tmp, len);
+	}
+	pushStringBuilder(&sb, ')');
+	return finishStringBuilder(&sb);
+}
+
+KRK_Method(deque,__iter__) {
+	METHOD_TAKES_NONE();
+	struct DequeIterator * out = (struct DequeIterator*)krk_newInstance(dequeiterator);
+	out->deque = argv[0];
+	out->block = self->left;
+	out->index = self->leftIndex;
+	out->remaining = self->len;
+	out->state = self->state;
+	return OBJECT_VAL(out);
+}
+
+#undef CURRENT_CTYPE
+#define CURRENT_CTYPE struct DequeIterator *
+
+static void _dequeiterator_gcscan(KrkInstance * self) {
+	krk_markValue(((struct DequeIterator*)self)->deque);
+}
+
+KRK_Method(dequeiterator,__call__) {
+	METHOD_TAKES_NONE();
+	if (!self->remaining) return argv[0];
+	struct Deque * them = AS_deque(self->deque);
+	if (unlikely(self->state != them->state)) {
+		self->remaining = 0;
+		return krk_runtimeError(vm.exceptions->valueError, "deque mutated during iteration");
+	}
+	KrkValue item = self->block->items[self->index];
+	self->remaining--;
+	if (++self->index == DEQUE_BLOCK && self->remaining) {
+		self->block = self->block->next;
+		self->index = 0;
+	}
+	return item;
+}
+
+KrkValue krk_module_onload__collections(void) {
+	KrkInstance * module = krk_newInstance(vm.baseClasses->moduleClass);
+	krk_push(OBJECT_VAL(module));
+
+	KRK_DOC(module, "@brief Native container types backing @c collections.");
+
+	krk_makeClass(module, &deque, "deque", vm.baseClasses->objectClass);
+	KRK_DOC(deque, "@brief Double-ended queue with fast appends and pops at both ends.\n"
+		"@arguments iterable=None,maxlen=None\n\n"
+		"Items are stored in linked blocks of 64 slots. If @p maxlen is given, adding "
+		"items to a full deque discards the same number of items from the opposite end.");
+	deque->allocSize = sizeof(struct Deque);
+	deque->_ongcscan = _deque_gcscan;
+	deque->_ongcsweep = _deque_gcsweep;
+	BIND_METHOD(deque,__init__);
+	KRK_DOC(BIND_PROP(deque,maxlen), "@brief Maximum size of the deque, or @c None if unbounded.");
+	BIND_METHOD(deque,__len__);
+	KRK_DOC(BIND_METHOD(deque,append), "@brief Add an item to the right end.\n@arguments x");
+	KRK_DOC(BIND_METHOD(deque,appendleft), "@brief Add an item to the left end.\n@arguments x");
+	KRK_DOC(BIND_METHOD(deque,pop), "@brief Remove and return the item at the right end.");
+	KRK_DOC(BIND_METHOD(deque,popleft), "@brief Remove and return the item at the left end.");
+	KRK_DOC(BIND_METHOD(deque,extend), "@brief Append each item of @p iterable to the right end.\n@arguments iterable");
+	KRK_DOC(BIND_METHOD(deque,extendleft), "@brief Append each item of @p iterable to the left end.\n@arguments iterable\n\n"
+		"The items end up in reverse order.");
+	KRK_DOC(BIND_METHOD(deque,clear), "@brief Remove all items.");
+	KRK_DOC(BIND_METHOD(deque,copy), "@brief Create a shallow copy of the deque.");
+	KRK_DOC(BIND_METHOD(deque,count), "@brief Count the items equal to @p x.\n@arguments x");
+	KRK_DOC(BIND_METHOD(deque,index), "@brief Find the position of the first item equal to @p x.\n@arguments x,start=0,stop=len(self)");
+	KRK_DOC(BIND_METHOD(deque,insert), "@brief Insert @p x before position @p i.\n@arguments i,x");
+	KRK_DOC(BIND_METHOD(deque,remove), "@brief Remove the first item equal to @p value.\n@arguments value");
+	KRK_DOC(BIND_METHOD(deque,rotate), "@brief Rotate the deque @p n steps to the right.\n@arguments n=1\n\n"
+		"If @p n is negative, rotate to the left.");
+	KRK_DOC(BIND_METHOD(deque,reverse), "@brief Reverse the items in place.");
+	BIND_METHOD(deque,__contains__);
+	BIND_METHOD(deque,__getitem__);
+	BIND_METHOD(deque,__setitem__);
+	BIND_METHOD(deque,__delitem__);
+	BIND_METHOD(deque,__eq__);
+	BIND_METHOD(deque,__repr__);
+	BIND_METHOD(deque,__iter__);
+	krk_defineNative(&deque->methods, "__str__", FUNC_NAME(deque,__repr__));
+	krk_finalizeClass(deque);
+
+	krk_makeClass(module, &dequeiterator, "dequeiterator", vm.baseClasses->objectClass);
+	dequeiterator->allocSize = sizeof(struct DequeIterator);
+	dequeiterator->_ongcscan = _dequeiterator_gcscan;
+	dequeiterator->obj.flags |= KRK_OBJ_FLAGS_NO_INHERIT;
+	BIND_METHOD(dequeiterator,__call__);
+	krk_finalizeClass(dequeiterator);
+
+	return krk_pop();
+}
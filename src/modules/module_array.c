@@ -0,0 +1,840 @@
+/**
+ * @file    module_array.c
+ * @brief   Compact arrays of basic numeric types.
+ *
+ * An array stores its items unboxed in one contiguous buffer, using the
+ * C type selected by its type code, so it takes one to eight bytes per
+ * item instead of the eight bytes of a list slot plus any heap object
+ * needed to represent the value.
+ */
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <float.h>
+#include <kuroko/vm.h>
+#include <kuroko/util.h>
+#include <kuroko/memory.h>
+
+/* Type code, C type, and how values are boxed and checked. */
+#define ARRAY_TYPES \
+	X('b', b, signed char,        SIGNED,   SCHAR_MIN, SCHAR_MAX) \
+	X('B', B, unsigned char,      UNSIGNED, 0,         UCHAR_MAX) \
+	X('h', h, short,              SIGNED,   SHRT_MIN,  SHRT_MAX) \
+	X('H', H, unsigned short,     UNSIGNED, 0,         USHRT_MAX) \
+	X('i', i, int,                SIGNED,   INT_MIN,   INT_MAX) \
+	X('I', I, unsigned int,       UNSIGNED, 0,         UINT_MAX) \
+	X('l', l, long,               SIGNED,   LONG_MIN,  LONG_MAX) \
+	X('L', L, unsigned long,      UNSIGNED, 0,         ULONG_MAX) \
+	X('q', q, long long,          SIGNED,   LLONG_MIN, LLONG_MAX) \
+	X('Q', Q, unsigned long long, UNSIGNED, 0,         ULLONG_MAX) \
+	X('f', f, float,              FLOAT,    -FLT_MAX,  FLT_MAX) \
+	X('d', d, double,             FLOAT,    -DBL_MAX,  DBL_MAX)
+
+static KrkClass * array;
+static KrkClass * arrayiterator;
+
+struct Array {
+	KrkInstance inst;
+	char typecode;
+	size_t itemsize;
+	size_t length;
+	size_t capacity;
+	char * data;
+};
+
+struct ArrayIterator {
+	KrkInstance inst;
+	KrkValue array;
+	size_t i;
+};
+
+#define IS_array(o) (krk_isInstanceOf(o,array))
+#define AS_array(o) ((struct Array*)AS_OBJECT(o))
+#define IS_arrayiterator(o) (krk_isInstanceOf(o,arrayiterator))
+#define AS_arrayiterator(o) ((struct ArrayIterator*)AS_OBJECT(o))
+
+static size_t typeSize(char typecode) {
+	switch (typecode) {
+#define X(c,n,t,kind,min,max) case c: return sizeof(t);
+		ARRAY_TYPES
+#undef X
+	}
+	return 0;
+}
+
+static int isFloatType(char typecode) {
+	return typecode == 'f' || typecode == 'd';
+}
+
+static void _array_gcsweep(KrkInstance * _self) {
+	struct Array * self = (struct Array*)_self;
+	krk_reallocate(self->data, self->capacity * self->itemsize, 0);
+	self->data = NULL;
+	self->length = self->capacity = 0;
+}
+
+static void _arrayiterator_gcscan(KrkInstance * self) {
+	krk_markValue(((struct ArrayIterator*)self)->array);
+}
+
+static void arrayReserve(struct Array * self, size_t length) {
+	if (length <= self->capacity) return;
+	size_t capacity = self->capacity < 8 ? 8 : self->capacity + self->capacity / 2;
+	if (capacity < length) capacity = length;
+	self->data = krk_reallocate(self->data, self->capacity * self->itemsize, capacity * self->itemsize);
+	self->capacity = capacity;
+}
+
+static KrkValue arrayGet(struct Array * self, size_t i) {
+	switch (self->typecode) {
+#define BOX_SIGNED(v)   krk_int_from_int64(v)
+#define BOX_UNSIGNED(v) krk_int_from_uint64(v)
+#define BOX_FLOAT(v)    FLOATING_VAL(v)
+#define X(c,n,t,kind,min,max) case c: return BOX_ ## kind(((t*)self->data)[i]);
+		ARRAY_TYPES
+#undef X
+	}
+	return NONE_VAL();
+}
+
+static int convertSigned(char typecode, KrkValue value, int64_t min, int64_t max, int64_t * out) {
+	if (!IS_INTEGER(value) && !krk_isInstanceOf(value, vm.baseClasses->longClass)) {
+		krk_runtimeError(vm.exceptions->typeError, "array item must be int, not '%T'", value);
+		return 0;
+	}
+	if (!krk_int_to_int64(value, out) || *out < min || *out > max) {
+		krk_runtimeError(vm.exceptions->valueError, "value out of range for array of type '%c'", typecode);
+		return 0;
+	}
+	return 1;
+}
+
+static int convertUnsigned(char typecode, KrkValue value, uint64_t max, uint64_t * out) {
+	if (!IS_INTEGER(value) && !krk_isInstanceOf(value, vm.baseClasses->longClass)) {
+		krk_runtimeError(vm.exceptions->typeError, "array item must be int, not '%T'", value);
+		return 0;
+	}
+	if (!krk_int_to_uint64(value, out) || *out > max) {
+		krk_runtimeError(vm.exceptions->valueError, "value out of range for array of type '%c'", typecode);
+		return 0;
+	}
+	return 1;
+}
+
+static int convertFloat(KrkValue value, double * out) {
+	int64_t i;
+	if (IS_FLOATING(value)) {
+		*out = AS_FLOATING(value);
+	} else if (IS_INTEGER(value)) {
+		*out = AS_INTEGER(value);
+	} else if (krk_int_to_int64(value, &i)) {
+		*out = i;
+	} else {
+		krk_runtimeError(vm.exceptions->typeError, "array item must be float, not '%T'", value);
+		return 0;
+	}
+	return 1;
+}
+
+/* A subclass whose __init__ never reached ours has no type code or storage. */
+static int arrayInitialized(struct Array * self) {
+	if (likely(self->itemsize)) return 1;
+	krk_runtimeError(vm.exceptions->valueError, "array is not initialized");
+	return 0;
+}
+
+/* Store @p value at @p i, which must be within capacity. Returns 0 with an exception set on failure. */
+static int arraySet(struct Array * self, size_t i, KrkValue value) {
+	switch (self->typecode) {
+#define STORE_SIGNED(c,t,min,max) { int64_t v; if (!convertSigned(c, value, min, max, &v)) return 0; ((t*)self->data)[i] = v; return 1; }
+#define STORE_UNSIGNED(c,t,min,max) { uint64_t v; if (!convertUnsigned(c, value, max, &v)) return 0; ((t*)self->data)[i] = v; return 1; }
+#define STORE_FLOAT(c,t,min,max) { double v; if (!convertFloat(value, &v)) return 0; ((t*)self->data)[i] = v; return 1; }
+#define X(c,n,t,kind,min,max) case c: STORE_ ## kind(c,t,min,max)
+		ARRAY_TYPES
+#undef X
+	}
+	return arrayInitialized(self);
+}
+
+static int arrayAppend(struct Array * self, KrkValue value) {
+	arrayReserve(self, self->length + 1);
+	if (!arraySet(self, self->length, value)) return 0;
+	self->length++;
+	return 1;
+}
+
+static struct Array * newArray(char typecode, size_t length) {
+	struct Array * out = (struct Array*)krk_newInstance(array);
+	out->typecode = typecode;
+	out->itemsize = typeSize(typecode);
+	krk_push(OBJECT_VAL(out));
+	arrayReserve(out, length);
+	out->length = length;
+	krk_pop();
+	return out;
+}
+
+static int _array_extend_callback(void * context, const KrkValue * values, size_t count) {
+	struct Array * self = context;
+	arrayReserve(self, self->length + count);
+	for (size_t i = 0; i < count; ++i) {
+		if (!arrayAppend(self, values[i])) return 1;
+	}
+	return 0;
+}
+
+static int arrayFromBytes(struct Array * self, KrkValue value) {
+	if (!arrayInitialized(self)) return 0;
+	KrkBuffer buffer;
+	if (!krk_getBuffer(value, &buffer)) return 0;
+	if (buffer.length % self->itemsize) {
+		krk_runtimeError(vm.exceptions->valueError, "bytes length not a multiple of item size");
+		return 0;
+	}
+	size_t count = buffer.length / self->itemsize;
+	arrayReserve(self, self->length + count);
+	/* Growing may have moved our own storage if we are reading from a view of ourselves. */
+	if (!krk_getBuffer(value, &buffer)) return 0;
+	memmove(self->data + self->length * self->itemsize, buffer.data, buffer.length);
+	self->length += count;
+	return 1;
+}
+
+static int _array_getbuffer(KrkValue value, KrkBuffer * out) {
+	struct Array * self = AS_array(value);
+	out->owner = value;
+	out->data = (uint8_t*)self->data;
+	out->length = self->length * self->itemsize;
+	out->itemsize = self->itemsize;
+	out->format = self->typecode;
+	out->readonly = 0;
+	return 1;
+}
+
+static int arrayExtend(struct Array * self, KrkValue iterable) {
+	if (IS_array(iterable)) {
+		struct Array * other = AS_array(iterable);
+		if (other->typecode != self->typecode) {
+			krk_runtimeError(vm.exceptions->typeError, "can only extend with array of same kind");
+			return 0;
+		}
+		size_t count = other->length;
+		arrayReserve(self, self->length + count);
+		memmove(self->data + self->length * self->itemsize, other->data, count * self->itemsize);
+		self->length += count;
+		return 1;
+	}
+	return !krk_unpackIterable(iterable, self, _array_extend_callback);
+}
+
+#define CURRENT_CTYPE struct Array *
+#define CURRENT_NAME  self
+
+#define ARRAY_WRAP_INDEX() \
+	if (index < 0) index += self->length; \
+	if (unlikely(index < 0 || index >= (krk_integer_type)self->length)) return krk_runtimeError(vm.exceptions->indexError, "array index out of range")
+
+KRK_Method(array,__init__) {
+	const char * typecode;
+	KrkValue initializer = NONE_VAL();
+	if (!krk_parseArgs(".s|V", (const char*[]){"typecode","initializer"}, &typecode, &initializer)) return NONE_VAL();
+	if (strlen(typecode) != 1 || !typeSize(typecode[0])) {
+		return krk_runtimeError(vm.exceptions->valueError, "bad typecode (must be b, B, h, H, i, I, l, L, q, Q, f or d)");
+	}
+	if (self->data) _array_gcsweep((KrkInstance*)self);
+	self->typecode = typecode[0];
+	self->itemsize = typeSize(typecode[0]);
+	if (IS_BYTES(initializer) || krk_isInstanceOf(initializer, vm.baseClasses->bytearrayClass)) {
+		if (!arrayFromBytes(self, initializer)) return NONE_VAL();
+	} else if (!IS_NONE(initializer)) {
+		if (!arrayExtend(self, initializer)) return NONE_VAL();
+	}
+	return argv[0];
+}
+
+KRK_Method(array,typecode) {
+	char c = self->typecode;
+	return OBJECT_VAL(krk_copyString(&c, 1));
+}
+
+KRK_Method(array,itemsize) {
+	return INTEGER_VAL(self->itemsize);
+}
+
+KRK_Method(array,__len__) {
+	METHOD_TAKES_NONE();
+	return INTEGER_VAL(self->length);
+}
+
+KRK_Method(array,append) {
+	METHOD_TAKES_EXACTLY(1);
+	arrayAppend(self, argv[1]);
+	return NONE_VAL();
+}
+
+KRK_Method(array,extend) {
+	METHOD_TAKES_EXACTLY(1);
+	arrayExtend(self, argv[1]);
+	return NONE_VAL();
+}
+
+KRK_Method(array,fromlist) {
+	METHOD_TAKES_EXACTLY(1);
+	if (!IS_list(argv[1])) return TYPE_ERROR(list,argv[1]);
+	size_t length = self->length;
+	if (!arrayExtend(self, argv[1])) self->length = length;
+	return NONE_VAL();
+}
+
+KRK_Method(array,frombytes) {
+	METHOD_TAKES_EXACTLY(1);
+	arrayFromBytes(self, argv[1]);
+	return NONE_VAL();
+}
+
+KRK_Method(array,tobytes) {
+	METHOD_TAKES_NONE();
+	return OBJECT_VAL(krk_newBytes(self->length * self->itemsize, (uint8_t*)self->data));
+}
+
+KRK_Method(array,tolist) {
+	METHOD_TAKES_NONE();
+	KrkValue list = krk_list_of(0, NULL, 0);
+	krk_push(list);
+	for (size_t i = 0; i < self->length; ++i) {
+		krk_writeValueArray(AS_LIST(list), arrayGet(self, i));
+	}
+	return krk_pop();
+}
+
+KRK_Method(array,insert) {
+	METHOD_TAKES_EXACTLY(2);
+	CHECK_ARG(1,int,krk_integer_type,index);
+	if (!arrayInitialized(self)) return NONE_VAL();
+	if (index < 0) index += self->length;
+	if (index < 0) index = 0;
+	if (index > (krk_integer_type)self->length) index = self->length;
+	arrayReserve(self, self->length + 1);
+	memmove(self->data + (index + 1) * self->itemsize, self->data + index * self->itemsize, (self->length - index) * self->itemsize);
+	if (!arraySet(self, index, argv[2])) {
+		memmove(self->data + index * self->itemsize, self->data + (index + 1) * self->itemsize, (self->length - index) * self->itemsize);
+		return NONE_VAL();
+	}
+	self->length++;
+	return NONE_VAL();
+}
+
+static void arrayDelete(struct Array * self, size_t index, size_t count) {
+	memmove(self->data + index * self->itemsize, self->data + (index + count) * self->itemsize, (self->length - index - count) * self->itemsize);
+	self->length -= count;
+}
+
+KRK_Method(array,pop) {
+	METHOD_TAKES_AT_MOST(1);
+	krk_integer_type index = -1;
+	if (argc > 1) {
+		CHECK_ARG(1,int,krk_integer_type,_index);
+		index = _index;
+	}
+	if (!self->length) return krk_runtimeError(vm.exceptions->indexError, "pop from empty array");
+	ARRAY_WRAP_INDEX();
+	KrkValue out = arrayGet(self, index);
+	arrayDelete(self, index, 1);
+	return out;
+}
+
+static krk_integer_type arrayFind(struct Array * self, KrkValue value, size_t start) {
+	for (size_t i = start; i < self->length; ++i) {
+		if (krk_valuesSameOrEqual(arrayGet(self, i), value)) return i;
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
+	}
+	return -1;
+}
+
+KRK_Method(array,remove) {
+	METHOD_TAKES_EXACTLY(1);
+	krk_integer_type i = arrayFind(self, argv[1], 0);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	if (i < 0) return krk_runtimeError(vm.exceptions->valueError, "not found");
+	arrayDelete(self, i, 1);
+	return NONE_VAL();
+}
+
+KRK_Method(array,index) {
+	METHOD_TAKES_EXACTLY(1);
+	krk_integer_type i = arrayFind(self, argv[1], 0);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	if (i < 0) return krk_runtimeError(vm.exceptions->valueError, "not found");
+	return INTEGER_VAL(i);
+}
+
+KRK_Method(array,count) {
+	METHOD_TAKES_EXACTLY(1);
+	krk_integer_type count = 0;
+	for (krk_integer_type i = arrayFind(self, argv[1], 0); i >= 0; i = arrayFind(self, argv[1], i + 1)) count++;
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	return INTEGER_VAL(count);
+}
+
+KRK_Method(array,__contains__) {
+	METHOD_TAKES_EXACTLY(1);
+	krk_integer_type i = arrayFind(self, argv[1], 0);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	return BOOLEAN_VAL(i >= 0);
+}
+
+KRK_Method(array,reverse) {
+	METHOD_TAKES_NONE();
+	char tmp[sizeof(double)];
+	for (size_t i = 0; i < self->length / 2; ++i) {
+		char * a = self->data + i * self->itemsize;
+		char * b = self->data + (self->length - i - 1) * self->itemsize;
+		memcpy(tmp, a, self->itemsize);
+		memcpy(a, b, self->itemsize);
+		memcpy(b, tmp, self->itemsize);
+	}
+	return NONE_VAL();
+}
+
+KRK_Method(array,byteswap) {
+	METHOD_TAKES_NONE();
+	for (size_t i = 0; i < self->length; ++i) {
+		char * item = self->data + i * self->itemsize;
+		for (size_t j = 0; j < self->itemsize / 2; ++j) {
+			char tmp = item[j];
+			item[j] = item[self->itemsize - j - 1];
+			item[self->itemsize - j - 1] = tmp;
+		}
+	}
+	return NONE_VAL();
+}
+
+KRK_Method(array,buffer_info) {
+	METHOD_TAKES_NONE();
+	KrkTuple * out = krk_newTuple(2);
+	out->values.values[out->values.count++] = krk_int_from_uint64((uintptr_t)self->data);
+	out->values.values[out->values.count++] = INTEGER_VAL(self->length);
+	return OBJECT_VAL(out);
+}
+
+KRK_Method(array,__getitem__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (IS_INTEGER(argv[1])) {
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		ARRAY_WRAP_INDEX();
+		return arrayGet(self, index);
+	} else if (IS_slice(argv[1])) {
+		KRK_SLICER(argv[1],self->length) {
+			return NONE_VAL();
+		}
+		if (step == 1) {
+			size_t len = end > start ? end - start : 0;
+			struct Array * out = newArray(self->typecode, len);
+			memcpy(out->data, self->data + start * self->itemsize, len * self->itemsize);
+			return OBJECT_VAL(out);
+		}
+		struct Array * out = newArray(self->typecode, 0);
+		krk_push(OBJECT_VAL(out));
+		for (krk_integer_type i = start; (step < 0) ? (i > end) : (i < end); i += step) {
+			arrayReserve(out, out->length + 1);
+			memcpy(out->data + out->length++ * self->itemsize, self->data + i * self->itemsize, self->itemsize);
+		}
+		return krk_pop();
+	}
+	return TYPE_ERROR(int or slice,argv[1]);
+}
+
+KRK_Method(array,__setitem__) {
+	METHOD_TAKES_EXACTLY(2);
+	if (IS_INTEGER(argv[1])) {
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		ARRAY_WRAP_INDEX();
+		arraySet(self, index, argv[2]);
+		return argv[2];
+	} else if (IS_slice(argv[1])) {
+		if (!IS_array(argv[2]) || AS_array(argv[2])->typecode != self->typecode) {
+			return krk_runtimeError(vm.exceptions->typeError, "can only assign array of same kind to array slice");
+		}
+		struct Array * other = AS_array(argv[2]);
+		KRK_SLICER(argv[1],self->length) {
+			return NONE_VAL();
+		}
+		if (step == 1) {
+			size_t len = end > start ? end - start : 0;
+			size_t newLen = other->length;
+			/* Copy out first in case we are assigning from ourselves. */
+			char * tmp = malloc(newLen * self->itemsize + 1);
+			if (!tmp) return krk_runtimeError(vm.exceptions->baseException, "out of memory");
+			memcpy(tmp, other->data, newLen * self->itemsize);
+			if (newLen > len) arrayReserve(self, self->length + newLen - len);
+			memmove(self->data + (start + newLen) * self->itemsize, self->data + (start + len) * self->itemsize,
+				(self->length - start - len) * self->itemsize);
+			memcpy(self->data + start * self->itemsize, tmp, newLen * self->itemsize);
+			self->length = self->length - len + newLen;
+			free(tmp);
+			return argv[2];
+		}
+		size_t count = 0;
+		for (krk_integer_type i = start; (step < 0) ? (i > end) : (i < end); i += step) count++;
+		if (count != other->length) {
+			return krk_runtimeError(vm.exceptions->valueError, "attempt to assign array of size %zu to extended slice of size %zu",
+				other->length, count);
+		}
+		char * tmp = malloc(count * self->itemsize + 1);
+		if (!tmp) return krk_runtimeError(vm.exceptions->baseException, "out of memory");
+		memcpy(tmp, other->data, count * self->itemsize);
+		count = 0;
+		for (krk_integer_type i = start; (step < 0) ? (i > end) : (i < end); i += step) {
+			memcpy(self->data + i * self->itemsize, tmp + count++ * self->itemsize, self->itemsize);
+		}
+		free(tmp);
+		return argv[2];
+	}
+	return TYPE_ERROR(int or slice,argv[1]);
+}
+
+KRK_Method(array,__delitem__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (IS_INTEGER(argv[1])) {
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		ARRAY_WRAP_INDEX();
+		arrayDelete(self, index, 1);
+	} else if (IS_slice(argv[1])) {
+		KRK_SLICER(argv[1],self->length) {
+			return NONE_VAL();
+		}
+		if (step != 1) {
+			return krk_runtimeError(vm.exceptions->valueError, "step value unsupported");
+		}
+		if (end > start) arrayDelete(self, start, end - start);
+	} else {
+		return TYPE_ERROR(int or slice,argv[1]);
+	}
+	return NONE_VAL();
+}
+
+KRK_Method(array,__eq__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (!IS_array(argv[1])) return NOTIMPL_VAL();
+	struct Array * other = AS_array(argv[1]);
+	if (other->length != self->length) return BOOLEAN_VAL(0);
+	if (other->typecode == self->typecode && !isFloatType(self->typecode)) {
+		return BOOLEAN_VAL(!memcmp(self->data, other->data, self->length * self->itemsize));
+	}
+	for (size_t i = 0; i < self->length; ++i) {
+		if (!krk_valuesEqual(arrayGet(self, i), arrayGet(other, i))) return BOOLEAN_VAL(0);
+	}
+	return BOOLEAN_VAL(1);
+}
+
+KRK_Method(array,__add__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (!IS_array(argv[1])) return NOTIMPL_VAL();
+	struct Array * other = AS_array(argv[1]);
+	if (other->typecode != self->typecode) {
+		return krk_runtimeError(vm.exceptions->typeError, "bad argument type for built-in operation");
+	}
+	struct Array * out = newArray(self->typecode, self->length + other->length);
+	memcpy(out->data, self->data, self->length * self->itemsize);
+	memcpy(out->data + self->length * self->itemsize, other->data, other->length * self->itemsize);
+	return OBJECT_VAL(out);
+}
+
+KRK_Method(array,__mul__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (!IS_INTEGER(argv[1])) return NOTIMPL_VAL();
+	krk_integer_type times = AS_INTEGER(argv[1]);
+	if (times < 0) times = 0;
+	struct Array * out = newArray(self->typecode, self->length * times);
+	for (krk_integer_type i = 0; i < times; ++i) {
+		memcpy(out->data + i * self->length * self->itemsize, self->data, self->length * self->itemsize);
+	}
+	return OBJECT_VAL(out);
+}
+
+KRK_Method(array,__repr__) {
+	METHOD_TAKES_NONE();
+	struct StringBuilder sb = {0};
+	pushStringBuilderStr(&sb, "array('", 7);
+	pushStringBuilder(&sb, self->typecode);
+	pushStringBuilder(&sb, '\'');
+	if (self->length) {
+		pushStringBuilderStr(&sb, ", ", 2);
+		KrkValue list = FUNC_NAME(array,tolist)(1, argv, 0);
+		krk_push(list);
+		KrkValue repr = krk_callDirect(krk_getType(list)->_reprer, 1);
+		if (IS_STRING(repr)) pushStringBuilderStr(&sb, AS_CSTRING(repr), AS_STRING(repr)->length);
+	}
+	pushStringBuilder(&sb, ')');
+	return finishStringBuilder(&sb);
+}
+
+KRK_Method(array,__iter__) {
+	METHOD_TAKES_NONE();
+	struct ArrayIterator * out = (struct ArrayIterator*)krk_newInstance(arrayiterator);
+	out->array = argv[0];
+	out->i = 0;
+	return OBJECT_VAL(out);
+}
+
+/*
+ * Reduction and scaling kernels. Each works on a plain C array with several
+ * independent accumulators, so the compiler can keep them in vector registers.
+ * Integer sums are done in 64-bit chunks small enough that they can not overflow.
+ */
+#define LANES 8
+#define SUM_CHUNK (1 << 24)
+
+#define DEFINE_KERNELS(code,t,kind,min,max) \
+	static KrkValue sum_ ## code (const t * restrict p, size_t n) { \
+		KrkValue total = INTEGER_VAL(0); \
+		SUM_ ## kind(t) \
+	} \
+	static t min_ ## code (const t * restrict p, size_t n) { \
+		t m[LANES]; \
+		for (size_t k = 0; k < LANES; ++k) m[k] = p[0]; \
+		size_t i = 0; \
+		for (; i + LANES <= n; i += LANES) \
+			for (size_t k = 0; k < LANES; ++k) m[k] = p[i+k] < m[k] ? p[i+k] : m[k]; \
+		for (; i < n; ++i) m[0] = p[i] < m[0] ? p[i] : m[0]; \
+		for (size_t k = 1; k < LANES; ++k) m[0] = m[k] < m[0] ? m[k] : m[0]; \
+		return m[0]; \
+	} \
+	static t max_ ## code (const t * restrict p, size_t n) { \
+		t m[LANES]; \
+		for (size_t k = 0; k < LANES; ++k) m[k] = p[0]; \
+		size_t i = 0; \
+		for (; i + LANES <= n; i += LANES) \
+			for (size_t k = 0; k < LANES; ++k) m[k] = p[i+k] > m[k] ? p[i+k] : m[k]; \
+		for (; i < n; ++i) m[0] = p[i] > m[0] ? p[i] : m[0]; \
+		for (size_t k = 1; k < LANES; ++k) m[0] = m[k] > m[0] ? m[k] : m[0]; \
+		return m[0]; \
+	} \
+	static void scale_ ## code (t * restrict p, size_t n, t f) { \
+		for (size_t i = 0; i < n; ++i) p[i] = p[i] * f; \
+	}
+
+#define SUM_SIGNED(t) \
+	for (size_t base = 0; base < n; base += SUM_CHUNK) { \
+		size_t end = n - base < SUM_CHUNK ? n : base + SUM_CHUNK; \
+		int64_t s[LANES] = {0}; \
+		size_t i = base; \
+		for (; i + LANES <= end; i += LANES) \
+			for (size_t k = 0; k < LANES; ++k) s[k] += p[i+k]; \
+		for (; i < end; ++i) s[0] += p[i]; \
+		for (size_t k = 1; k < LANES; ++k) s[0] += s[k]; \
+		total = krk_operator_add(total, krk_int_from_int64(s[0])); \
+	} \
+	return total;
+
+#define SUM_UNSIGNED(t) \
+	for (size_t base = 0; base < n; base += SUM_CHUNK) { \
+		size_t end = n - base < SUM_CHUNK ? n : base + SUM_CHUNK; \
+		uint64_t s[LANES] = {0}; \
+		size_t i = base; \
+		for (; i + LANES <= end; i += LANES) \
+			for (size_t k = 0; k < LANES; ++k) s[k] += p[i+k]; \
+		for (; i < end; ++i) s[0] += p[i]; \
+		for (size_t k = 1; k < LANES; ++k) s[0] += s[k]; \
+		total = krk_operator_add(total, krk_int_from_uint64(s[0])); \
+	} \
+	return total;
+
+#define SUM_FLOAT(t) \
+	(void)total; \
+	double s[LANES] = {0}; \
+	size_t i = 0; \
+	for (; i + LANES <= n; i += LANES) \
+		for (size_t k = 0; k < LANES; ++k) s[k] += p[i+k]; \
+	for (; i < n; ++i) s[0] += p[i]; \
+	for (size_t k = 1; k < LANES; ++k) s[0] += s[k]; \
+	return FLOATING_VAL(s[0]);
+
+/* 64-bit items can overflow a 64-bit accumulator, so their sums are checked and fall back to long arithmetic. */
+#define SUM_WIDE_SIGNED(t) \
+	int64_t s = 0; \
+	for (size_t i = 0; i < n; ++i) { \
+		int64_t next; \
+		if (__builtin_add_overflow(s, (int64_t)p[i], &next)) { \
+			total = krk_operator_add(total, krk_int_from_int64(s)); \
+			next = p[i]; \
+		} \
+		s = next; \
+	} \
+	return krk_operator_add(total, krk_int_from_int64(s));
+
+#define SUM_WIDE_UNSIGNED(t) \
+	uint64_t s = 0; \
+	for (size_t i = 0; i < n; ++i) { \
+		uint64_t next; \
+		if (__builtin_add_overflow(s, (uint64_t)p[i], &next)) { \
+			total = krk_operator_add(total, krk_int_from_uint64(s)); \
+			next = p[i]; \
+		} \
+		s = next; \
+	} \
+	return krk_operator_add(total, krk_int_from_uint64(s));
+
+DEFINE_KERNELS(b, signed char,        SIGNED,   SCHAR_MIN, SCHAR_MAX)
+DEFINE_KERNELS(B, unsigned char,      UNSIGNED, 0,         UCHAR_MAX)
+DEFINE_KERNELS(h, short,              SIGNED,   SHRT_MIN,  SHRT_MAX)
+DEFINE_KERNELS(H, unsigned short,     UNSIGNED, 0,         USHRT_MAX)
+DEFINE_KERNELS(i, int,                SIGNED,   INT_MIN,   INT_MAX)
+DEFINE_KERNELS(I, unsigned int,       UNSIGNED, 0,         UINT_MAX)
+DEFINE_KERNELS(l, long,               WIDE_SIGNED,   LONG_MIN,  LONG_MAX)
+DEFINE_KERNELS(L, unsigned long,      WIDE_UNSIGNED, 0,         ULONG_MAX)
+DEFINE_KERNELS(q, long long,          WIDE_SIGNED,   LLONG_MIN, LLONG_MAX)
+DEFINE_KERNELS(Q, unsigned long long, WIDE_UNSIGNED, 0,         ULLONG_MAX)
+DEFINE_KERNELS(f, float,              FLOAT,    -FLT_MAX,  FLT_MAX)
+DEFINE_KERNELS(d, double,             FLOAT,    -DBL_MAX,  DBL_MAX)
+
+KRK_Method(array,sum) {
+	METHOD_TAKES_NONE();
+	switch (self->typecode) {
+#define X(c,n,t,kind,min,max) case c: return sum_ ## n ((const t*)self->data, self->length);
+		ARRAY_TYPES
+#undef X
+	}
+	return NONE_VAL();
+}
+
+KRK_Method(array,min) {
+	METHOD_TAKES_NONE();
+	if (!self->length) return krk_runtimeError(vm.exceptions->valueError, "min() of empty array");
+	switch (self->typecode) {
+#define X(c,n,t,kind,min,max) case c: return BOX_ ## kind(min_ ## n ((const t*)self->data, self->length));
+		ARRAY_TYPES
+#undef X
+	}
+	return NONE_VAL();
+}
+
+KRK_Method(array,max) {
+	METHOD_TAKES_NONE();
+	if (!self->length) return krk_runtimeError(vm.exceptions->valueError, "max() of empty array");
+	switch (self->typecode) {
+#define X(c,n,t,kind,min,max) case c: return BOX_ ## kind(max_ ## n ((const t*)self->data, self->length));
+		ARRAY_TYPES
+#undef X
+	}
+	return NONE_VAL();
+}
+
+/*
+ * Integer arrays are only scaled if every product fits; the extremes are
+ * checked first so the multiply loop itself needs no overflow tests.
+ */
+KRK_Method(array,scale) {
+	METHOD_TAKES_EXACTLY(1);
+	if (!self->length) return NONE_VAL();
+	switch (self->typecode) {
+#define SCALE_SIGNED(c,code,t) SCALE_INT(c,code,t)
+#define SCALE_UNSIGNED(c,code,t) SCALE_INT(c,code,t)
+#define SCALE_INT(c,code,t) { \
+		int64_t f; \
+		if (!IS_INTEGER(argv[1]) && !krk_isInstanceOf(argv[1], vm.baseClasses->longClass)) return TYPE_ERROR(int,argv[1]); \
+		if (!krk_int_to_int64(argv[1], &f)) return krk_runtimeError(vm.exceptions->valueError, "scale factor out of range"); \
+		t lo = min_ ## code ((const t*)self->data, self->length), hi = max_ ## code ((const t*)self->data, self->length), r; \
+		if (__builtin_mul_overflow(lo, f, &r) || __builtin_mul_overflow(hi, f, &r)) \
+			return krk_runtimeError(vm.exceptions->valueError, "value out of range for array of type '%c'", c); \
+		scale_ ## code ((t*)self->data, self->length, (t)f); \
+		return NONE_VAL(); }
+#define SCALE_FLOAT(c,code,t) { \
+		double f; \
+		if (!convertFloat(argv[1], &f)) return NONE_VAL(); \
+		scale_ ## code ((t*)self->data, self->length, (t)f); \
+		return NONE_VAL(); }
+#define X(c,n,t,kind,min,max) case c: SCALE_ ## kind(c,n,t)
+		ARRAY_TYPES
+#undef X
+	}
+	return NONE_VAL();
+}
+
+#undef CURRENT_CTYPE
+#define CURRENT_CTYPE struct ArrayIterator *
+
+KRK_Method(arrayiterator,__init__) {
+	METHOD_TAKES_EXACTLY(1);
+	CHECK_ARG(1,array,struct Array*,them);
+	self->array = argv[1];
+	self->i = 0;
+	return argv[0];
+}
+
+KRK_Method(arrayiterator,__call__) {
+	METHOD_TAKES_NONE();
+	if (unlikely(!IS_array(self->array))) return krk_runtimeError(vm.exceptions->typeError, "arrayiterator is not initialized");
+	struct Array * them = AS_array(self->array);
+	if (self->i >= them->length) return argv[0];
+	return arrayGet(them, self->i++);
+}
+
+KrkValue krk_module_onload_array(void) {
+	KrkInstance * module = krk_newInstance(vm.baseClasses->moduleClass);
+	krk_push(OBJECT_VAL(module));
+
+	KRK_DOC(module, "@brief Compact arrays of basic numeric types.");
+	krk_attachNamedObject(&module->fields, "typecodes", (KrkObj*)S("bBhHiIlLqQfd"));
+
+	krk_makeClass(module, &array, "array", vm.baseClasses->objectClass);
+	KRK_DOC(array, "@brief Sequence of numbers of one C type, stored contiguously.\n"
+		"@arguments typecode,initializer=None\n\n"
+		"@p typecode is one of @c b, @c B, @c h, @c H, @c i, @c I, @c l, @c L, @c q, @c Q "
+		"(signed and unsigned integers of increasing width) or @c f, @c d (single and double "
+		"precision floats). @p initializer may be @ref bytes of raw item data, or any iterable of numbers.\n\n"
+		"Arrays export their storage as a buffer, so a @ref memoryview of one refers to the items in place.");
+	array->allocSize = sizeof(struct Array);
+	array->_ongcsweep = _array_gcsweep;
+	array->_ongetbuffer = _array_getbuffer;
+	BIND_METHOD(array,__init__);
+	KRK_DOC(BIND_PROP(array,typecode), "@brief The type code used to create the array.");
+	KRK_DOC(BIND_PROP(array,itemsize), "@brief Size in bytes of one item.");
+	KRK_DOC(BIND_METHOD(array,append), "@brief Add @p x to the end of the array.\n@arguments x");
+	KRK_DOC(BIND_METHOD(array,extend), "@brief Append the items of @p iterable.\n@arguments iterable\n\n"
+		"If @p iterable is an array, it must have the same type code.");
+	KRK_DOC(BIND_METHOD(array,fromlist), "@brief Append the items of @p list.\n@arguments list\n\n"
+		"If any item can not be stored, the array is left unchanged.");
+	KRK_DOC(BIND_METHOD(array,frombytes), "@brief Append items from raw machine-order data.\n@arguments data\n\n"
+		"@p data may be any object that exports a buffer.");
+	KRK_DOC(BIND_METHOD(array,tobytes), "@brief Return the raw machine-order item data as @ref bytes.");
+	KRK_DOC(BIND_METHOD(array,tolist), "@brief Convert the array to a list of numbers.");
+	KRK_DOC(BIND_METHOD(array,insert), "@brief Insert @p x before position @p i.\n@arguments i,x");
+	KRK_DOC(BIND_METHOD(array,pop), "@brief Remove and return the item at @p i.\n@arguments i=-1");
+	KRK_DOC(BIND_METHOD(array,remove), "@brief Remove the first item equal to @p x.\n@arguments x");
+	KRK_DOC(BIND_METHOD(array,index), "@brief Find the position of the first item equal to @p x.\n@arguments x");
+	KRK_DOC(BIND_METHOD(array,count), "@brief Count the items equal to @p x.\n@arguments x");
+	KRK_DOC(BIND_METHOD(array,reverse), "@brief Reverse the items in place.");
+	KRK_DOC(BIND_METHOD(array,byteswap), "@brief Swap the byte order of every item in place.");
+	KRK_DOC(BIND_METHOD(array,buffer_info), "@brief Return a tuple of the address of the item data and the number of items.");
+	KRK_DOC(BIND_METHOD(array,sum), "@brief Sum all items.\n\n"
+		"Integer sums are exact. Float sums use several partial sums, so rounding may differ "
+		"slightly from adding the items one by one.");
+	KRK_DOC(BIND_METHOD(array,min), "@brief Return the smallest item.");
+	KRK_DOC(BIND_METHOD(array,max), "@brief Return the largest item.");
+	KRK_DOC(BIND_METHOD(array,scale), "@brief Multiply every item by @p factor, in place.\n@arguments factor\n\n"
+		"For integer arrays, @p factor must be an int, and the array is left unchanged "
+		"if any product would not fit in the item type.");
+	BIND_METHOD(array,__len__);
+	BIND_METHOD(array,__contains__);
+	BIND_METHOD(array,__getitem__);
+	BIND_METHOD(array,__setitem__);
+	BIND_METHOD(array,__delitem__);
+	BIND_METHOD(array,__eq__);
+	BIND_METHOD(array,__add__);
+	BIND_METHOD(array,__mul__);
+	BIND_METHOD(array,__repr__);
+	BIND_METHOD(array,__iter__);
+	krk_defineNative(&array->methods, "__str__", FUNC_NAME(array,__repr__));
+	krk_finalizeClass(array);
+
+	krk_makeClass(module, &arrayiterator, "arrayiterator", vm.baseClasses->objectClass);
+	arrayiterator->allocSize = sizeof(struct ArrayIterator);
+	arrayiterator->_ongcscan = _arrayiterator_gcscan;
+	arrayiterator->obj.flags |= KRK_OBJ_FLAGS_NO_INHERIT;
+	BIND_METHOD(arrayiterator,__init__);
+	BIND_METHOD(arrayiterator,__call__);
+	krk_finalizeClass(arrayiterator);
+
+	return krk_pop();
+}
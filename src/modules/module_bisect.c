@@ -0,0 +1,163 @@
+/**
+ * @file    module_bisect.c
+ * @brief   Binary search and insertion on sorted sequences.
+ *
+ * Lists and tuples are indexed directly; other sequences go through
+ * @c __getitem__. Comparisons between two ints, two floats or two strings
+ * are done inline; anything else goes through @c __lt__.
+ */
+#include <string.h>
+#include <kuroko/vm.h>
+#include <kuroko/util.h>
+
+/**
+ * @brief Shared search loop.
+ *
+ * Finds the first position in [lo,hi) whose item is greater than @p x, or with
+ * @p left set, not less than @p x. Returns -1 with an exception set on failure.
+ */
+static krk_integer_type bisect(KrkValue seq, KrkValue x, krk_integer_type lo, krk_integer_type hi, KrkValue key, int left) {
+	while (lo < hi) {
+		krk_integer_type mid = lo + (hi - lo) / 2;
+		KrkValue item = krk_sequenceItem(seq, mid);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
+		if (!IS_NONE(key)) {
+			krk_push(key);
+			krk_push(item);
+			item = krk_callStack(1);
+			if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
+		}
+		int lt = left ? krk_lessThan(item, x) : !krk_lessThan(x, item);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
+		if (lt) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+struct BisectArgs {
+	KrkValue seq;
+	KrkValue x;
+	KrkValue key;
+	krk_integer_type lo;
+	krk_integer_type hi;
+};
+
+/* Parse (a, x, lo=0, hi=len(a), *, key=None) shared by all of the functions here. */
+static int bisectArgs(const char * _method_name, int argc, const KrkValue argv[], int hasKw, struct BisectArgs * args) {
+	KrkValue lo = INTEGER_VAL(0);
+	KrkValue hi = NONE_VAL();
+	args->key = NONE_VAL();
+	if (!krk_parseArgs("VV|VV$V", (const char*[]){"a","x","lo","hi","key"},
+		&args->seq, &args->x, &lo, &hi, &args->key)) return 1;
+
+	if (!IS_INTEGER(lo)) {
+		krk_runtimeError(vm.exceptions->typeError, "%s must be int, not '%T'", "lo", lo);
+		return 1;
+	}
+	args->lo = AS_INTEGER(lo);
+	if (args->lo < 0) {
+		krk_runtimeError(vm.exceptions->valueError, "lo must be non-negative");
+		return 1;
+	}
+
+	if (IS_INTEGER(hi)) {
+		args->hi = AS_INTEGER(hi);
+	} else if (!IS_NONE(hi)) {
+		krk_runtimeError(vm.exceptions->typeError, "%s must be int, not '%T'", "hi", hi);
+		return 1;
+	} else if (!krk_sequenceLength(args->seq, &args->hi)) {
+		return 1;
+	}
+
+	if (IS_TUPLE(args->seq) && args->hi > (krk_integer_type)AS_TUPLE(args->seq)->values.count) {
+		krk_runtimeError(vm.exceptions->indexError, "tuple index out of range");
+		return 1;
+	}
+
+	return 0;
+}
+
+KRK_Function(bisect_left) {
+	struct BisectArgs args;
+	if (bisectArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	krk_integer_type i = bisect(args.seq, args.x, args.lo, args.hi, args.key, 1);
+	if (i < 0) return NONE_VAL();
+	return INTEGER_VAL(i);
+}
+
+KRK_Function(bisect_right) {
+	struct BisectArgs args;
+	if (bisectArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	krk_integer_type i = bisect(args.seq, args.x, args.lo, args.hi, args.key, 0);
+	if (i < 0) return NONE_VAL();
+	return INTEGER_VAL(i);
+}
+
+/* Unlike the bisect functions, insort applies @c key to @c x as well as to the items it is compared against. */
+static KrkValue insort(const char * _method_name, int argc, const KrkValue argv[], int hasKw, int left) {
+	struct BisectArgs args;
+	if (bisectArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+
+	KrkValue target = args.x;
+	if (!IS_NONE(args.key)) {
+		krk_push(args.key);
+		krk_push(args.x);
+		target = krk_callStack(1);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+		krk_push(target);
+	}
+
+	krk_integer_type i = bisect(args.seq, target, args.lo, args.hi, args.key, left);
+	if (i < 0) return NONE_VAL();
+
+	if (IS_INSTANCE(args.seq) && AS_INSTANCE(args.seq)->_class == vm.baseClasses->listClass) {
+		KrkValueArray * list = AS_LIST(args.seq);
+		if (i > (krk_integer_type)list->count) i = list->count;
+		krk_writeValueArray(list, NONE_VAL());
+		memmove(&list->values[i+1], &list->values[i], sizeof(KrkValue) * (list->count - i - 1));
+		list->values[i] = args.x;
+		return NONE_VAL();
+	}
+
+	KrkValue method = krk_valueGetAttribute(args.seq, "insert");
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	krk_push(method);
+	krk_push(INTEGER_VAL(i));
+	krk_push(args.x);
+	krk_callStack(2);
+	return NONE_VAL();
+}
+
+KRK_Function(insort_left) {
+	return insort(_method_name, argc, argv, hasKw, 1);
+}
+
+KRK_Function(insort_right) {
+	return insort(_method_name, argc, argv, hasKw, 0);
+}
+
+KrkValue krk_module_onload_bisect(void) {
+	KrkInstance * module = krk_newInstance(vm.baseClasses->moduleClass);
+	krk_push(OBJECT_VAL(module));
+
+	KRK_DOC(module, "@brief Binary search and insertion on sorted sequences.");
+
+	KRK_DOC(BIND_FUNC(module,bisect_left), "@brief Find where to insert @p x in sorted @p a, before any equal items.\n"
+		"@arguments a,x,lo=0,hi=len(a),key=None\n\n"
+		"Only @p a[lo:hi] is searched. If @p key is given, it is applied to the items of @p a, but not to @p x.");
+	KRK_DOC(BIND_FUNC(module,bisect_right), "@brief Find where to insert @p x in sorted @p a, after any equal items.\n"
+		"@arguments a,x,lo=0,hi=len(a),key=None\n\n"
+		"Only @p a[lo:hi] is searched. If @p key is given, it is applied to the items of @p a, but not to @p x.");
+	KRK_DOC(BIND_FUNC(module,insort_left), "@brief Insert @p x into sorted @p a, before any equal items.\n"
+		"@arguments a,x,lo=0,hi=len(a),key=None\n\n"
+		"If @p key is given, it is applied to @p x as well as to the items of @p a.");
+	KRK_DOC(BIND_FUNC(module,insort_right), "@brief Insert @p x into sorted @p a, after any equal items.\n"
+		"@arguments a,x,lo=0,hi=len(a),key=None\n\n"
+		"If @p key is given, it is applied to @p x as well as to the items of @p a.");
+
+	krk_attachNamedValue(&module->fields, "bisect", krk_valueGetAttribute(OBJECT_VAL(module), "bisect_right"));
+	krk_attachNamedValue(&module->fields, "insort", krk_valueGetAttribute(OBJECT_VAL(module), "insort_right"));
+
+	return krk_pop();
+}
@@ -0,0 +1,436 @@
+/**
+ * @file    module_heapq.c
+ * @brief   Heap queue algorithms.
+ *
+ * Heaps are plain lists where @c heap[k] <= @c heap[2*k+1] and
+ * @c heap[k] <= @c heap[2*k+2], so @c heap[0] is always the smallest item.
+ * Comparisons between two ints, two floats or two strings are done inline;
+ * anything else goes through @c __lt__.
+ */
+#include <kuroko/vm.h>
+#include <kuroko/util.h>
+
+/* A comparison may have run arbitrary code; make sure it neither raised nor resized the heap. */
+static int heapChanged(KrkValueArray * heap, size_t size) {
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 1;
+	if (unlikely(heap->count != size)) {
+		krk_runtimeError(vm.exceptions->valueError, "list changed size during iteration");
+		return 1;
+	}
+	return 0;
+}
+
+static void swapValues(KrkValue * values, size_t a, size_t b) {
+	KrkValue tmp = values[a];
+	values[a] = values[b];
+	values[b] = tmp;
+}
+
+/* Move the item at @p pos towards the root until its parent is not larger. */
+static int siftDown(KrkValueArray * heap, size_t start, size_t pos) {
+	size_t size = heap->count;
+	while (pos > start) {
+		size_t parent = (pos - 1) >> 1;
+		int lt = krk_lessThan(heap->values[pos], heap->values[parent]);
+		if (heapChanged(heap, size)) return 1;
+		if (!lt) break;
+		swapValues(heap->values, pos, parent);
+		pos = parent;
+	}
+	return 0;
+}
+
+/*
+ * Move the item at @p pos to a leaf by always following the smaller child,
+ * then back up to where it belongs. Items being sifted usually came from
+ * the bottom of the heap, so this takes fewer comparisons than stopping early.
+ */
+static int siftUp(KrkValueArray * heap, size_t pos) {
+	size_t size = heap->count;
+	size_t start = pos;
+	size_t limit = size >> 1;
+	while (pos < limit) {
+		size_t child = 2 * pos + 1;
+		if (child + 1 < size) {
+			int lt = krk_lessThan(heap->values[child], heap->values[child + 1]);
+			if (heapChanged(heap, size)) return 1;
+			if (!lt) child++;
+		}
+		swapValues(heap->values, pos, child);
+		pos = child;
+	}
+	return siftDown(heap, start, pos);
+}
+
+KRK_Function(heappush) {
+	FUNCTION_TAKES_EXACTLY(2);
+	CHECK_ARG(0,list,KrkList*,list);
+	KrkValueArray * heap = AS_LIST(argv[0]);
+	krk_writeValueArray(heap, argv[1]);
+	siftDown(heap, 0, heap->count - 1);
+	return NONE_VAL();
+}
+
+KRK_Function(heappop) {
+	FUNCTION_TAKES_EXACTLY(1);
+	CHECK_ARG(0,list,KrkList*,list);
+	KrkValueArray * heap = AS_LIST(argv[0]);
+	if (!heap->count) return krk_runtimeError(vm.exceptions->indexError, "index out of range");
+	KrkValue last = heap->values[--heap->count];
+	if (!heap->count) return last;
+	krk_push(heap->values[0]);
+	heap->values[0] = last;
+	if (siftUp(heap, 0)) return NONE_VAL();
+	return krk_pop();
+}
+
+KRK_Function(heapreplace) {
+	FUNCTION_TAKES_EXACTLY(2);
+	CHECK_ARG(0,list,KrkList*,list);
+	KrkValueArray * heap = AS_LIST(argv[0]);
+	if (!heap->count) return krk_runtimeError(vm.exceptions->indexError, "index out of range");
+	krk_push(heap->values[0]);
+	heap->values[0] = argv[1];
+	if (siftUp(heap, 0)) return NONE_VAL();
+	return krk_pop();
+}
+
+KRK_Function(heappushpop) {
+	FUNCTION_TAKES_EXACTLY(2);
+	CHECK_ARG(0,list,KrkList*,list);
+	KrkValueArray * heap = AS_LIST(argv[0]);
+	size_t size = heap->count;
+	if (!size) return argv[1];
+	int lt = krk_lessThan(heap->values[0], argv[1]);
+	if (heapChanged(heap, size)) return NONE_VAL();
+	if (!lt) return argv[1];
+	krk_push(heap->values[0]);
+	heap->values[0] = argv[1];
+	if (siftUp(heap, 0)) return NONE_VAL();
+	return krk_pop();
+}
+
+KRK_Function(heapify) {
+	FUNCTION_TAKES_EXACTLY(1);
+	CHECK_ARG(0,list,KrkList*,list);
+	KrkValueArray * heap = AS_LIST(argv[0]);
+	for (size_t i = heap->count / 2; i > 0; --i) {
+		if (siftUp(heap, i - 1)) return NONE_VAL();
+	}
+	return NONE_VAL();
+}
+
+/**
+ * @brief Heap of ranked entries, used by nsmallest, nlargest and merge.
+ *
+ * Entries are stored as runs of three values - key, item, and an int used to
+ * break ties between equal keys - in a list that is kept on the stack or in
+ * an object that marks it. The root is the entry that ranks first: a lower
+ * key, or with @c flip a higher key, and then a lower tie-breaker.
+ */
+struct Ranked {
+	KrkValueArray * heap;
+	int flip;
+};
+
+#define RANK_KEY(r,i)   ((r)->heap->values[(i)*3])
+#define RANK_ITEM(r,i)  ((r)->heap->values[(i)*3+1])
+#define RANK_ORDER(r,i) AS_INTEGER((r)->heap->values[(i)*3+2])
+
+/* 1 if entry @p i ranks before entry @p j, 0 if not, -1 if a comparison raised. */
+static int rankedBefore(struct Ranked * r, size_t i, size_t j) {
+	KrkValue a = RANK_KEY(r,i), b = RANK_KEY(r,j);
+	if (r->flip) {
+		KrkValue tmp = a;
+		a = b;
+		b = tmp;
+	}
+	int lt = krk_lessThan(a, b);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
+	if (lt) return 1;
+	int gt = krk_lessThan(b, a);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
+	return !gt && RANK_ORDER(r,i) < RANK_ORDER(r,j);
+}
+
+static void rankedSwap(struct Ranked * r, size_t a, size_t b) {
+	for (size_t k = 0; k < 3; ++k) swapValues(r->heap->values, a * 3 + k, b * 3 + k);
+}
+
+static int rankedUp(struct Ranked * r, size_t pos) {
+	while (pos > 0) {
+		size_t parent = (pos - 1) >> 1;
+		int before = rankedBefore(r, pos, parent);
+		if (before < 0) return 1;
+		if (!before) break;
+		rankedSwap(r, pos, parent);
+		pos = parent;
+	}
+	return 0;
+}
+
+static int rankedDown(struct Ranked * r, size_t pos, size_t size) {
+	while (1) {
+		size_t best = pos;
+		for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < size; ++child) {
+			int before = rankedBefore(r, child, best);
+			if (before < 0) return 1;
+			if (before) best = child;
+		}
+		if (best == pos) return 0;
+		rankedSwap(r, pos, best);
+		pos = best;
+	}
+}
+
+static void rankedAppend(struct Ranked * r, KrkValue key, KrkValue item, krk_integer_type order) {
+	krk_writeValueArray(r->heap, key);
+	krk_writeValueArray(r->heap, item);
+	krk_writeValueArray(r->heap, INTEGER_VAL(order));
+}
+
+static KrkValue applyKey(KrkValue key, KrkValue item) {
+	if (IS_NONE(key)) return item;
+	krk_push(key);
+	krk_push(item);
+	return krk_callStack(1);
+}
+
+struct TopK {
+	struct Ranked r;
+	KrkValue key;
+	size_t n;
+	krk_integer_type seen;
+};
+
+/*
+ * The heap keeps the worst of the best @c n items seen so far at its root,
+ * and later items only replace it if they are strictly better, so ties keep
+ * their original order - the same result as a stable sort.
+ */
+static int _topk_callback(void * context, const KrkValue * values, size_t count) {
+	struct TopK * t = context;
+	for (size_t i = 0; i < count; ++i) {
+		KrkValue item = values[i];
+		krk_push(item);
+		KrkValue key = applyKey(t->key, item);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 1;
+		krk_push(key);
+		krk_integer_type order = -(t->seen++);
+		size_t size = t->r.heap->count / 3;
+		if (size < t->n) {
+			rankedAppend(&t->r, key, item, order);
+			if (rankedUp(&t->r, size)) return 1;
+		} else {
+			int better = t->r.flip ? krk_lessThan(key, RANK_KEY(&t->r,0)) : krk_lessThan(RANK_KEY(&t->r,0), key);
+			if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 1;
+			if (better) {
+				RANK_KEY(&t->r,0) = key;
+				RANK_ITEM(&t->r,0) = item;
+				t->r.heap->values[2] = INTEGER_VAL(order);
+				if (rankedDown(&t->r, 0, size)) return 1;
+			}
+		}
+		krk_pop();
+		krk_pop();
+	}
+	return 0;
+}
+
+static KrkValue topK(const char * _method_name, int argc, const KrkValue argv[], int hasKw, int largest) {
+	krk_integer_type n;
+	KrkValue iterable;
+	KrkValue key = NONE_VAL();
+	KrkValue n_arg;
+	if (!krk_parseArgs("VV|$V", (const char*[]){"n","iterable","key"}, &n_arg, &iterable, &key)) return NONE_VAL();
+	if (!IS_INTEGER(n_arg)) return TYPE_ERROR(int,n_arg);
+	n = AS_INTEGER(n_arg);
+
+	/* Arguments taken from keywords are not referenced anywhere else. */
+	krk_push(iterable);
+	krk_push(key);
+	KrkValue out = krk_list_of(0, NULL, 0);
+	krk_push(out);
+	if (n <= 0) return krk_pop();
+
+	/* Comparisons and key functions can run arbitrary code, so never iterate a list in place. */
+	if (IS_list(iterable)) {
+		iterable = krk_list_of(AS_LIST(iterable)->count, AS_LIST(iterable)->values, 0);
+		krk_push(iterable);
+	}
+
+	struct TopK t = { { AS_LIST(out), !largest }, key, n, 0 };
+	if (krk_unpackIterable(iterable, &t, _topk_callback)) return NONE_VAL();
+
+	/* Repeatedly move the worst remaining entry to the end, leaving the best first. */
+	for (size_t size = t.r.heap->count / 3; size > 1; --size) {
+		rankedSwap(&t.r, 0, size - 1);
+		if (rankedDown(&t.r, 0, size - 1)) return NONE_VAL();
+	}
+
+	size_t count = t.r.heap->count / 3;
+	for (size_t i = 0; i < count; ++i) t.r.heap->values[i] = RANK_ITEM(&t.r,i);
+	t.r.heap->count = count;
+	return out;
+}
+
+KRK_Function(nsmallest) {
+	return topK(_method_name, argc, argv, hasKw, 0);
+}
+
+KRK_Function(nlargest) {
+	return topK(_method_name, argc, argv, hasKw, 1);
+}
+
+static KrkClass * merge;
+
+/**
+ * @brief Iterator produced by merge().
+ *
+ * Holds one iterator per input and a ranked heap with the next item from
+ * each input that is not yet exhausted, tie-broken by input position.
+ */
+struct Merge {
+	KrkInstance inst;
+	KrkValue iters;
+	KrkValue heap;
+	KrkValue key;
+	int reverse;
+};
+
+#define IS_merge(o) (krk_isInstanceOf(o,merge))
+#define AS_merge(o) ((struct Merge*)AS_OBJECT(o))
+#define CURRENT_CTYPE struct Merge *
+#define CURRENT_NAME  self
+
+static void _merge_gcscan(KrkInstance * _self) {
+	struct Merge * self = (struct Merge*)_self;
+	krk_markValue(self->iters);
+	krk_markValue(self->heap);
+	krk_markValue(self->key);
+}
+
+/* Fetch the next item from input @p src; returns the iterator itself when it is exhausted. */
+static KrkValue mergeAdvance(struct Merge * self, size_t src) {
+	KrkValue iter = AS_LIST(self->iters)->values[src];
+	krk_push(iter);
+	return krk_callStack(0);
+}
+
+KRK_Method(merge,__init__) {
+	int count;
+	const KrkValue * iterables;
+	KrkValue key = NONE_VAL();
+	int reverse = 0;
+	if (!krk_parseArgs(".*$Vp", (const char*[]){"key","reverse"}, &count, &iterables, &key, &reverse)) return NONE_VAL();
+
+	/* Store the key first; it is only referenced from here once parsed from the keywords. */
+	self->key = key;
+	self->reverse = reverse;
+	self->iters = krk_list_of(0, NULL, 0);
+	self->heap = krk_list_of(0, NULL, 0);
+	struct Ranked r = { AS_LIST(self->heap), reverse };
+
+	for (int i = 0; i < count; ++i) {
+		KrkClass * type = krk_getType(iterables[i]);
+		if (unlikely(!type->_iter)) {
+			return krk_runtimeError(vm.exceptions->typeError, "'%T' object is not iterable", iterables[i]);
+		}
+		krk_push(iterables[i]);
+		KrkValue iter = krk_callDirect(type->_iter, 1);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+		krk_writeValueArray(AS_LIST(self->iters), iter);
+
+		KrkValue item = mergeAdvance(self, i);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+		if (krk_valuesSame(item, iter)) continue;
+		krk_push(item);
+		KrkValue k = applyKey(key, item);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+		krk_push(k);
+		rankedAppend(&r, k, item, i);
+		if (rankedUp(&r, r.heap->count / 3 - 1)) return NONE_VAL();
+		krk_pop();
+		krk_pop();
+	}
+
+	return argv[0];
+}
+
+KRK_Method(merge,__iter__) {
+	METHOD_TAKES_NONE();
+	return argv[0];
+}
+
+KRK_Method(merge,__call__) {
+	METHOD_TAKES_NONE();
+	if (!IS_OBJECT(self->heap)) return argv[0];
+	struct Ranked r = { AS_LIST(self->heap), self->reverse };
+	size_t size = r.heap->count / 3;
+	if (!size) return argv[0];
+
+	KrkValue out = RANK_ITEM(&r,0);
+	krk_push(out);
+
+	size_t src = RANK_ORDER(&r,0);
+	KrkValue item = mergeAdvance(self, src);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+
+	if (krk_valuesSame(item, AS_LIST(self->iters)->values[src])) {
+		rankedSwap(&r, 0, size - 1);
+		r.heap->count -= 3;
+		size--;
+	} else {
+		krk_push(item);
+		KrkValue k = applyKey(self->key, item);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+		RANK_KEY(&r,0) = k;
+		RANK_ITEM(&r,0) = item;
+		krk_pop();
+	}
+
+	if (rankedDown(&r, 0, size)) return NONE_VAL();
+	return krk_pop();
+}
+
+KrkValue krk_module_onload_heapq(void) {
+	KrkInstance * module = krk_newInstance(vm.baseClasses->moduleClass);
+	krk_push(OBJECT_VAL(module));
+
+	KRK_DOC(module, "@brief Heap queue algorithms.\n\n"
+		"A heap is a list where each item is no larger than its children at positions "
+		"@c 2*k+1 and @c 2*k+2, so that the smallest item is always at index 0.");
+
+	KRK_DOC(BIND_FUNC(module,heappush), "@brief Push @p item onto @p heap, keeping the heap invariant.\n"
+		"@arguments heap,item");
+	KRK_DOC(BIND_FUNC(module,heappop), "@brief Pop and return the smallest item from @p heap.\n"
+		"@arguments heap");
+	KRK_DOC(BIND_FUNC(module,heapreplace), "@brief Pop and return the smallest item from @p heap, then push @p item.\n"
+		"@arguments heap,item\n\n"
+		"The heap must not be empty. The returned value may be larger than @p item.");
+	KRK_DOC(BIND_FUNC(module,heappushpop), "@brief Push @p item onto @p heap, then pop and return the smallest item.\n"
+		"@arguments heap,item\n\n"
+		"Faster than a separate push and pop, and returns @p item directly if it is the smallest.");
+	KRK_DOC(BIND_FUNC(module,heapify), "@brief Rearrange a list into a heap, in place, in linear time.\n"
+		"@arguments x");
+	KRK_DOC(BIND_FUNC(module,nsmallest), "@brief Find the @p n smallest items of @p iterable.\n"
+		"@arguments n,iterable,key=None\n\n"
+		"Equivalent to @c sorted(iterable,key=key)[:n], but only keeps @p n items at a time.");
+	KRK_DOC(BIND_FUNC(module,nlargest), "@brief Find the @p n largest items of @p iterable.\n"
+		"@arguments n,iterable,key=None\n\n"
+		"Equivalent to @c sorted(iterable,key=key,reverse=True)[:n], but only keeps @p n items at a time.");
+
+	krk_makeClass(module, &merge, "merge", vm.baseClasses->objectClass);
+	KRK_DOC(merge, "@brief Merge sorted inputs into a single sorted iterator.\n"
+		"@arguments *iterables,key=None,reverse=False\n\n"
+		"Inputs are consumed lazily. Equal items are produced in the order of their inputs.");
+	merge->allocSize = sizeof(struct Merge);
+	merge->_ongcscan = _merge_gcscan;
+	merge->obj.flags |= KRK_OBJ_FLAGS_NO_INHERIT;
+	BIND_METHOD(merge,__init__);
+	BIND_METHOD(merge,__iter__);
+	BIND_METHOD(merge,__call__);
+	krk_finalizeClass(merge);
+
+	return krk_pop();
+}
@@ -2,10 +2,12 @@
  * math module; thin wrapper around libc math functions.
  */
 #include <math.h>
+#include <stdlib.h>
 #include <kuroko/vm.h>
 #include <kuroko/value.h>
 #include <kuroko/object.h>
 #include <kuroko/util.h>
+#include <kuroko/memory.h>
 
 #define ONE_ARGUMENT(name) if (argc != 1) { \
 	krk_runtimeError(vm.exceptions->argumentError, "%s() expects one argument", #name); \
@@ -147,6 +149,247 @@ MATH_IS(isfinite)
 MATH_IS(isinf)
 MATH_IS(isnan)
 
+static int toDouble(KrkValue value, double * out) {
+	FORCE_FLOAT(value,arg)
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 0;
+	if (!IS_FLOATING(arg)) {
+		krk_runtimeError(vm.exceptions->typeError, "must be real number, not '%T'", value);
+		return 0;
+	}
+	*out = AS_FLOATING(arg);
+	return 1;
+}
+
+/*
+ * fsum keeps the running total as a list of non-overlapping partial sums
+ * (Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+ * Geometric Predicates"), so the result is correctly rounded. This follows
+ * CPython's implementation, including its handling of inf and nan.
+ */
+struct FsumContext {
+	double * partials;
+	size_t count;
+	size_t capacity;
+	double special;
+	double inf;
+};
+
+static int _fsum_callback(void * context, const KrkValue * values, size_t count) {
+	struct FsumContext * _context = context;
+	for (size_t k = 0; k < count; ++k) {
+		double x;
+		if (!toDouble(values[k], &x)) return 1;
+		double xsave = x;
+		size_t i = 0;
+		for (size_t j = 0; j < _context->count; ++j) {
+			double y = _context->partials[j];
+			if (fabs(x) < fabs(y)) {
+				double t = x; x = y; y = t;
+			}
+			double hi = x + y;
+			double lo = y - (hi - x);
+			if (lo != 0.0) _context->partials[i++] = lo;
+			x = hi;
+		}
+		_context->count = i;
+		if (x != 0.0) {
+			if (!isfinite(x)) {
+				/* Either an inf or nan in the input, or an intermediate overflow */
+				if (isfinite(xsave)) {
+					krk_runtimeError(vm.exceptions->valueError, "intermediate overflow in fsum");
+					return 1;
+				}
+				if (isinf(xsave)) _context->inf += xsave;
+				_context->special += xsave;
+				_context->count = 0;
+			} else {
+				if (_context->count == _context->capacity) {
+					size_t old = _context->capacity;
+					_context->capacity = GROW_CAPACITY(old);
+					_context->partials = GROW_ARRAY(double, _context->partials, old, _context->capacity);
+				}
+				_context->partials[_context->count++] = x;
+			}
+		}
+	}
+	return 0;
+}
+
+static KrkValue _math_fsum(int argc, const KrkValue argv[], int hasKw) {
+	ONE_ARGUMENT(fsum)
+	struct FsumContext context = { NULL, 0, 0, 0.0, 0.0 };
+	int failed = krk_unpackIterable(argv[0], &context, _fsum_callback);
+	double * p = context.partials;
+	size_t n = context.count;
+	double hi = 0.0;
+
+	if (failed) goto _done;
+	if (context.special != 0.0) {
+		if (isnan(context.inf)) krk_runtimeError(vm.exceptions->valueError, "-inf + inf in fsum");
+		else hi = context.special;
+		goto _done;
+	}
+
+	if (n > 0) {
+		double lo = 0.0;
+		hi = p[--n];
+		/* Add from the top down until the sum becomes inexact */
+		while (n > 0) {
+			double x = hi, y = p[--n];
+			hi = x + y;
+			lo = y - (hi - x);
+			if (lo != 0.0) break;
+		}
+		/* Round half-even correctly when the rest of the partials push the result one way */
+		if (n > 0 && ((lo < 0.0 && p[n-1] < 0.0) || (lo > 0.0 && p[n-1] > 0.0))) {
+			double y = lo * 2.0;
+			double x = hi + y;
+			if (y == x - hi) hi = x;
+		}
+	}
+
+_done:
+	FREE_ARRAY(double, context.partials, context.capacity);
+	if (failed || (krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	return FLOATING_VAL(hi);
+}
+
+struct SimpleContext {
+	KrkValue base;
+};
+
+/* Runs of ints are multiplied unboxed until they overflow, and floats likewise. */
+static int _prod_callback(void * context, const KrkValue * values, size_t count) {
+	struct SimpleContext * _context = context;
+	size_t i = 0;
+	while (i < count) {
+		if (IS_INTEGER(_context->base)) {
+			int64_t acc = AS_INTEGER(_context->base), next;
+			size_t start = i;
+			for (; i < count && IS_INTEGER(values[i]); ++i) {
+				if (__builtin_mul_overflow(acc, (int64_t)AS_INTEGER(values[i]), &next)) break;
+				acc = next;
+			}
+			if (i != start) _context->base = krk_int_from_int64(acc);
+		} else if (IS_FLOATING(_context->base)) {
+			double acc = AS_FLOATING(_context->base);
+			for (; i < count; ++i) {
+				if (IS_FLOATING(values[i])) acc *= AS_FLOATING(values[i]);
+				else if (IS_INTEGER(values[i])) acc *= (double)AS_INTEGER(values[i]);
+				else break;
+			}
+			_context->base = FLOATING_VAL(acc);
+		}
+		if (i == count) break;
+		_context->base = krk_operator_mul(_context->base, values[i++]);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 1;
+	}
+	return 0;
+}
+
+static KrkValue _math_prod(int argc, const KrkValue argv[], int hasKw) {
+	static const char * _method_name = "prod";
+	KrkValue iterable, start = INTEGER_VAL(1);
+	if (!krk_parseArgs("V|$V", (const char*[]){"iterable","start"}, &iterable, &start)) return NONE_VAL();
+	struct SimpleContext context = { start };
+	if (krk_unpackIterable(iterable, &context, _prod_callback)) return NONE_VAL();
+	return context.base;
+}
+
+/*
+ * Euclidean norm without overflow or needless rounding: scale by a power of
+ * two so the largest magnitude is just under 1, then sum the squares with
+ * their rounding errors (recovered with fma) carried in a compensation term.
+ */
+static double vectorNorm(const double * v, size_t n) {
+	double max = 0.0;
+	int foundNan = 0;
+	for (size_t i = 0; i < n; ++i) {
+		double x = fabs(v[i]);
+		foundNan |= isnan(x);
+		if (x > max) max = x;
+	}
+	if (isinf(max)) return max;
+	if (foundNan) return NAN;
+	if (max == 0.0 || n <= 1) return max;
+
+	int e;
+	frexp(max, &e);
+	double sum = 0.0, compensation = 0.0;
+	for (size_t i = 0; i < n; ++i) {
+		double x = ldexp(v[i], -e);
+		double square = x * x;
+		compensation += fma(x, x, -square);
+		double t = sum + square;
+		compensation += (sum - t) + square;
+		sum = t;
+	}
+	return ldexp(sqrt(sum + compensation), e);
+}
+
+static KrkValue _math_hypot(int argc, const KrkValue argv[], int hasKw) {
+	double * coordinates = malloc(sizeof(double) * (argc ? argc : 1));
+	if (!coordinates) return krk_runtimeError(vm.exceptions->baseException, "out of memory");
+	for (int i = 0; i < argc; ++i) {
+		if (!toDouble(argv[i], &coordinates[i])) {
+			free(coordinates);
+			return NONE_VAL();
+		}
+	}
+	double result = vectorNorm(coordinates, argc);
+	free(coordinates);
+	return FLOATING_VAL(result);
+}
+
+struct PointContext {
+	double * values;
+	size_t count;
+	size_t capacity;
+};
+
+static int _point_callback(void * context, const KrkValue * values, size_t count) {
+	struct PointContext * _context = context;
+	for (size_t i = 0; i < count; ++i) {
+		if (_context->count == _context->capacity) {
+			size_t old = _context->capacity;
+			_context->capacity = GROW_CAPACITY(old);
+			_context->values = GROW_ARRAY(double, _context->values, old, _context->capacity);
+		}
+		if (!toDouble(values[i], &_context->values[_context->count++])) return 1;
+	}
+	return 0;
+}
+
+static KrkValue _math_dist(int argc, const KrkValue argv[], int hasKw) {
+	TWO_ARGUMENTS(dist)
+	struct PointContext p = { NULL, 0, 0 }, q = { NULL, 0, 0 };
+	KrkValue result = NONE_VAL();
+	if (krk_unpackIterable(argv[0], &p, _point_callback) || krk_unpackIterable(argv[1], &q, _point_callback)) goto _done;
+	if (p.count != q.count) {
+		krk_runtimeError(vm.exceptions->valueError, "both points must have the same number of dimensions");
+		goto _done;
+	}
+	for (size_t i = 0; i < p.count; ++i) p.values[i] -= q.values[i];
+	result = FLOATING_VAL(vectorNorm(p.values, p.count));
+_done:
+	FREE_ARRAY(double, p.values, p.capacity);
+	FREE_ARRAY(double, q.values, q.capacity);
+	return result;
+}
+
+static KrkValue _math_isclose(int argc, const KrkValue argv[], int hasKw) {
+	static const char * _method_name = "isclose";
+	KrkValue _a, _b, _relTol = FLOATING_VAL(1e-09), _absTol = FLOATING_VAL(0.0);
+	double a, b, relTol, absTol;
+	if (!krk_parseArgs("VV|$VV", (const char*[]){"a","b","rel_tol","abs_tol"}, &_a, &_b, &_relTol, &_absTol)) return NONE_VAL();
+	if (!toDouble(_a, &a) || !toDouble(_b, &b) || !toDouble(_relTol, &relTol) || !toDouble(_absTol, &absTol)) return NONE_VAL();
+	if (relTol < 0.0 || absTol < 0.0) return krk_runtimeError(vm.exceptions->valueError, "tolerances must be non-negative");
+	if (a == b) return BOOLEAN_VAL(1);
+	if (isinf(a) || isinf(b)) return BOOLEAN_VAL(0);
+	double diff = fabs(b - a);
+	return BOOLEAN_VAL(diff <= fabs(relTol * b) || diff <= fabs(relTol * a) || diff <= absTol);
+}
+
 #define bind(name) krk_defineNative(&module->fields, #name, _math_ ## name)
 
 KrkValue krk_module_onload_math(void) {
@@ -261,6 +504,24 @@ KrkValue krk_module_onload_math(void) {
 	KRK_DOC(bind(isnan),
 		"@brief Determines if the input is the floating point `NaN`.\n"
 		"@arguments x\n");
+	KRK_DOC(bind(fsum),
+		"@brief Returns an accurate floating point sum of the values in an iterable.\n"
+		"@arguments iterable\n\n"
+		"Tracks multiple intermediate partial sums, so the result is correctly rounded.");
+	KRK_DOC(bind(prod),
+		"@brief Multiplies the values in an iterable together, starting from @p start.\n"
+		"@arguments iterable,*,start=1");
+	KRK_DOC(bind(hypot),
+		"@brief Returns the Euclidean norm of the arguments, `sqrt(sum(x**2 for x in coordinates))`.\n"
+		"@arguments *coordinates");
+	KRK_DOC(bind(dist),
+		"@brief Returns the Euclidean distance between the points @p p and @p q.\n"
+		"@arguments p,q\n\n"
+		"Both points must have the same number of coordinates.");
+	KRK_DOC(bind(isclose),
+		"@brief Determines if @p a and @p b are close to each other.\n"
+		"@arguments a,b,*,rel_tol=1e-09,abs_tol=0.0\n\n"
+		"Values are close if their difference is within @p rel_tol of the larger magnitude, or within @p abs_tol.");
 
 	/**
 	 * Maybe the math library should be a core one, but I'm not sure if I want
@@ -3,71 +3,494 @@
  * @brief   Functions for generating pseudo-random numbers.
  * @author  K. Lange <klange@toaruos.org>
  *
+ * Numbers come from xoshiro256** (Blackman and Vigna), seeded through
+ * SplitMix64. The module-level functions use a generator that belongs to
+ * the calling thread, so threads never share or contend on state and each
+ * gets its own stream; @c Random instances carry their own generator for
+ * reproducible independent streams.
  */
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <time.h>
 #include <sys/time.h>
 #include <kuroko/vm.h>
 #include <kuroko/util.h>
 
-static uint32_t x = 123456789;
-static uint32_t y = 362436069;
-static uint32_t z = 521288629;
-static uint32_t w = 88675123;
+struct RandomState {
+	uint64_t s[4];
+	int seeded;
+	int hasGauss;
+	double nextGauss;
+};
 
-static int _rand(void) {
-	uint32_t t;
+static KrkClass * Random;
 
-	t = x ^ (x << 11);
-	x = y; y = z; z = w;
-	w = w ^ (w >> 19) ^ t ^ (t >> 8);
+struct Random {
+	KrkInstance inst;
+	struct RandomState state;
+};
 
-	return (w & RAND_MAX);
+#define IS_Random(o) (krk_isInstanceOf(o,Random))
+#define AS_Random(o) ((struct Random*)AS_OBJECT(o))
+
+static threadLocal struct RandomState threadState;
+
+static inline uint64_t rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t _next(struct RandomState * state) {
+	uint64_t * s = state->s;
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return result;
+}
+
+static uint64_t _splitmix(uint64_t * x) {
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
 }
 
-void _srand(unsigned int seed) {
-	x = 123456789  ^ (seed << 16) ^ (seed >> 16);
-	y = 362436069;
-	z = 521288629;
-	w = 88675123;
+static void _seed(struct RandomState * state, uint64_t seed) {
+	for (int i = 0; i < 4; ++i) state->s[i] = _splitmix(&seed);
+	state->seeded = 1;
+	state->hasGauss = 0;
 }
 
-KRK_Function(random) {
+/* Seed from the clock, mixed with the address of the state so threads seeded together still differ. */
+static void _seedFromTime(struct RandomState * state) {
+	struct timeval tv;
+	gettimeofday(&tv,NULL);
+	_seed(state, ((uint64_t)tv.tv_sec * 1000000 + tv.tv_usec) ^ ((uint64_t)(uintptr_t)state << 16));
+}
+
+static struct RandomState * _threadState(void) {
+	if (unlikely(!threadState.seeded)) _seedFromTime(&threadState);
+	return &threadState;
+}
+
+/* A subclass whose __init__ skips ours still gets a seeded generator on first use. */
+static struct RandomState * _instanceState(struct Random * self) {
+	if (unlikely(!self->state.seeded)) _seedFromTime(&self->state);
+	return &self->state;
+}
+
+static double _double(struct RandomState * state) {
+	return (double)(_next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Uniform in [0,n), for n > 0, by rejection so that every value is equally likely. */
+static uint64_t _below(struct RandomState * state, uint64_t n) {
+	if (n == 1) return 0;
+	uint64_t mask = UINT64_MAX >> __builtin_clzll(n - 1);
+	uint64_t r;
+	do r = _next(state) & mask; while (r >= n);
+	return r;
+}
+
+/* An int of @p k random bits. */
+static KrkValue _bits(struct RandomState * state, size_t k) {
+	if (k <= 64) return krk_int_from_uint64(k ? _next(state) >> (64 - k) : 0);
+	size_t digits = (k + 3) / 4;
+	char * hex = malloc(digits);
+	for (size_t i = 0; i < digits; i += 16) {
+		uint64_t r = _next(state);
+		for (size_t j = i; j < digits && j < i + 16; ++j, r >>= 4) {
+			unsigned int nibble = r & 0xF;
+			if (j == 0 && k % 4) nibble &= (1 << (k % 4)) - 1;
+			hex[j] = "0123456789abcdef"[nibble];
+		}
+	}
+	KrkValue result = krk_parse_int(hex, digits, 16);
+	free(hex);
+	return result;
+}
+
+/* Uniform in [0,n) for an int n > 0 of any size. */
+static KrkValue _belowValue(struct RandomState * state, KrkValue n) {
+	uint64_t small;
+	if (krk_int_to_uint64(n, &small)) return krk_int_from_uint64(_below(state, small));
+	KrkValue bitLength = krk_valueGetAttribute(n, "bit_length");
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	krk_push(bitLength);
+	bitLength = krk_callStack(0);
+	if (unlikely(!IS_INTEGER(bitLength))) return NONE_VAL();
+	for (;;) {
+		KrkValue r = _bits(state, AS_INTEGER(bitLength));
+		krk_push(r);
+		int lt = !krk_isFalsey(krk_operator_lt(r, n));
+		krk_pop();
+		if (lt) return r;
+	}
+}
+
+/* Accept an int or a float where a float is expected. */
+static int asDouble(KrkValue value, double * out) {
+	if (IS_FLOATING(value)) *out = AS_FLOATING(value);
+	else if (IS_INTEGER(value)) *out = AS_INTEGER(value);
+	else {
+		krk_runtimeError(vm.exceptions->typeError, "must be real number, not '%T'", value);
+		return 0;
+	}
+	return 1;
+}
+
+static int isInt(KrkValue value) {
+	return IS_INTEGER(value) || krk_isInstanceOf(value, vm.baseClasses->longClass);
+}
+
+#define CURRENT_CTYPE struct Random *
+#define CURRENT_NAME  self
+
+/*
+ * Each operation is written once against a generator state, then exposed
+ * both as a method of Random and as a module function that uses the
+ * calling thread's generator. Methods pass their arguments without self.
+ */
+#define RANDOM_FUNCTION(name) \
+	static KrkValue _random_ ## name (const char * _method_name, struct RandomState * state, int argc, const KrkValue argv[], int hasKw); \
+	KRK_Function(name) { return _random_ ## name(_method_name, _threadState(), argc, argv, hasKw); } \
+	KRK_Method(Random,name) { return _random_ ## name(_method_name, _instanceState(self), argc - 1, argv + 1, hasKw); } \
+	static KrkValue _random_ ## name (const char * _method_name, struct RandomState * state, int argc, const KrkValue argv[], int hasKw)
+
+RANDOM_FUNCTION(seed) {
+	KrkValue a = NONE_VAL();
+	if (!krk_parseArgs("|V", (const char*[]){"a"}, &a)) return NONE_VAL();
+
+	int64_t seed;
+	uint32_t hash;
+	if (IS_NONE(a)) {
+		_seedFromTime(state);
+		return NONE_VAL();
+	} else if (krk_int_to_int64(a, &seed)) {
+		/* ok */
+	} else if (!krk_hashValue(a, &hash)) {
+		seed = hash;
+	} else {
+		return NONE_VAL();
+	}
+
+	_seed(state, seed);
+	return NONE_VAL();
+}
+
+RANDOM_FUNCTION(random) {
 	FUNCTION_TAKES_NONE();
+	return FLOATING_VAL(_double(state));
+}
+
+RANDOM_FUNCTION(uniform) {
+	KrkValue _a, _b;
+	double a, b;
+	if (!krk_parseArgs("VV", (const char*[]){"a","b"}, &_a, &_b)) return NONE_VAL();
+	if (!asDouble(_a, &a) || !asDouble(_b, &b)) return NONE_VAL();
+	return FLOATING_VAL(a + (b - a) * _double(state));
+}
+
+RANDOM_FUNCTION(getrandbits) {
+	int k;
+	if (!krk_parseArgs("i", (const char*[]){"k"}, &k)) return NONE_VAL();
+	if (k < 0) return krk_runtimeError(vm.exceptions->valueError, "number of bits must be non-negative");
+	return _bits(state, k);
+}
+
+RANDOM_FUNCTION(randrange) {
+	KrkValue start, stop = NONE_VAL(), step = INTEGER_VAL(1);
+	if (!krk_parseArgs("V|VV", (const char*[]){"start","stop","step"}, &start, &stop, &step)) return NONE_VAL();
+	if (IS_NONE(stop)) {
+		stop = start;
+		start = INTEGER_VAL(0);
+	}
+	if (!isInt(start) || !isInt(stop) || !isInt(step)) {
+		return krk_runtimeError(vm.exceptions->typeError, "randrange() arguments must be int");
+	}
+
+	/* Everything in 64 bits, which covers nearly all uses */
+	int64_t a, b, c, width, count;
+	if (krk_int_to_int64(start, &a) && krk_int_to_int64(stop, &b) && krk_int_to_int64(step, &c) &&
+	    c != INT64_MIN && !__builtin_sub_overflow(b, a, &width) && !__builtin_add_overflow(width, c > 0 ? c - 1 : c + 1, &count)) {
+		if (c == 0) return krk_runtimeError(vm.exceptions->valueError, "zero step for randrange()");
+		count /= c;
+		if (count <= 0) return krk_runtimeError(vm.exceptions->valueError, "empty range for randrange()");
+		return krk_int_from_int64(a + (int64_t)_below(state, count) * c);
+	}
 
-	double r = (double)_rand() / (double)(RAND_MAX);
+	if (IS_INTEGER(step) && AS_INTEGER(step) == 0) return krk_runtimeError(vm.exceptions->valueError, "zero step for randrange()");
 
-	return FLOATING_VAL(r);
+	/* Arguments passed by keyword and the intermediate longs are only held here; keep them on the stack. */
+	krk_push(start);
+	krk_push(stop);
+	krk_push(step);
+	int positive = !krk_isFalsey(krk_operator_gt(step, INTEGER_VAL(0)));
+	KrkValue count_ = krk_operator_sub(stop, start);
+	krk_push(count_);
+	KrkValue adjust = krk_operator_add(step, INTEGER_VAL(positive ? -1 : 1));
+	krk_push(adjust);
+	count_ = krk_operator_add(count_, adjust);
+	krk_push(count_);
+	count_ = krk_operator_floordiv(count_, step);
+	krk_push(count_);
+	if (krk_isFalsey(krk_operator_gt(count_, INTEGER_VAL(0)))) {
+		return krk_runtimeError(vm.exceptions->valueError, "empty range for randrange()");
+	}
+	KrkValue r = _belowValue(state, count_);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	krk_push(r);
+	KrkValue offset = krk_operator_mul(r, step);
+	krk_push(offset);
+	return krk_operator_add(start, offset);
+}
+
+RANDOM_FUNCTION(randint) {
+	KrkValue a, b;
+	if (!krk_parseArgs("VV", (const char*[]){"a","b"}, &a, &b)) return NONE_VAL();
+	if (!isInt(a) || !isInt(b)) return krk_runtimeError(vm.exceptions->typeError, "randint() arguments must be int");
+	int64_t lo, hi, width;
+	if (krk_int_to_int64(a, &lo) && krk_int_to_int64(b, &hi) && lo <= hi && !__builtin_sub_overflow(hi, lo, &width)) {
+		return krk_int_from_int64(lo + (int64_t)_below(state, (uint64_t)width + 1));
+	}
+	krk_push(a);
+	krk_push(b);
+	KrkValue width_ = krk_operator_sub(b, a);
+	krk_push(width_);
+	KrkValue count = krk_operator_add(width_, INTEGER_VAL(1));
+	krk_push(count);
+	if (krk_isFalsey(krk_operator_gt(count, INTEGER_VAL(0)))) {
+		return krk_runtimeError(vm.exceptions->valueError, "empty range for randint()");
+	}
+	KrkValue r = _belowValue(state, count);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	krk_push(r);
+	return krk_operator_add(a, r);
 }
 
-KRK_Function(seed) {
-	FUNCTION_TAKES_AT_MOST(1);
-	int seed;
+RANDOM_FUNCTION(choice) {
+	KrkValue seq;
+	if (!krk_parseArgs("V", (const char*[]){"seq"}, &seq)) return NONE_VAL();
+	krk_push(seq);
+	krk_integer_type length;
+	if (!krk_sequenceLength(seq, &length)) return NONE_VAL();
+	if (length <= 0) return krk_runtimeError(vm.exceptions->indexError, "Cannot choose from an empty sequence");
+	return krk_sequenceItem(seq, _below(state, length));
+}
+
+RANDOM_FUNCTION(shuffle) {
+	KrkValue x;
+	if (!krk_parseArgs("V", (const char*[]){"x"}, &x)) return NONE_VAL();
+	krk_push(x);
+
+	if (IS_list(x)) {
+		KrkList * list = (KrkList*)AS_OBJECT(x);
+		pthread_rwlock_wrlock(&list->rwlock);
+		KrkValueArray * values = &list->values;
+		for (size_t i = values->count; i > 1; --i) {
+			size_t j = _below(state, i);
+			KrkValue tmp = values->values[i-1];
+			values->values[i-1] = values->values[j];
+			values->values[j] = tmp;
+		}
+		pthread_rwlock_unlock(&list->rwlock);
+		return NONE_VAL();
+	}
+
+	krk_integer_type length;
+	if (!krk_sequenceLength(x, &length)) return NONE_VAL();
+	KrkClass * type = krk_getType(x);
+	if (!type->_setter) return krk_runtimeError(vm.exceptions->typeError, "'%T' object does not support item assignment", x);
+	for (krk_integer_type i = length; i > 1; --i) {
+		krk_integer_type j = _below(state, i);
+		KrkValue a = krk_sequenceItem(x, i - 1);
+		krk_push(a);
+		KrkValue b = krk_sequenceItem(x, j);
+		krk_push(b);
+		if (likely(!(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION))) {
+			krk_push(x); krk_push(INTEGER_VAL(i - 1)); krk_push(b);
+			krk_callDirect(type->_setter, 3);
+		}
+		if (likely(!(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION))) {
+			krk_push(x); krk_push(INTEGER_VAL(j)); krk_push(a);
+			krk_callDirect(type->_setter, 3);
+		}
+		krk_pop();
+		krk_pop();
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	}
+	return NONE_VAL();
+}
+
+RANDOM_FUNCTION(sample) {
+	KrkValue population;
+	int k;
+	if (!krk_parseArgs("Vi", (const char*[]){"population","k"}, &population, &k)) return NONE_VAL();
+	krk_push(population);
+	krk_integer_type n;
+	if (!krk_sequenceLength(population, &n)) return NONE_VAL();
+	if (k < 0 || k > n) return krk_runtimeError(vm.exceptions->valueError, "Sample larger than population or is negative");
+
+	size_t * picks = malloc(sizeof(size_t) * (k ? k : 1));
 
-	if (argc > 0) {
-		CHECK_ARG(0,int,krk_integer_type,_seed);
-		seed = _seed;
+	if (n <= 2 * k + 16) {
+		/* Partial Fisher-Yates over the indices */
+		size_t * pool = malloc(sizeof(size_t) * (n ? n : 1));
+		for (krk_integer_type i = 0; i < n; ++i) pool[i] = i;
+		for (krk_integer_type i = 0; i < k; ++i) {
+			size_t j = i + _below(state, n - i);
+			picks[i] = pool[j];
+			pool[j] = pool[i];
+		}
+		free(pool);
 	} else {
-		struct timeval tv;
-		gettimeofday(&tv,NULL);
+		/* Sparse: draw indices and reject repeats, tracked in a small open-addressed set */
+		size_t capacity = 16;
+		while (capacity < (size_t)k * 2) capacity *= 2;
+		size_t * seen = malloc(sizeof(size_t) * capacity);
+		memset(seen, 0xFF, sizeof(size_t) * capacity);
+		for (krk_integer_type i = 0; i < k;) {
+			size_t r = _below(state, n);
+			size_t slot = (r * 0x9e3779b97f4a7c15ULL) & (capacity - 1);
+			while (seen[slot] != (size_t)-1 && seen[slot] != r) slot = (slot + 1) & (capacity - 1);
+			if (seen[slot] == r) continue;
+			seen[slot] = r;
+			picks[i++] = r;
+		}
+		free(seen);
+	}
+
+	KrkValue out = krk_list_of(0, NULL, 0);
+	krk_push(out);
+	for (krk_integer_type i = 0; i < k; ++i) {
+		KrkValue item = krk_sequenceItem(population, picks[i]);
+		if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) break;
+		krk_push(item);
+		krk_writeValueArray(AS_LIST(out), item);
+		krk_pop();
+	}
+	free(picks);
+	return krk_pop();
+}
 
-		seed = tv.tv_sec ^ tv.tv_usec;
+RANDOM_FUNCTION(gauss) {
+	KrkValue _mu = FLOATING_VAL(0.0), _sigma = FLOATING_VAL(1.0);
+	double mu, sigma;
+	if (!krk_parseArgs("|VV", (const char*[]){"mu","sigma"}, &_mu, &_sigma)) return NONE_VAL();
+	if (!asDouble(_mu, &mu) || !asDouble(_sigma, &sigma)) return NONE_VAL();
+
+	/* Marsaglia's polar method; each round yields two normal deviates. */
+	if (state->hasGauss) {
+		state->hasGauss = 0;
+		return FLOATING_VAL(mu + sigma * state->nextGauss);
+	}
+	double u, v, s;
+	do {
+		u = 2.0 * _double(state) - 1.0;
+		v = 2.0 * _double(state) - 1.0;
+		s = u * u + v * v;
+	} while (s >= 1.0 || s == 0.0);
+	double scale = sqrt(-2.0 * log(s) / s);
+	state->nextGauss = v * scale;
+	state->hasGauss = 1;
+	return FLOATING_VAL(mu + sigma * u * scale);
+}
+
+static void _fillBytes(struct RandomState * state, uint8_t * data, size_t length) {
+	size_t i = 0;
+	for (; i + 8 <= length; i += 8) {
+		uint64_t r = _next(state);
+		memcpy(data + i, &r, 8);
+	}
+	if (i < length) {
+		uint64_t r = _next(state);
+		memcpy(data + i, &r, length - i);
 	}
+}
+
+RANDOM_FUNCTION(randbytes) {
+	int n;
+	if (!krk_parseArgs("i", (const char*[]){"n"}, &n)) return NONE_VAL();
+	if (n < 0) return krk_runtimeError(vm.exceptions->valueError, "negative argument not allowed");
+	KrkBytes * out = krk_newBytes(n, NULL);
+	_fillBytes(state, out->bytes, n);
+	return OBJECT_VAL(out);
+}
 
-	_srand(seed);
+RANDOM_FUNCTION(fill) {
+	KrkValue target;
+	if (!krk_parseArgs("V", (const char*[]){"buffer"}, &target)) return NONE_VAL();
+	KrkBuffer buffer;
+	if (!krk_getBuffer(target, &buffer)) return NONE_VAL();
+	if (buffer.readonly) return krk_runtimeError(vm.exceptions->typeError, "cannot fill a read-only buffer");
+
+	/* A view into the middle of a buffer may not be aligned for the item type. */
+	if (buffer.format == 'd') {
+		for (size_t i = 0; i < buffer.length / sizeof(double); ++i) {
+			double out = _double(state);
+			memcpy(buffer.data + i * sizeof(double), &out, sizeof(out));
+		}
+	} else if (buffer.format == 'f') {
+		for (size_t i = 0; i < buffer.length / sizeof(float); ++i) {
+			float out = (float)(_next(state) >> 40) * (1.0f / 16777216.0f);
+			memcpy(buffer.data + i * sizeof(float), &out, sizeof(out));
+		}
+	} else {
+		_fillBytes(state, buffer.data, buffer.length);
+	}
 	return NONE_VAL();
 }
 
+KRK_Method(Random,__init__) {
+	KrkValue seed = NONE_VAL();
+	if (!krk_parseArgs(".|V", (const char*[]){"seed"}, &seed)) return NONE_VAL();
+	if (IS_NONE(seed)) {
+		_seedFromTime(&self->state);
+		return argv[0];
+	}
+	_random_seed("seed", &self->state, 1, &seed, 0);
+	return argv[0];
+}
+
+#define BIND_RANDOM(name, doc) do { \
+		KRK_DOC(BIND_FUNC(module, name), doc); \
+		KRK_DOC(BIND_METHOD(Random, name), doc); \
+	} while (0)
+
 KrkValue krk_module_onload_random(void) {
 	KrkInstance * module = krk_newInstance(vm.baseClasses->moduleClass);
 	krk_push(OBJECT_VAL(module));
 
-	KRK_DOC(module, "Functions for generating pseudo-random numbers.");
+	KRK_DOC(module, "Functions for generating pseudo-random numbers.\n\n"
+		"The module-level functions use a generator owned by the calling thread. "
+		"Use a @ref Random instance for a stream that can be seeded independently.");
 
-	BIND_FUNC(module, random);
-	BIND_FUNC(module, seed);
+	krk_makeClass(module, &Random, "Random", vm.baseClasses->objectClass);
+	KRK_DOC(Random, "@brief Independent pseudo-random number generator.\n@arguments seed=None");
+	Random->allocSize = sizeof(struct Random);
+	BIND_METHOD(Random,__init__);
 
-	FUNC_NAME(krk,seed)(0,NULL,0);
+	BIND_RANDOM(seed, "@brief Reseed the generator.\n@arguments a=None\n\n"
+		"Ints are used directly and other hashable values by their hash. "
+		"With no argument, seeds from the current time.");
+	BIND_RANDOM(random, "@brief Return a float in [0.0, 1.0).");
+	BIND_RANDOM(uniform, "@brief Return a float between @p a and @p b.\n@arguments a,b");
+	BIND_RANDOM(getrandbits, "@brief Return an int with @p k random bits.\n@arguments k");
+	BIND_RANDOM(randrange, "@brief Return a random item from @c range(start,stop,step).\n@arguments start,stop=None,step=1");
+	BIND_RANDOM(randint, "@brief Return an int in [a, b], including both ends.\n@arguments a,b");
+	BIND_RANDOM(choice, "@brief Return a random element of the non-empty sequence @p seq.\n@arguments seq");
+	BIND_RANDOM(shuffle, "@brief Shuffle the sequence @p x in place.\n@arguments x");
+	BIND_RANDOM(sample, "@brief Return a list of @p k unique elements chosen from @p population.\n@arguments population,k");
+	BIND_RANDOM(gauss, "@brief Return a normally distributed float.\n@arguments mu=0.0,sigma=1.0");
+	BIND_RANDOM(randbytes, "@brief Return @p n random bytes.\n@arguments n");
+	BIND_RANDOM(fill, "@brief Fill a writable buffer with random data.\n@arguments buffer\n\n"
+		"Arrays of @c 'd' or @c 'f' get floats in [0.0, 1.0); anything else gets random bytes.");
+	krk_finalizeClass(Random);
 
 	return krk_pop();
 }
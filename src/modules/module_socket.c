@@ -323,17 +323,38 @@ KRK_Method(socket,recv) {
 	return OBJECT_VAL(out);
 }
 
+KRK_Method(socket,recv_into) {
+	KrkValue target;
+	int nbytes = 0;
+	int flags = 0;
+	if (!krk_parseArgs(".V|ii", (const char*[]){"buffer","nbytes","flags"}, &target, &nbytes, &flags)) return NONE_VAL();
+
+	KrkBuffer buf;
+	if (!krk_getBuffer(target, &buf)) return NONE_VAL();
+	if (buf.readonly) return krk_runtimeError(vm.exceptions->typeError, "recv_into() argument must be read-write");
+	if (nbytes < 0) return krk_runtimeError(vm.exceptions->valueError, "negative buffersize in recv_into");
+	if (nbytes == 0 || (size_t)nbytes > buf.length) nbytes = buf.length;
+
+	ssize_t result = recv(self->sockfd, buf.data, nbytes, flags);
+	if (result < 0) {
+		return krk_runtimeError(SocketError, "Socket error: %s", strerror(errno));
+	}
+
+	return INTEGER_VAL(result);
+}
+
 KRK_Method(socket,send) {
 	METHOD_TAKES_AT_LEAST(1);
 	METHOD_TAKES_AT_MOST(2);
-	CHECK_ARG(1,bytes,KrkBytes*,buf);
+	KrkBuffer buf;
+	if (!krk_getBuffer(argv[1], &buf)) return NONE_VAL();
 	int flags = 0;
 	if (argc > 2) {
 		CHECK_ARG(2,int,krk_integer_type,_flags);
 		flags = _flags;
 	}
 
-	ssize_t result = send(self->sockfd, (void*)buf->bytes, buf->length, flags);
+	ssize_t result = send(self->sockfd, (void*)buf.data, buf.length, flags);
 	if (result < 0) {
 		return krk_runtimeError(SocketError, "Socket error: %s", strerror(errno));
 	}
@@ -344,7 +365,8 @@ KRK_Method(socket,send) {
 KRK_Method(socket,sendto) {
 	METHOD_TAKES_AT_LEAST(1);
 	METHOD_TAKES_AT_MOST(3);
-	CHECK_ARG(1,bytes,KrkBytes*,buf);
+	KrkBuffer buf;
+	if (!krk_getBuffer(argv[1], &buf)) return NONE_VAL();
 	int flags = 0;
 	if (argc > 3) {
 		CHECK_ARG(2,int,krk_integer_type,_flags);
@@ -362,7 +384,7 @@ KRK_Method(socket,sendto) {
 		return NONE_VAL();
 	}
 
-	ssize_t result = sendto(self->sockfd, (void*)buf->bytes, buf->length, flags, (struct sockaddr*)&sock_addr, sock_size);
+	ssize_t result = sendto(self->sockfd, (void*)buf.data, buf.length, flags, (struct sockaddr*)&sock_addr, sock_size);
 	if (result < 0) {
 		return krk_runtimeError(SocketError, "Socket error: %s", strerror(errno));
 	}
@@ -442,15 +464,20 @@ KrkValue krk_module_onload_socket(void) {
 		"@brief Receive data from a connected socket.\n"
 		"@arguments bufsize,[flags]\n\n"
 		"Receive up to @p bufsize bytes of data, which is returned as a @ref bytes object.");
+	KRK_DOC(BIND_METHOD(socket,recv_into),
+		"@brief Receive data from a connected socket into a writable buffer.\n"
+		"@arguments buffer,nbytes=0,flags=0\n\n"
+		"Receive up to @p nbytes bytes, or the size of @p buffer if @p nbytes is 0, without "
+		"allocating a new object. Returns the number of bytes received.");
 	KRK_DOC(BIND_METHOD(socket,send),
 		"@brief Send data to a connected socket.\n"
 		"@arguments buf,[flags]\n\n"
-		"Send the data in the @ref bytes object @p buf to the socket. Returns the number "
+		"Send the data in the bytes-like object @p buf to the socket. Returns the number "
 		"of bytes written to the socket.");
 	KRK_DOC(BIND_METHOD(socket,sendto),
 		"@brief Send data to an socket with a particular destination.\n"
 		"@arguments buf,[flags],addr\n\n"
-		"Send the data in the @ref bytes object @p buf to the socket. Returns the number "
+		"Send the data in the bytes-like object @p buf to the socket. Returns the number "
 		"of bytes written to the socket.");
 	KRK_DOC(BIND_METHOD(socket,fileno),
 		"@brief Get the file descriptor number for the underlying socket.");
@@ -78,7 +78,7 @@ KRK_Method(type,__subclasses__) {
 	KrkValue myList = krk_list_of(0,NULL,0);
 	krk_push(myList);
 
-	for (size_t i = 0; i < self->subclasses.capacity; ++i) {
+	for (size_t i = 0; i < self->subclasses.used; ++i) {
 		KrkTableEntry * entry = &self->subclasses.entries[i];
 		if (IS_KWARGS(entry->key)) continue;
 		krk_writeValueArray(AS_LIST(myList), entry->key);
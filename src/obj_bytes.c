@@ -4,10 +4,7 @@
 #include <kuroko/memory.h>
 #include <kuroko/util.h>
 
-struct ByteArray {
-	KrkInstance inst;
-	KrkValue actual;
-};
+#include "private.h"
 
 #define AS_bytes(o) AS_BYTES(o)
 #define CURRENT_CTYPE KrkBytes *
@@ -36,15 +33,15 @@ KRK_Method(bytes,__init__) {
 	if (argc < 2) return OBJECT_VAL(krk_newBytes(0,NULL));
 	METHOD_TAKES_AT_MOST(1);
 
-	if (IS_bytearray(argv[1])) {
-		return OBJECT_VAL(krk_newBytes(
-			AS_BYTES(AS_bytearray(argv[1])->actual)->length,
-			AS_BYTES(AS_bytearray(argv[1])->actual)->bytes));
+	if (krk_getType(argv[1])->_ongetbuffer) {
+		return krk_bufferToBytes(argv[1]);
 	} else if (IS_STRING(argv[1])) {
 		return OBJECT_VAL(krk_newBytes(AS_STRING(argv[1])->length, (uint8_t*)AS_CSTRING(argv[1])));
 	} else if (IS_INTEGER(argv[1])) {
 		if (AS_INTEGER(argv[1]) < 0) return krk_runtimeError(vm.exceptions->valueError, "negative count");
-		return OBJECT_VAL(krk_newBytes(AS_INTEGER(argv[1]),NULL));
+		KrkBytes * out = krk_newBytes(AS_INTEGER(argv[1]),NULL);
+		memset(out->bytes, 0, out->length);
+		return OBJECT_VAL(out);
 	} else {
 		struct StringBuilder sb = {0};
 		if (krk_unpackIterable(argv[1], &sb, _bytes_callback)) return NONE_VAL();
@@ -55,6 +52,16 @@ KRK_Method(bytes,__init__) {
 #undef IS_bytes
 #define IS_bytes(o) IS_BYTES(o)
 
+static int _bytes_getbuffer(KrkValue value, KrkBuffer * out) {
+	out->owner = value;
+	out->data = AS_BYTES(value)->bytes;
+	out->length = AS_BYTES(value)->length;
+	out->itemsize = 1;
+	out->format = 'B';
+	out->readonly = 1;
+	return 1;
+}
+
 KRK_Method(bytes,__hash__) {
 	METHOD_TAKES_NONE();
 	uint32_t hash = 0;
@@ -158,83 +165,15 @@ KRK_Method(bytes,__len__) {
 	return INTEGER_VAL(AS_BYTES(argv[0])->length);
 }
 
-KRK_Method(bytes,__contains__) {
-	METHOD_TAKES_EXACTLY(1);
-
-	if (IS_BYTES(argv[1])) {
-		return krk_runtimeError(vm.exceptions->notImplementedError, "not implemented: bytes.__contains__(bytes)");
-	}
-
-	if (!IS_INTEGER(argv[1])) {
-		return TYPE_ERROR(int,argv[1]);
-	}
-
-	krk_integer_type val = AS_INTEGER(argv[1]);
-	if (val < 0 || val > 255) {
-		return krk_runtimeError(vm.exceptions->valueError, "byte must be in range(0, 256)");
-	}
-
-	for (size_t i = 0; i < self->length; ++i) {
-		if (self->bytes[i] == val) return BOOLEAN_VAL(1);
-	}
-
-	return BOOLEAN_VAL(0);
-}
-
-KRK_Method(bytes,decode) {
-	METHOD_TAKES_NONE();
-	return OBJECT_VAL(krk_copyString((char*)AS_BYTES(argv[0])->bytes, AS_BYTES(argv[0])->length));
-}
-
-struct _bytes_join_context {
-	struct StringBuilder * sb;
-	KrkBytes * self;
-	int isFirst;
-};
-
-static int _bytes_join_callback(void * context, const KrkValue * values, size_t count) {
-	struct _bytes_join_context * _context = context;
-
-	for (size_t i = 0; i < count; ++i) {
-		if (!IS_BYTES(values[i])) {
-			krk_runtimeError(vm.exceptions->typeError, "%s() expects %s, not '%T'",
-				"join", "bytes", values[i]);
-			return 1;
-		}
-
-		if (_context->isFirst) {
-			_context->isFirst = 0;
-		} else {
-			pushStringBuilderStr(_context->sb, (char*)_context->self->bytes, _context->self->length);
-		}
-		pushStringBuilderStr(_context->sb, (char*)AS_BYTES(values[i])->bytes, AS_BYTES(values[i])->length);
-	}
-
-	return 0;
-}
-
-KRK_Method(bytes,join) {
-	METHOD_TAKES_EXACTLY(1);
-
-	struct StringBuilder sb = {0};
-
-	struct _bytes_join_context context = {&sb, self, 1};
-
-	if (krk_unpackIterable(argv[1], &context, _bytes_join_callback)) {
-		discardStringBuilder(&sb);
-		return NONE_VAL();
-	}
-
-	return finishStringBuilderBytes(&sb);
-}
-
 KRK_Method(bytes,__add__) {
 	METHOD_TAKES_EXACTLY(1);
-	CHECK_ARG(1,bytes,KrkBytes*,them);
+	if (!krk_getType(argv[1])->_ongetbuffer) return NOTIMPL_VAL();
+	KrkBuffer them;
+	if (!krk_getBuffer(argv[1], &them)) return NONE_VAL();
 
 	struct StringBuilder sb = {0};
 	pushStringBuilderStr(&sb, (char*)self->bytes, self->length);
-	pushStringBuilderStr(&sb, (char*)them->bytes, them->length);
+	pushStringBuilderStr(&sb, (char*)them.data, them.length);
 
 	return finishStringBuilderBytes(&sb);
 }
@@ -270,52 +209,152 @@ static void _bytesiterator_gcscan(KrkInstance * self) {
 
 KRK_Method(bytesiterator,__init__) {
 	METHOD_TAKES_EXACTLY(1);
-	CHECK_ARG(1,bytes,KrkBytes*,bytes);
+	if (!IS_BYTES(argv[1]) && !IS_bytearray(argv[1])) return TYPE_ERROR(bytes,argv[1]);
 	self->l = argv[1];
 	self->i = 0;
 	return argv[0];
 }
 
 KRK_Method(bytesiterator,__call__) {
-	KrkValue _list = self->l;
+	KrkBuffer buffer;
 	size_t _counter = self->i;
-	if (!IS_BYTES(_list) || _counter >= AS_BYTES(_list)->length) {
+	if (IS_NONE(self->l) || !krk_getBuffer(self->l, &buffer) || _counter >= buffer.length) {
 		return argv[0];
 	} else {
 		self->i = _counter + 1;
-		return INTEGER_VAL(AS_BYTES(_list)->bytes[_counter]);
+		return INTEGER_VAL(buffer.data[_counter]);
 	}
 }
 
 #undef CURRENT_CTYPE
 #define CURRENT_CTYPE struct ByteArray *
 
-static void _bytearray_gcscan(KrkInstance * self) {
-	krk_markValue(((struct ByteArray*)self)->actual);
+static void _bytearray_gcsweep(KrkInstance * self) {
+	struct ByteArray * me = (struct ByteArray*)self;
+	FREE_ARRAY(uint8_t, me->bytes, me->capacity);
+	me->bytes = NULL;
+	me->length = me->capacity = 0;
 }
 
+static int _bytearray_getbuffer(KrkValue value, KrkBuffer * out) {
+	out->owner = value;
+	out->data = AS_bytearray(value)->bytes;
+	out->length = AS_bytearray(value)->length;
+	out->itemsize = 1;
+	out->format = 'B';
+	out->readonly = 0;
+	return 1;
+}
+
+/* Grow the storage to hold at least @p length bytes, over-allocating so repeated appends are amortized O(1). */
+static void bytearrayReserve(struct ByteArray * self, size_t length) {
+	if (length <= self->capacity) return;
+	size_t capacity = self->capacity < 16 ? 16 : self->capacity + (self->capacity >> 1);
+	if (capacity < length) capacity = length;
+	self->bytes = GROW_ARRAY(uint8_t, self->bytes, self->capacity, capacity);
+	self->capacity = capacity;
+}
+
+/* Replace @p removed bytes at @p start with @p count bytes from @p data, which may be NULL to leave them unset. */
+static void bytearraySplice(struct ByteArray * self, size_t start, size_t removed, const uint8_t * data, size_t count) {
+	if (count > removed) bytearrayReserve(self, self->length - removed + count);
+	if (count != removed) {
+		memmove(self->bytes + start + count, self->bytes + start + removed, self->length - start - removed);
+	}
+	if (data && count) memcpy(self->bytes + start, data, count);
+	self->length = self->length - removed + count;
+}
+
+static KrkValue newByteArray(const uint8_t * data, size_t length) {
+	struct ByteArray * out = (struct ByteArray*)krk_newInstance(vm.baseClasses->bytearrayClass);
+	krk_push(OBJECT_VAL(out));
+	bytearraySplice(out, 0, 0, data, length);
+	return krk_pop();
+}
+
+static int _bytearray_extend_callback(void * context, const KrkValue * values, size_t count) {
+	struct ByteArray * self = context;
+	bytearrayReserve(self, self->length + count);
+	for (size_t i = 0; i < count; ++i) {
+		if (!IS_INTEGER(values[i])) {
+			krk_runtimeError(vm.exceptions->typeError, "'%T' is not an integer", values[i]);
+			return 1;
+		}
+		if (AS_INTEGER(values[i]) < 0 || AS_INTEGER(values[i]) > 255) {
+			krk_runtimeError(vm.exceptions->valueError, "byte must be in range(0, 256)");
+			return 1;
+		}
+		self->bytes[self->length++] = AS_INTEGER(values[i]);
+	}
+	return 0;
+}
+
+/* Append the contents of a bytes-like object, or the integers from an iterable. */
+static int bytearrayExtend(struct ByteArray * self, KrkValue source) {
+	if (krk_getType(source)->_ongetbuffer) {
+		if (krk_isInstanceOf(source, vm.baseClasses->memoryviewClass)) {
+			/* Views may have gaps between their items; gather them first. */
+			source = krk_bufferToBytes(source);
+			if (!IS_BYTES(source)) return 0;
+			krk_push(source);
+		}
+		KrkBuffer buffer;
+		if (!krk_getBuffer(source, &buffer)) return 0;
+		size_t count = buffer.length;
+		bytearrayReserve(self, self->length + count);
+		/* Reserving may have moved our own storage if @p source refers to it. */
+		krk_getBuffer(source, &buffer);
+		if (count) memmove(self->bytes + self->length, buffer.data, count);
+		self->length += count;
+		return 1;
+	}
+	if (IS_STRING(source)) {
+		krk_runtimeError(vm.exceptions->typeError, "expected iterable of ints, not '%T'", source);
+		return 0;
+	}
+	return !krk_unpackIterable(source, self, _bytearray_extend_callback);
+}
+
+static int byteArg(KrkValue value, uint8_t * out) {
+	if (!IS_INTEGER(value)) {
+		krk_runtimeError(vm.exceptions->typeError, "'%T' is not an integer", value);
+		return 0;
+	}
+	if (AS_INTEGER(value) < 0 || AS_INTEGER(value) > 255) {
+		krk_runtimeError(vm.exceptions->valueError, "byte must be in range(0, 256)");
+		return 0;
+	}
+	*out = AS_INTEGER(value);
+	return 1;
+}
+
+#define BYTEARRAY_WRAP_INDEX() \
+	if (index < 0) index += self->length; \
+	if (index < 0 || index >= (krk_integer_type)self->length) \
+		return krk_runtimeError(vm.exceptions->indexError, "bytearray index out of range")
+
 KRK_Method(bytearray,__init__) {
 	METHOD_TAKES_AT_MOST(1);
-	if (argc < 2) {
-		self->actual = OBJECT_VAL(krk_newBytes(0,NULL));
-	} else if (IS_BYTES(argv[1])) {
-		self->actual = OBJECT_VAL(krk_newBytes(AS_BYTES(argv[1])->length, AS_BYTES(argv[1])->bytes));
-	} else if (IS_INTEGER(argv[1])) {
-		self->actual = OBJECT_VAL(krk_newBytes(AS_INTEGER(argv[1]),NULL));
-	} else {
-		return krk_runtimeError(vm.exceptions->valueError, "expected bytes");
+	self->length = 0;
+	if (argc < 2) return argv[0];
+	if (IS_INTEGER(argv[1])) {
+		if (AS_INTEGER(argv[1]) < 0) return krk_runtimeError(vm.exceptions->valueError, "negative count");
+		bytearraySplice(self, 0, 0, NULL, AS_INTEGER(argv[1]));
+		memset(self->bytes, 0, self->length);
+	} else if (IS_STRING(argv[1])) {
+		bytearraySplice(self, 0, 0, (uint8_t*)AS_CSTRING(argv[1]), AS_STRING(argv[1])->length);
+	} else if (!bytearrayExtend(self, argv[1])) {
+		return NONE_VAL();
 	}
 	return argv[0];
 }
 
-#undef IS_bytearray
-#define IS_bytearray(o) (krk_isInstanceOf(o,vm.baseClasses->bytearrayClass) && IS_BYTES(AS_bytearray(o)->actual))
-
-/* bytes objects are not interned; need to do this the old-fashioned way. */
 KRK_Method(bytearray,__eq__) {
-	if (!IS_bytearray(argv[1])) return BOOLEAN_VAL(0);
-	struct ByteArray * them = AS_bytearray(argv[1]);
-	return BOOLEAN_VAL(krk_valuesEqual(self->actual, them->actual));
+	METHOD_TAKES_EXACTLY(1);
+	if (!IS_BYTES(argv[1]) && !IS_bytearray(argv[1])) return NOTIMPL_VAL();
+	KrkBuffer them;
+	krk_getBuffer(argv[1], &them);
+	return BOOLEAN_VAL(them.length == self->length && (!self->length || !memcmp(self->bytes, them.data, self->length)));
 }
 
 KRK_Method(bytearray,__repr__) {
@@ -323,7 +362,7 @@ KRK_Method(bytearray,__repr__) {
 	struct StringBuilder sb = {0};
 	pushStringBuilderStr(&sb, "bytearray(", 10);
 
-	krk_push(self->actual);
+	krk_push(OBJECT_VAL(krk_newBytes(self->length, self->bytes)));
 	KrkValue repred_bytes = krk_callDirect(vm.baseClasses->bytesClass->_reprer, 1);
 	if (!IS_STRING(repred_bytes)) {
 		/* Invalid repr of bytes? */
@@ -339,32 +378,27 @@ KRK_Method(bytearray,__getitem__) {
 	METHOD_TAKES_EXACTLY(1);
 
 	if (IS_INTEGER(argv[1])) {
-		CHECK_ARG(1,int,krk_integer_type,asInt);
-
-		if (asInt < 0) asInt += (long)AS_BYTES(self->actual)->length;
-		if (asInt < 0 || asInt >= (long)AS_BYTES(self->actual)->length) {
-			return krk_runtimeError(vm.exceptions->indexError, "bytearray index out of range: %d", (int)asInt);
-		}
-
-		return INTEGER_VAL(AS_BYTES(self->actual)->bytes[asInt]);
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		BYTEARRAY_WRAP_INDEX();
+		return INTEGER_VAL(self->bytes[index]);
 	} else if (IS_slice(argv[1])) {
-		KRK_SLICER(argv[1],AS_BYTES(self->actual)->length) {
+		KRK_SLICER(argv[1],self->length) {
 			return NONE_VAL();
 		}
 
 		if (step == 1) {
-			krk_integer_type len = end - start;
-			return OBJECT_VAL(krk_newBytes(len, &AS_BYTES(self->actual)->bytes[start]));
+			return newByteArray(self->bytes + start, end > start ? end - start : 0);
 		} else {
 			struct StringBuilder sb = {0};
 			krk_integer_type i = start;
 			while ((step < 0) ? (i > end) : (i < end)) {
-				pushStringBuilder(&sb, AS_BYTES(self->actual)->bytes[i]);
+				pushStringBuilder(&sb, self->bytes[i]);
 				i += step;
 			}
-			return finishStringBuilderBytes(&sb);
+			KrkValue out = newByteArray((uint8_t*)sb.bytes, sb.length);
+			discardStringBuilder(&sb);
+			return out;
 		}
-
 	} else {
 		return TYPE_ERROR(int or slice, argv[1]);
 	}
@@ -372,34 +406,174 @@ KRK_Method(bytearray,__getitem__) {
 
 KRK_Method(bytearray,__setitem__) {
 	METHOD_TAKES_EXACTLY(2);
-	CHECK_ARG(1,int,krk_integer_type,asInt);
-	CHECK_ARG(2,int,krk_integer_type,val);
 
-	if (asInt < 0) asInt += (long)AS_BYTES(self->actual)->length;
-	if (asInt < 0 || asInt >= (long)AS_BYTES(self->actual)->length) {
-		return krk_runtimeError(vm.exceptions->indexError, "bytearray index out of range: %d", (int)asInt);
+	if (IS_INTEGER(argv[1])) {
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		uint8_t val;
+		if (!byteArg(argv[2], &val)) return NONE_VAL();
+		BYTEARRAY_WRAP_INDEX();
+		self->bytes[index] = val;
+		return INTEGER_VAL(self->bytes[index]);
+	} else if (IS_slice(argv[1])) {
+		/* Collect the new contents first; they may be a view of ourselves, or arbitrary iterable code. */
+		struct ByteArray * source = (struct ByteArray*)AS_OBJECT(newByteArray(NULL, 0));
+		krk_push(OBJECT_VAL(source));
+		if (IS_INTEGER(argv[2])) return TYPE_ERROR(bytes-like object or iterable of ints, argv[2]);
+		if (!bytearrayExtend(source, argv[2])) return NONE_VAL();
+
+		KRK_SLICER(argv[1],self->length) {
+			return NONE_VAL();
+		}
+
+		if (step == 1) {
+			bytearraySplice(self, start, end > start ? end - start : 0, source->bytes, source->length);
+			return argv[2];
+		}
+
+		size_t count = 0;
+		for (krk_integer_type i = start; (step < 0) ? (i > end) : (i < end); i += step) count++;
+		if (count != source->length) {
+			return krk_runtimeError(vm.exceptions->valueError, "attempt to assign bytes of size %zu to extended slice of size %zu",
+				source->length, count);
+		}
+		count = 0;
+		for (krk_integer_type i = start; (step < 0) ? (i > end) : (i < end); i += step) {
+			self->bytes[i] = source->bytes[count++];
+		}
+		return argv[2];
+	} else {
+		return TYPE_ERROR(int or slice, argv[1]);
 	}
-	AS_BYTES(self->actual)->bytes[asInt] = val;
+}
 
-	return INTEGER_VAL(AS_BYTES(self->actual)->bytes[asInt]);
+KRK_Method(bytearray,__delitem__) {
+	METHOD_TAKES_EXACTLY(1);
+
+	if (IS_INTEGER(argv[1])) {
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		BYTEARRAY_WRAP_INDEX();
+		bytearraySplice(self, index, 1, NULL, 0);
+	} else if (IS_slice(argv[1])) {
+		KRK_SLICER(argv[1],self->length) {
+			return NONE_VAL();
+		}
+
+		if (step == 1) {
+			if (end > start) bytearraySplice(self, start, end - start, NULL, 0);
+			return NONE_VAL();
+		}
+
+		/* Normalize to walk forwards, then compact the survivors in a single pass. */
+		if (step < 0) {
+			if (start <= end) return NONE_VAL();
+			krk_integer_type count = (start - end - step - 1) / -step;
+			start = start + (count - 1) * step;
+			step = -step;
+			end = start + count * step;
+		}
+		size_t out = start;
+		for (krk_integer_type i = start; i < (krk_integer_type)self->length; ++i) {
+			if (i < end && (i - start) % step == 0) continue;
+			self->bytes[out++] = self->bytes[i];
+		}
+		self->length = out;
+	} else {
+		return TYPE_ERROR(int or slice, argv[1]);
+	}
+	return NONE_VAL();
 }
 
 KRK_Method(bytearray,__len__) {
-	return INTEGER_VAL(AS_BYTES(self->actual)->length);
+	METHOD_TAKES_NONE();
+	return INTEGER_VAL(self->length);
+}
+
+KRK_Method(bytearray,append) {
+	METHOD_TAKES_EXACTLY(1);
+	uint8_t value;
+	if (!byteArg(argv[1], &value)) return NONE_VAL();
+	bytearrayReserve(self, self->length + 1);
+	self->bytes[self->length++] = value;
+	return NONE_VAL();
+}
+
+KRK_Method(bytearray,extend) {
+	METHOD_TAKES_EXACTLY(1);
+	bytearrayExtend(self, argv[1]);
+	return NONE_VAL();
+}
+
+KRK_Method(bytearray,__iadd__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (!krk_getType(argv[1])->_ongetbuffer) return NOTIMPL_VAL();
+	if (!bytearrayExtend(self, argv[1])) return NONE_VAL();
+	return argv[0];
 }
 
-KRK_Method(bytearray,__contains__) {
+KRK_Method(bytearray,__add__) {
 	METHOD_TAKES_EXACTLY(1);
-	CHECK_ARG(1,int,krk_integer_type,val);
-	for (size_t i = 0; i < AS_BYTES(self->actual)->length; ++i) {
-		if (AS_BYTES(self->actual)->bytes[i] == val) return BOOLEAN_VAL(1);
+	if (!krk_getType(argv[1])->_ongetbuffer) return NOTIMPL_VAL();
+	struct ByteArray * out = (struct ByteArray*)AS_OBJECT(newByteArray(self->bytes, self->length));
+	krk_push(OBJECT_VAL(out));
+	if (!bytearrayExtend(out, argv[1])) return NONE_VAL();
+	return krk_pop();
+}
+
+KRK_Method(bytearray,insert) {
+	METHOD_TAKES_EXACTLY(2);
+	CHECK_ARG(1,int,krk_integer_type,index);
+	uint8_t value;
+	if (!byteArg(argv[2], &value)) return NONE_VAL();
+	if (index < 0) index += self->length;
+	if (index < 0) index = 0;
+	if (index > (krk_integer_type)self->length) index = self->length;
+	bytearraySplice(self, index, 0, &value, 1);
+	return NONE_VAL();
+}
+
+KRK_Method(bytearray,pop) {
+	METHOD_TAKES_AT_MOST(1);
+	krk_integer_type index = -1;
+	if (argc > 1) {
+		CHECK_ARG(1,int,krk_integer_type,_index);
+		index = _index;
 	}
-	return BOOLEAN_VAL(0);
+	if (!self->length) return krk_runtimeError(vm.exceptions->indexError, "pop from empty bytearray");
+	BYTEARRAY_WRAP_INDEX();
+	uint8_t value = self->bytes[index];
+	bytearraySplice(self, index, 1, NULL, 0);
+	return INTEGER_VAL(value);
 }
 
-KRK_Method(bytearray,decode) {
+KRK_Method(bytearray,remove) {
+	METHOD_TAKES_EXACTLY(1);
+	uint8_t value;
+	if (!byteArg(argv[1], &value)) return NONE_VAL();
+	uint8_t * found = self->length ? memchr(self->bytes, value, self->length) : NULL;
+	if (!found) return krk_runtimeError(vm.exceptions->valueError, "value not found in bytearray");
+	bytearraySplice(self, found - self->bytes, 1, NULL, 0);
+	return NONE_VAL();
+}
+
+KRK_Method(bytearray,clear) {
+	METHOD_TAKES_NONE();
+	self->length = 0;
+	return NONE_VAL();
+}
+
+KRK_Method(bytearray,copy) {
 	METHOD_TAKES_NONE();
-	return OBJECT_VAL(krk_copyString((char*)AS_BYTES(self->actual)->bytes, AS_BYTES(self->actual)->length));
+	return newByteArray(self->bytes, self->length);
+}
+
+KRK_Method(bytearray,reverse) {
+	METHOD_TAKES_NONE();
+	for (size_t i = 0; i < self->length / 2; ++i) {
+		uint8_t tmp = self->bytes[i];
+		self->bytes[i] = self->bytes[self->length - i - 1];
+		self->bytes[self->length - i - 1] = tmp;
+	}
+	return NONE_VAL();
 }
 
 KRK_Method(bytearray,__iter__) {
@@ -407,17 +581,331 @@ KRK_Method(bytearray,__iter__) {
 	KrkInstance * output = krk_newInstance(vm.baseClasses->bytesiteratorClass);
 
 	krk_push(OBJECT_VAL(output));
-	FUNC_NAME(bytesiterator,__init__)(2, (KrkValue[]){krk_peek(0), self->actual},0);
+	FUNC_NAME(bytesiterator,__init__)(2, (KrkValue[]){krk_peek(0), argv[0]},0);
 	krk_pop();
 
 	return OBJECT_VAL(output);
 }
 
+#undef BYTEARRAY_WRAP_INDEX
+
+/*
+ * Methods below are bound on both bytes and bytearray, and return
+ * objects of the same type as the one they were called on.
+ */
+#undef CURRENT_CTYPE
+#define CURRENT_CTYPE KrkValue
+#define IS_byteslike(o) (IS_BYTES(o) || IS_bytearray(o))
+#define AS_byteslike(o) (o)
+
+static uint8_t * bytesData(KrkValue value, size_t * length) {
+	if (IS_BYTES(value)) {
+		*length = AS_BYTES(value)->length;
+		return AS_BYTES(value)->bytes;
+	}
+	*length = AS_bytearray(value)->length;
+	return AS_bytearray(value)->bytes;
+}
+
+static KrkValue bytesLike(KrkValue self, const uint8_t * data, size_t length) {
+	if (IS_BYTES(self)) return OBJECT_VAL(krk_newBytes(length, (uint8_t*)data));
+	return newByteArray(data, length);
+}
+
+static KrkValue finishBytesLike(KrkValue self, struct StringBuilder * sb) {
+	if (IS_BYTES(self)) return finishStringBuilderBytes(sb);
+	KrkValue out = newByteArray((uint8_t*)sb->bytes, sb->length);
+	discardStringBuilder(sb);
+	return out;
+}
+
+/* Arguments shared by find, rfind, index, count, startswith and endswith. */
+struct BytesSearch {
+	uint8_t * data;
+	krk_integer_type start;
+	krk_integer_type end;
+	uint8_t * sub;
+	size_t subLength;
+	uint8_t byte;
+};
+
+#define WRAP_INDEX(index) \
+	if (index < 0) index += length; \
+	if (index < 0) index = 0; \
+	if (index >= (krk_integer_type)length) index = length
+
+static int searchArgs(const char * _method_name, int argc, const KrkValue argv[], int hasKw, struct BytesSearch * args) {
+	KrkValue sub, start = NONE_VAL(), end = NONE_VAL();
+	if (!krk_parseArgs(".V|VV", (const char*[]){"sub","start","end"}, &sub, &start, &end)) return 0;
+	size_t length;
+	args->data = bytesData(argv[0], &length);
+	if (IS_INTEGER(sub)) {
+		if (!byteArg(sub, &args->byte)) return 0;
+		args->sub = &args->byte;
+		args->subLength = 1;
+	} else {
+		KrkBuffer buffer;
+		if (!krk_getBuffer(sub, &buffer)) return 0;
+		args->sub = buffer.data;
+		args->subLength = buffer.length;
+	}
+	args->start = 0;
+	args->end = length;
+	if (!IS_NONE(start)) {
+		if (!IS_INTEGER(start)) { TYPE_ERROR(int,start); return 0; }
+		args->start = AS_INTEGER(start);
+		WRAP_INDEX(args->start);
+	}
+	if (!IS_NONE(end)) {
+		if (!IS_INTEGER(end)) { TYPE_ERROR(int,end); return 0; }
+		args->end = AS_INTEGER(end);
+		WRAP_INDEX(args->end);
+	}
+	return 1;
+}
+
+#undef WRAP_INDEX
+
+static krk_integer_type searchForward(struct BytesSearch * args) {
+	if (args->start > args->end || (size_t)(args->end - args->start) < args->subLength) return -1;
+	const char * match = krk_memmem((char*)args->data + args->start, args->end - args->start, (char*)args->sub, args->subLength);
+	return match ? match - (char*)args->data : -1;
+}
+
+static krk_integer_type searchBackward(struct BytesSearch * args) {
+	if (args->start > args->end || (size_t)(args->end - args->start) < args->subLength) return -1;
+	for (krk_integer_type i = args->end - args->subLength; i >= args->start; --i) {
+		if (!memcmp(args->data + i, args->sub, args->subLength)) return i;
+	}
+	return -1;
+}
+
+KRK_Method(byteslike,find) {
+	struct BytesSearch args;
+	if (!searchArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	return INTEGER_VAL(searchForward(&args));
+}
+
+KRK_Method(byteslike,rfind) {
+	struct BytesSearch args;
+	if (!searchArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	return INTEGER_VAL(searchBackward(&args));
+}
+
+KRK_Method(byteslike,index) {
+	struct BytesSearch args;
+	if (!searchArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	krk_integer_type found = searchForward(&args);
+	if (found < 0) return krk_runtimeError(vm.exceptions->valueError, "subsection not found");
+	return INTEGER_VAL(found);
+}
+
+KRK_Method(byteslike,count) {
+	struct BytesSearch args;
+	if (!searchArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	if (args.start > args.end) return INTEGER_VAL(0);
+	if (args.subLength == 0) return INTEGER_VAL(args.end - args.start + 1);
+	krk_integer_type found = 0;
+	krk_integer_type match;
+	while ((match = searchForward(&args)) >= 0) {
+		found++;
+		args.start = match + args.subLength;
+	}
+	return INTEGER_VAL(found);
+}
+
+KRK_Method(byteslike,startswith) {
+	struct BytesSearch args;
+	if (!searchArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	if (args.start > args.end || (size_t)(args.end - args.start) < args.subLength) return BOOLEAN_VAL(0);
+	return BOOLEAN_VAL(!memcmp(args.data + args.start, args.sub, args.subLength));
+}
+
+KRK_Method(byteslike,endswith) {
+	struct BytesSearch args;
+	if (!searchArgs(_method_name, argc, argv, hasKw, &args)) return NONE_VAL();
+	if (args.start > args.end || (size_t)(args.end - args.start) < args.subLength) return BOOLEAN_VAL(0);
+	return BOOLEAN_VAL(!memcmp(args.data + args.end - args.subLength, args.sub, args.subLength));
+}
+
+KRK_Method(byteslike,__contains__) {
+	METHOD_TAKES_EXACTLY(1);
+	size_t length;
+	uint8_t * data = bytesData(self, &length);
+
+	if (IS_INTEGER(argv[1])) {
+		uint8_t value;
+		if (!byteArg(argv[1], &value)) return NONE_VAL();
+		return BOOLEAN_VAL(length && memchr(data, value, length) != NULL);
+	}
+
+	KrkBuffer sub;
+	if (!krk_getBuffer(argv[1], &sub)) return NONE_VAL();
+	return BOOLEAN_VAL(krk_memmem((char*)data, length, (char*)sub.data, sub.length) != NULL);
+}
+
+static int isSpace(uint8_t c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+KRK_Method(byteslike,split) {
+	KrkValue sep = NONE_VAL();
+	int maxsplit = -1;
+	if (!krk_parseArgs(".|Vi", (const char*[]){"sep","maxsplit"}, &sep, &maxsplit)) return NONE_VAL();
+
+	KrkBuffer separator = {0};
+	if (!IS_NONE(sep)) {
+		if (!krk_getBuffer(sep, &separator)) return NONE_VAL();
+		if (!separator.length) return krk_runtimeError(vm.exceptions->valueError, "empty separator");
+	}
+
+	KrkValue list = krk_list_of(0, NULL, 0);
+	krk_push(list);
+
+	size_t length;
+	uint8_t * data = bytesData(self, &length);
+	size_t i = 0;
+	int splits = 0;
+
+	if (IS_NONE(sep)) {
+		while (1) {
+			while (i < length && isSpace(data[i])) i++;
+			if (i == length) break;
+			size_t start = i;
+			if (maxsplit >= 0 && splits == maxsplit) {
+				i = length;
+			} else {
+				while (i < length && !isSpace(data[i])) i++;
+			}
+			krk_writeValueArray(AS_LIST(list), bytesLike(self, data + start, i - start));
+			/* Creating the piece may allocate a new bytearray, but never moves ours. */
+			splits++;
+		}
+	} else {
+		while (1) {
+			const char * match = (maxsplit >= 0 && splits == maxsplit) ? NULL :
+				krk_memmem((char*)data + i, length - i, (char*)separator.data, separator.length);
+			size_t end = match ? (size_t)((uint8_t*)match - data) : length;
+			krk_writeValueArray(AS_LIST(list), bytesLike(self, data + i, end - i));
+			if (!match) break;
+			i = end + separator.length;
+			splits++;
+		}
+	}
+
+	return krk_pop();
+}
+
+KRK_Method(byteslike,replace) {
+	KrkValue oldValue, newValue;
+	int count = -1;
+	if (!krk_parseArgs(".VV|i", (const char*[]){"old","new","count"}, &oldValue, &newValue, &count)) return NONE_VAL();
+
+	KrkBuffer old, new;
+	if (!krk_getBuffer(oldValue, &old) || !krk_getBuffer(newValue, &new)) return NONE_VAL();
+
+	size_t length;
+	uint8_t * data = bytesData(self, &length);
+	struct StringBuilder sb = {0};
+	size_t i = 0;
+
+	if (!old.length) {
+		/* An empty pattern matches before every byte and at the end. */
+		for (; i <= length; ++i) {
+			if (count >= 0 && (size_t)count <= i) break;
+			pushStringBuilderStr(&sb, (char*)new.data, new.length);
+			if (i < length) pushStringBuilder(&sb, data[i]);
+		}
+		if (i < length) pushStringBuilderStr(&sb, (char*)data + i, length - i);
+		return finishBytesLike(self, &sb);
+	}
+
+	while (count != 0) {
+		const char * match = krk_memmem((char*)data + i, length - i, (char*)old.data, old.length);
+		if (!match) break;
+		size_t at = (uint8_t*)match - data;
+		pushStringBuilderStr(&sb, (char*)data + i, at - i);
+		pushStringBuilderStr(&sb, (char*)new.data, new.length);
+		i = at + old.length;
+		if (count > 0) count--;
+	}
+	pushStringBuilderStr(&sb, (char*)data + i, length - i);
+	return finishBytesLike(self, &sb);
+}
+
+KRK_Method(byteslike,decode) {
+	METHOD_TAKES_NONE();
+	size_t length;
+	uint8_t * data = bytesData(self, &length);
+	return OBJECT_VAL(krk_copyString((char*)data, length));
+}
+
+struct _bytes_join_context {
+	struct StringBuilder * sb;
+	KrkValue self;
+	int isFirst;
+};
+
+static int _bytes_join_callback(void * context, const KrkValue * values, size_t count) {
+	struct _bytes_join_context * _context = context;
+
+	for (size_t i = 0; i < count; ++i) {
+		KrkBuffer buffer;
+		if (!krk_getType(values[i])->_ongetbuffer) {
+			krk_runtimeError(vm.exceptions->typeError, "%s() expects %s, not '%T'",
+				"join", "bytes-like object", values[i]);
+			return 1;
+		}
+		if (!krk_getBuffer(values[i], &buffer)) return 1;
+
+		if (_context->isFirst) {
+			_context->isFirst = 0;
+		} else {
+			size_t length;
+			uint8_t * data = bytesData(_context->self, &length);
+			pushStringBuilderStr(_context->sb, (char*)data, length);
+		}
+		pushStringBuilderStr(_context->sb, (char*)buffer.data, buffer.length);
+	}
+
+	return 0;
+}
+
+KRK_Method(byteslike,join) {
+	METHOD_TAKES_EXACTLY(1);
+
+	struct StringBuilder sb = {0};
+
+	struct _bytes_join_context context = {&sb, self, 1};
+
+	if (krk_unpackIterable(argv[1], &context, _bytes_join_callback)) {
+		discardStringBuilder(&sb);
+		return NONE_VAL();
+	}
+
+	return finishBytesLike(self, &sb);
+}
+
+KRK_Method(byteslike,hex) {
+	METHOD_TAKES_NONE();
+	static const char digits[] = "0123456789abcdef";
+	size_t length;
+	uint8_t * data = bytesData(self, &length);
+	struct StringBuilder sb = {0};
+	for (size_t i = 0; i < length; ++i) {
+		pushStringBuilder(&sb, digits[data[i] >> 4]);
+		pushStringBuilder(&sb, digits[data[i] & 0xF]);
+	}
+	return finishStringBuilder(&sb);
+}
+
+#define BIND_BYTESLIKE(klass,method) krk_defineNative(&klass->methods, #method, FUNC_NAME(byteslike,method))
 
 _noexport
 void _createAndBind_bytesClass(void) {
 	KrkClass * bytes = ADD_BASE_CLASS(vm.baseClasses->bytesClass, "bytes", vm.baseClasses->objectClass);
 	bytes->obj.flags |= KRK_OBJ_FLAGS_NO_INHERIT;
+	bytes->_ongetbuffer = _bytes_getbuffer;
 	KRK_DOC(BIND_METHOD(bytes,__init__),
 		"@brief An array of bytes.\n"
 		"@arguments iter=None\n\n"
@@ -425,14 +913,23 @@ void _createAndBind_bytesClass(void) {
 		"of integers within the range @c 0 and @c 255.");
 	BIND_METHOD(bytes,__repr__);
 	BIND_METHOD(bytes,__len__);
-	BIND_METHOD(bytes,__contains__);
 	BIND_METHOD(bytes,__getitem__);
 	BIND_METHOD(bytes,__eq__);
 	BIND_METHOD(bytes,__add__);
 	BIND_METHOD(bytes,__iter__);
 	BIND_METHOD(bytes,__hash__);
-	BIND_METHOD(bytes,decode);
-	BIND_METHOD(bytes,join);
+	BIND_BYTESLIKE(bytes,__contains__);
+	BIND_BYTESLIKE(bytes,find);
+	BIND_BYTESLIKE(bytes,rfind);
+	BIND_BYTESLIKE(bytes,index);
+	BIND_BYTESLIKE(bytes,count);
+	BIND_BYTESLIKE(bytes,startswith);
+	BIND_BYTESLIKE(bytes,endswith);
+	BIND_BYTESLIKE(bytes,split);
+	BIND_BYTESLIKE(bytes,replace);
+	BIND_BYTESLIKE(bytes,decode);
+	BIND_BYTESLIKE(bytes,join);
+	BIND_BYTESLIKE(bytes,hex);
 	krk_defineNative(&bytes->methods,"__str__",FUNC_NAME(bytes,__repr__)); /* alias */
 	krk_finalizeClass(bytes);
 
@@ -446,18 +943,44 @@ void _createAndBind_bytesClass(void) {
 
 	KrkClass * bytearray = ADD_BASE_CLASS(vm.baseClasses->bytearrayClass, "bytearray", vm.baseClasses->objectClass);
 	bytearray->allocSize = sizeof(struct ByteArray);
-	bytearray->_ongcscan = _bytearray_gcscan;
+	bytearray->_ongcsweep = _bytearray_gcsweep;
+	bytearray->_ongetbuffer = _bytearray_getbuffer;
 	KRK_DOC(BIND_METHOD(bytearray,__init__),
-		"@brief A mutable array of bytes.\n"
-		"@arguments bytes=None");
+		"@brief A mutable, growable array of bytes.\n"
+		"@arguments source=None\n\n"
+		"@p source may be a length, a @ref str, any object that exports a buffer, such as "
+		"@ref bytes or @ref memoryview, or an iterable of integers in the range @c 0 to @c 255.");
 	BIND_METHOD(bytearray,__repr__);
 	BIND_METHOD(bytearray,__len__);
-	BIND_METHOD(bytearray,__contains__);
 	BIND_METHOD(bytearray,__getitem__);
 	BIND_METHOD(bytearray,__setitem__);
+	BIND_METHOD(bytearray,__delitem__);
 	BIND_METHOD(bytearray,__eq__);
+	BIND_METHOD(bytearray,__add__);
+	BIND_METHOD(bytearray,__iadd__);
 	BIND_METHOD(bytearray,__iter__);
-	BIND_METHOD(bytearray,decode);
+	KRK_DOC(BIND_METHOD(bytearray,append), "@brief Add the byte @p x to the end.\n@arguments x");
+	KRK_DOC(BIND_METHOD(bytearray,extend), "@brief Append the contents of a bytes-like object, or the integers from an iterable.\n"
+		"@arguments iterable\n\n"
+		"Storage grows geometrically, so building a bytearray by repeated appends takes linear time.");
+	KRK_DOC(BIND_METHOD(bytearray,insert), "@brief Insert the byte @p x before position @p i.\n@arguments i,x");
+	KRK_DOC(BIND_METHOD(bytearray,pop), "@brief Remove and return the byte at @p i.\n@arguments i=-1");
+	KRK_DOC(BIND_METHOD(bytearray,remove), "@brief Remove the first occurrence of the byte @p x.\n@arguments x");
+	KRK_DOC(BIND_METHOD(bytearray,clear), "@brief Remove all bytes.");
+	KRK_DOC(BIND_METHOD(bytearray,copy), "@brief Return a new bytearray with the same contents.");
+	KRK_DOC(BIND_METHOD(bytearray,reverse), "@brief Reverse the bytes in place.");
+	BIND_BYTESLIKE(bytearray,__contains__);
+	BIND_BYTESLIKE(bytearray,find);
+	BIND_BYTESLIKE(bytearray,rfind);
+	BIND_BYTESLIKE(bytearray,index);
+	BIND_BYTESLIKE(bytearray,count);
+	BIND_BYTESLIKE(bytearray,startswith);
+	BIND_BYTESLIKE(bytearray,endswith);
+	BIND_BYTESLIKE(bytearray,split);
+	BIND_BYTESLIKE(bytearray,replace);
+	BIND_BYTESLIKE(bytearray,decode);
+	BIND_BYTESLIKE(bytearray,join);
+	BIND_BYTESLIKE(bytearray,hex);
 	krk_defineNative(&bytearray->methods,"__str__",FUNC_NAME(bytearray,__repr__)); /* alias */
 	krk_finalizeClass(bytearray);
 }
@@ -5,6 +5,8 @@
 #include <kuroko/util.h>
 #include <kuroko/threads.h>
 
+#include "private.h"
+
 #define LIST_WRAP_INDEX() \
 	if (index < 0) index += self->values.count; \
 	if (unlikely(index < 0 || index >= (krk_integer_type)self->values.count)) return krk_runtimeError(vm.exceptions->indexError, "list index out of range: %zd", (ssize_t)index)
@@ -428,29 +430,569 @@ KRK_Method(list,reverse) {
 	return NONE_VAL();
 }
 
-static int _list_sorter(const void * _a, const void * _b) {
-	KrkValue a = *(KrkValue*)_a;
-	KrkValue b = *(KrkValue*)_b;
+/*
+ * list.sort() is a Timsort: natural runs are found (and extended to a
+ * minimum length with binary insertion sort), then merged with galloping
+ * so that partially ordered input needs far fewer comparisons. The sort
+ * is stable. With key=, keys are computed once and the list's values are
+ * moved alongside them.
+ */
+#define MIN_GALLOP 7
+#define MAX_RUNS   85
+
+typedef int (*SortLessThan)(KrkValue, KrkValue);
 
-	/* Avoid actually calling the sort function if there's an active exception */
-	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return -1;
-	KrkValue ltComp = krk_operator_lt(a,b);
-	if (IS_NONE(ltComp) || (IS_BOOLEAN(ltComp) && AS_BOOLEAN(ltComp))) return -1;
-	KrkValue gtComp = krk_operator_gt(a,b);
-	if (IS_NONE(gtComp) || (IS_BOOLEAN(gtComp) && AS_BOOLEAN(gtComp))) return 1;
-	return 0;
+/* A position in the keys array and, when sorting with key=, the matching position in the values. */
+typedef struct {
+	KrkValue * keys;
+	KrkValue * values;
+} SortSlice;
+
+struct SortRun {
+	SortSlice base;
+	size_t len;
+};
+
+struct SortState {
+	SortLessThan lt;
+	size_t minGallop;
+	SortSlice tmp;
+	int runCount;
+	struct SortRun runs[MAX_RUNS];
+};
+
+static inline void sliceCopy(SortSlice * dst, ssize_t i, SortSlice * src, ssize_t j) {
+	dst->keys[i] = src->keys[j];
+	if (dst->values) dst->values[i] = src->values[j];
 }
 
-KRK_Method(list,sort) {
-	METHOD_TAKES_NONE();
+static inline void sliceCopyIncr(SortSlice * dst, SortSlice * src) {
+	*dst->keys++ = *src->keys++;
+	if (dst->values) *dst->values++ = *src->values++;
+}
+
+static inline void sliceCopyDecr(SortSlice * dst, SortSlice * src) {
+	*dst->keys-- = *src->keys--;
+	if (dst->values) *dst->values-- = *src->values--;
+}
+
+static inline void sliceMove(SortSlice * dst, ssize_t i, SortSlice * src, ssize_t j, size_t n) {
+	memmove(&dst->keys[i], &src->keys[j], sizeof(KrkValue) * n);
+	if (dst->values) memmove(&dst->values[i], &src->values[j], sizeof(KrkValue) * n);
+}
+
+static inline void sliceAdvance(SortSlice * slice, ssize_t n) {
+	slice->keys += n;
+	if (slice->values) slice->values += n;
+}
+
+static int sortLessGeneric(KrkValue a, KrkValue b) {
+	/* Once a comparison has raised, finish the sort quickly without calling anything else */
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 0;
+	return !krk_isFalsey(krk_operator_lt(a,b));
+}
+
+static int sortLessInt(KrkValue a, KrkValue b) {
+	return AS_INTEGER(a) < AS_INTEGER(b);
+}
+
+static int sortLessFloat(KrkValue a, KrkValue b) {
+	return AS_FLOATING(a) < AS_FLOATING(b);
+}
+
+static int sortLessStr(KrkValue a, KrkValue b) {
+	size_t aLen = AS_STRING(a)->length;
+	size_t bLen = AS_STRING(b)->length;
+	int cmp = memcmp(AS_CSTRING(a), AS_CSTRING(b), aLen < bLen ? aLen : bLen);
+	return cmp < 0 || (cmp == 0 && aLen < bLen);
+}
+
+/* Pick a comparison that skips method dispatch when every key has the same builtin type. */
+static SortLessThan sortComparator(KrkValue * keys, size_t n) {
+	size_t i;
+	for (i = 0; i < n && IS_INTEGER(keys[i]); ++i);
+	if (i == n) return sortLessInt;
+	for (i = 0; i < n && IS_FLOATING(keys[i]); ++i);
+	if (i == n) return sortLessFloat;
+	for (i = 0; i < n && IS_STRING(keys[i]); ++i);
+	if (i == n) return sortLessStr;
+	return sortLessGeneric;
+}
+
+static void reverseSlice(KrkValue * values, size_t n) {
+	for (size_t i = 0; i < n / 2; ++i) {
+		KrkValue tmp = values[i];
+		values[i] = values[n-i-1];
+		values[n-i-1] = tmp;
+	}
+}
+
+/* Sort lo[0:n] with binary insertion sort, given that lo[0:start] is already sorted. */
+static void binaryInsertionSort(struct SortState * state, SortSlice lo, size_t n, size_t start) {
+	for (size_t i = start; i < n; ++i) {
+		KrkValue pivot = lo.keys[i];
+		KrkValue pivotValue = lo.values ? lo.values[i] : NONE_VAL();
+		size_t l = 0, r = i;
+		while (l < r) {
+			size_t m = l + ((r - l) >> 1);
+			if (state->lt(pivot, lo.keys[m])) r = m;
+			else l = m + 1;
+		}
+		sliceMove(&lo, l + 1, &lo, l, i - l);
+		lo.keys[l] = pivot;
+		if (lo.values) lo.values[l] = pivotValue;
+	}
+}
+
+/*
+ * Length of the run at the start of lo[0:n]. Strictly descending runs are
+ * reversed in place; requiring strictness keeps the sort stable.
+ */
+static size_t countRun(struct SortState * state, SortSlice lo, size_t n) {
+	if (n == 1) return 1;
+	size_t len = 2;
+	if (state->lt(lo.keys[1], lo.keys[0])) {
+		while (len < n && state->lt(lo.keys[len], lo.keys[len-1])) len++;
+		reverseSlice(lo.keys, len);
+		if (lo.values) reverseSlice(lo.values, len);
+	} else {
+		while (len < n && !state->lt(lo.keys[len], lo.keys[len-1])) len++;
+	}
+	return len;
+}
+
+/*
+ * Locate where @p key belongs in the sorted a[0:n], starting the search at
+ * a[hint]. Returns k with a[k-1] < key <= a[k], ie. the leftmost position.
+ */
+static ssize_t gallopLeft(struct SortState * state, KrkValue key, KrkValue * a, ssize_t n, ssize_t hint) {
+	ssize_t lastofs = 0, ofs = 1;
+	a += hint;
+	if (state->lt(*a, key)) {
+		/* a[hint] < key: gallop right until a[hint+lastofs] < key <= a[hint+ofs] */
+		ssize_t maxofs = n - hint;
+		while (ofs < maxofs && state->lt(a[ofs], key)) {
+			lastofs = ofs;
+			ofs = (ofs << 1) + 1;
+		}
+		if (ofs > maxofs) ofs = maxofs;
+		lastofs += hint;
+		ofs += hint;
+	} else {
+		/* key <= a[hint]: gallop left until a[hint-ofs] < key <= a[hint-lastofs] */
+		ssize_t maxofs = hint + 1;
+		while (ofs < maxofs && !state->lt(*(a-ofs), key)) {
+			lastofs = ofs;
+			ofs = (ofs << 1) + 1;
+		}
+		if (ofs > maxofs) ofs = maxofs;
+		ssize_t k = lastofs;
+		lastofs = hint - ofs;
+		ofs = hint - k;
+	}
+	a -= hint;
+	/* Now a[lastofs] < key <= a[ofs]; binary search the gap */
+	lastofs++;
+	while (lastofs < ofs) {
+		ssize_t m = lastofs + ((ofs - lastofs) >> 1);
+		if (state->lt(a[m], key)) lastofs = m + 1;
+		else ofs = m;
+	}
+	return ofs;
+}
+
+/* As gallopLeft(), but returns the rightmost position: a[k-1] <= key < a[k]. */
+static ssize_t gallopRight(struct SortState * state, KrkValue key, KrkValue * a, ssize_t n, ssize_t hint) {
+	ssize_t lastofs = 0, ofs = 1;
+	a += hint;
+	if (state->lt(key, *a)) {
+		/* key < a[hint]: gallop left until a[hint-ofs] <= key < a[hint-lastofs] */
+		ssize_t maxofs = hint + 1;
+		while (ofs < maxofs && state->lt(key, *(a-ofs))) {
+			lastofs = ofs;
+			ofs = (ofs << 1) + 1;
+		}
+		if (ofs > maxofs) ofs = maxofs;
+		ssize_t k = lastofs;
+		lastofs = hint - ofs;
+		ofs = hint - k;
+	} else {
+		/* a[hint] <= key: gallop right until a[hint+lastofs] <= key < a[hint+ofs] */
+		ssize_t maxofs = n - hint;
+		while (ofs < maxofs && !state->lt(key, a[ofs])) {
+			lastofs = ofs;
+			ofs = (ofs << 1) + 1;
+		}
+		if (ofs > maxofs) ofs = maxofs;
+		lastofs += hint;
+		ofs += hint;
+	}
+	a -= hint;
+	lastofs++;
+	while (lastofs < ofs) {
+		ssize_t m = lastofs + ((ofs - lastofs) >> 1);
+		if (state->lt(key, a[m])) ofs = m;
+		else lastofs = m + 1;
+	}
+	return ofs;
+}
+
+/*
+ * Merge the adjacent runs a[0:na] and b[0:nb] in place, where na <= nb,
+ * b[0] < a[0], and a[na-1] belongs at the end. The shorter run is copied
+ * out to the scratch space and merged from the left.
+ */
+static void mergeLo(struct SortState * state, SortSlice a, ssize_t na, SortSlice b, ssize_t nb) {
+	SortSlice dest = a;
+	sliceMove(&state->tmp, 0, &a, 0, na);
+	a = state->tmp;
+	size_t minGallop = state->minGallop;
+
+	sliceCopyIncr(&dest, &b);
+	if (--nb == 0) goto _succeed;
+	if (na == 1) goto _copyB;
+
+	for (;;) {
+		ssize_t acount = 0, bcount = 0;
+
+		/* One element at a time, until one run starts winning consistently */
+		for (;;) {
+			if (state->lt(*b.keys, *a.keys)) {
+				sliceCopyIncr(&dest, &b);
+				bcount++;
+				acount = 0;
+				if (--nb == 0) goto _succeed;
+				if ((size_t)bcount >= minGallop) break;
+			} else {
+				sliceCopyIncr(&dest, &a);
+				acount++;
+				bcount = 0;
+				if (--na == 1) goto _copyB;
+				if ((size_t)acount >= minGallop) break;
+			}
+		}
+
+		/* Then gallop, moving whole stretches at once, until that stops paying off */
+		minGallop++;
+		do {
+			minGallop -= minGallop > 1;
+			state->minGallop = minGallop;
+
+			ssize_t k = gallopRight(state, *b.keys, a.keys, na, 0);
+			acount = k;
+			if (k) {
+				sliceMove(&dest, 0, &a, 0, k);
+				sliceAdvance(&dest, k);
+				sliceAdvance(&a, k);
+				na -= k;
+				if (na == 1) goto _copyB;
+				/* Only possible if the comparison is inconsistent */
+				if (na == 0) goto _succeed;
+			}
+			sliceCopyIncr(&dest, &b);
+			if (--nb == 0) goto _succeed;
+
+			k = gallopLeft(state, *a.keys, b.keys, nb, 0);
+			bcount = k;
+			if (k) {
+				sliceMove(&dest, 0, &b, 0, k);
+				sliceAdvance(&dest, k);
+				sliceAdvance(&b, k);
+				nb -= k;
+				if (nb == 0) goto _succeed;
+			}
+			sliceCopyIncr(&dest, &a);
+			if (--na == 1) goto _copyB;
+		} while (acount >= MIN_GALLOP || bcount >= MIN_GALLOP);
+		minGallop++;
+		state->minGallop = minGallop;
+	}
+
+_succeed:
+	if (na) sliceMove(&dest, 0, &a, 0, na);
+	return;
+_copyB:
+	/* The last element of a belongs at the very end */
+	sliceMove(&dest, 0, &b, 0, nb);
+	sliceCopy(&dest, nb, &a, 0);
+}
+
+/*
+ * As mergeLo(), but for na >= nb: the second run is copied out and the
+ * merge proceeds from the right.
+ */
+static void mergeHi(struct SortState * state, SortSlice a, ssize_t na, SortSlice b, ssize_t nb) {
+	SortSlice dest = b;
+	sliceAdvance(&dest, nb - 1);
+	sliceMove(&state->tmp, 0, &b, 0, nb);
+	SortSlice basea = a;
+	SortSlice baseb = state->tmp;
+	b = state->tmp;
+	sliceAdvance(&b, nb - 1);
+	sliceAdvance(&a, na - 1);
+	size_t minGallop = state->minGallop;
+
+	sliceCopyDecr(&dest, &a);
+	if (--na == 0) goto _succeed;
+	if (nb == 1) goto _copyA;
+
+	for (;;) {
+		ssize_t acount = 0, bcount = 0;
+
+		for (;;) {
+			if (state->lt(*b.keys, *a.keys)) {
+				sliceCopyDecr(&dest, &a);
+				acount++;
+				bcount = 0;
+				if (--na == 0) goto _succeed;
+				if ((size_t)acount >= minGallop) break;
+			} else {
+				sliceCopyDecr(&dest, &b);
+				bcount++;
+				acount = 0;
+				if (--nb == 1) goto _copyA;
+				if ((size_t)bcount >= minGallop) break;
+			}
+		}
+
+		minGallop++;
+		do {
+			minGallop -= minGallop > 1;
+			state->minGallop = minGallop;
+
+			ssize_t k = na - gallopRight(state, *b.keys, basea.keys, na, na - 1);
+			acount = k;
+			if (k) {
+				sliceAdvance(&dest, -k);
+				sliceAdvance(&a, -k);
+				sliceMove(&dest, 1, &a, 1, k);
+				na -= k;
+				if (na == 0) goto _succeed;
+			}
+			sliceCopyDecr(&dest, &b);
+			if (--nb == 1) goto _copyA;
+
+			k = nb - gallopLeft(state, *a.keys, baseb.keys, nb, nb - 1);
+			bcount = k;
+			if (k) {
+				sliceAdvance(&dest, -k);
+				sliceAdvance(&b, -k);
+				sliceMove(&dest, 1, &b, 1, k);
+				nb -= k;
+				if (nb == 1) goto _copyA;
+				/* Only possible if the comparison is inconsistent */
+				if (nb == 0) goto _succeed;
+			}
+			sliceCopyDecr(&dest, &a);
+			if (--na == 0) goto _succeed;
+		} while (acount >= MIN_GALLOP || bcount >= MIN_GALLOP);
+		minGallop++;
+		state->minGallop = minGallop;
+	}
+
+_succeed:
+	if (nb) sliceMove(&dest, -(nb - 1), &baseb, 0, nb);
+	return;
+_copyA:
+	/* The first element of b belongs at the very start */
+	sliceAdvance(&dest, -na);
+	sliceAdvance(&a, -na);
+	sliceMove(&dest, 1, &a, 1, na);
+	sliceCopy(&dest, 0, &b, 0);
+}
+
+/* Merge the runs at i and i+1 on the run stack. */
+static void mergeAt(struct SortState * state, int i) {
+	SortSlice a = state->runs[i].base;
+	ssize_t na = state->runs[i].len;
+	SortSlice b = state->runs[i+1].base;
+	ssize_t nb = state->runs[i+1].len;
+
+	state->runs[i].len = na + nb;
+	if (i == state->runCount - 3) state->runs[i+1] = state->runs[i+2];
+	state->runCount--;
+
+	/* Elements of a before where b[0] goes are already in place */
+	ssize_t k = gallopRight(state, *b.keys, a.keys, na, 0);
+	sliceAdvance(&a, k);
+	na -= k;
+	if (na == 0) return;
+
+	/* Elements of b after where a[na-1] goes are already in place */
+	nb = gallopLeft(state, a.keys[na-1], b.keys, nb, nb - 1);
+	if (nb == 0) return;
+
+	if (na <= nb) mergeLo(state, a, na, b, nb);
+	else mergeHi(state, a, na, b, nb);
+}
+
+/* Merge runs until the stack lengths satisfy the Timsort invariants again. */
+static void mergeCollapse(struct SortState * state) {
+	struct SortRun * runs = state->runs;
+	while (state->runCount > 1) {
+		int n = state->runCount - 2;
+		if ((n > 0 && runs[n-1].len <= runs[n].len + runs[n+1].len) ||
+		    (n > 1 && runs[n-2].len <= runs[n-1].len + runs[n].len)) {
+			if (runs[n-1].len < runs[n+1].len) n--;
+			mergeAt(state, n);
+		} else if (runs[n].len <= runs[n+1].len) {
+			mergeAt(state, n);
+		} else {
+			break;
+		}
+	}
+}
+
+static void mergeForceCollapse(struct SortState * state) {
+	struct SortRun * runs = state->runs;
+	while (state->runCount > 1) {
+		int n = state->runCount - 2;
+		if (n > 0 && runs[n-1].len < runs[n+1].len) n--;
+		mergeAt(state, n);
+	}
+}
+
+/* Shortest run worth merging: between 32 and 64, so n / minRun is close to a power of two. */
+static size_t minRunLength(size_t n) {
+	size_t r = 0;
+	while (n >= 64) {
+		r |= n & 1;
+		n >>= 1;
+	}
+	return n + r;
+}
+
+/*
+ * Push a list of @p n Nones, used as scratch space that the GC can see.
+ * The caller pops it when done.
+ */
+static KrkValueArray * sortBuffer(size_t n) {
+	krk_push(krk_list_of(0,NULL,0));
+	KrkValueArray * buffer = AS_LIST(krk_peek(0));
+	buffer->values = GROW_ARRAY(KrkValue, buffer->values, 0, n);
+	buffer->capacity = n;
+	for (size_t i = 0; i < n; ++i) buffer->values[i] = NONE_VAL();
+	buffer->count = n;
+	return buffer;
+}
+
+/*
+ * Stable sort of keys[0:n], moving values[0:n] along with them if values
+ * is not NULL. All arrays must be reachable by the GC, as comparisons may
+ * run managed code.
+ */
+static void timsort(KrkValue * keys, KrkValue * values, size_t n) {
+	struct SortState state;
+	state.lt = sortComparator(keys, n);
+	state.minGallop = MIN_GALLOP;
+	state.runCount = 0;
+
+	SortSlice lo = {keys, values};
+	if (n < 64) {
+		if (n > 1) binaryInsertionSort(&state, lo, n, countRun(&state, lo, n));
+		return;
+	}
+
+	/* Neither run in a merge is copied out unless it is the shorter one */
+	int buffers = 1;
+	state.tmp.keys = sortBuffer(n / 2 + 1)->values;
+	state.tmp.values = NULL;
+	if (values) {
+		state.tmp.values = sortBuffer(n / 2 + 1)->values;
+		buffers++;
+	}
+
+	size_t minRun = minRunLength(n);
+	size_t remaining = n;
+	do {
+		size_t len = countRun(&state, lo, remaining);
+		if (len < minRun) {
+			size_t force = remaining < minRun ? remaining : minRun;
+			binaryInsertionSort(&state, lo, force, len);
+			len = force;
+		}
+		state.runs[state.runCount].base = lo;
+		state.runs[state.runCount].len = len;
+		state.runCount++;
+		mergeCollapse(&state);
+		sliceAdvance(&lo, len);
+		remaining -= len;
+	} while (remaining);
+	mergeForceCollapse(&state);
+
+	while (buffers--) krk_pop();
+}
+
+static KrkValue sortList(KrkList * self, KrkValue key, int reverse) {
+	/*
+	 * Take the values out of the list for the duration of the sort, so that
+	 * comparisons or key functions that modify it can't pull the array out
+	 * from under us. A temporary list keeps them visible to the GC.
+	 * A key passed by keyword is no longer referenced by the arguments,
+	 * so it needs to stay on the stack as well.
+	 */
+	krk_push(key);
+	krk_push(krk_list_of(0,NULL,0));
+	KrkValueArray * sorting = AS_LIST(krk_peek(0));
+	pthread_rwlock_wrlock(&self->rwlock);
+	*sorting = self->values;
+	krk_initValueArray(&self->values);
+	pthread_rwlock_unlock(&self->rwlock);
+
+	size_t n = sorting->count;
+	KrkValue * keys = sorting->values;
+	KrkValue * values = NULL;
+
+	if (!IS_NONE(key)) {
+		KrkValueArray * keyList = sortBuffer(n);
+		for (size_t i = 0; i < n; ++i) {
+			krk_push(key);
+			krk_push(sorting->values[i]);
+			keyList->values[i] = krk_callStack(1);
+			if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) break;
+		}
+		keys = keyList->values;
+		values = sorting->values;
+	}
+
+	if (likely(!(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION))) {
+		/* Reversing before and after keeps equal elements in their original order. */
+		if (reverse) {
+			reverseSlice(keys, n);
+			if (values) reverseSlice(values, n);
+		}
+		timsort(keys, values, n);
+		if (reverse) {
+			reverseSlice(keys, n);
+			if (values) reverseSlice(values, n);
+		}
+	}
+
+	if (values) krk_pop();
 
 	pthread_rwlock_wrlock(&self->rwlock);
-	qsort(self->values.values, self->values.count, sizeof(KrkValue), _list_sorter);
+	int modified = self->values.count != 0;
+	krk_freeValueArray(&self->values);
+	self->values = *sorting;
+	krk_initValueArray(sorting);
 	pthread_rwlock_unlock(&self->rwlock);
+	krk_pop();
+	krk_pop(); /* key */
+
+	if (modified && !(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) {
+		return krk_runtimeError(vm.exceptions->valueError, "list modified during sort");
+	}
 
 	return NONE_VAL();
 }
 
+KRK_Method(list,sort) {
+	KrkValue key = NONE_VAL();
+	int reverse = 0;
+	if (!krk_parseArgs(".|$Vp", (const char*[]){"key","reverse"}, &key, &reverse)) return NONE_VAL();
+	return sortList(self, key, reverse);
+}
+
 KRK_Method(list,__add__) {
 	METHOD_TAKES_EXACTLY(1);
 	if (!IS_list(argv[1])) return TYPE_ERROR(list,argv[1]);
@@ -498,12 +1040,6 @@ MAKE_LIST_COMPARE(le,<=)
 
 #undef CURRENT_CTYPE
 
-struct ListIterator {
-	KrkInstance inst;
-	KrkValue l;
-	size_t i;
-};
-
 #define CURRENT_CTYPE struct ListIterator *
 #define IS_listiterator(o) (likely(IS_INSTANCE(o) && AS_INSTANCE(o)->_class == vm.baseClasses->listiteratorClass) || krk_isInstanceOf(o,vm.baseClasses->listiteratorClass))
 #define AS_listiterator(o) (struct ListIterator*)AS_OBJECT(o)
@@ -544,13 +1080,18 @@ _bad:
 	goto _maybeGood;
 }
 
-static KrkValue _sorted(int argc, const KrkValue argv[], int hasKw) {
-	if (argc != 1) return krk_runtimeError(vm.exceptions->argumentError,"%s() takes %s %d argument%s (%d given)","sorted","exactly",1,"",argc);
+KRK_Function(sorted) {
+	KrkValue iterable, key = NONE_VAL();
+	int reverse = 0;
+	if (!krk_parseArgs("V|$Vp", (const char*[]){"iterable","key","reverse"}, &iterable, &key, &reverse)) return NONE_VAL();
+	/* Arguments taken from keywords must be kept alive while we allocate. */
+	krk_push(iterable);
+	krk_push(key);
 	KrkValue listOut = krk_list_of(0,NULL,0);
 	krk_push(listOut);
-	FUNC_NAME(list,extend)(2,(KrkValue[]){listOut,argv[0]},0);
+	FUNC_NAME(list,extend)(2,(KrkValue[]){listOut,iterable},0);
 	if (!IS_NONE(krk_currentThread.currentException)) return NONE_VAL();
-	FUNC_NAME(list,sort)(1,&listOut,0);
+	sortList((KrkList*)AS_OBJECT(listOut), key, reverse);
 	if (!IS_NONE(krk_currentThread.currentException)) return NONE_VAL();
 	return krk_pop();
 }
@@ -637,19 +1178,23 @@ void _createAndBind_listClass(void) {
 		"@brief Reverse the contents of a list.\n\n"
 		"Reverses the elements of the list in-place.");
 	KRK_DOC(BIND_METHOD(list,sort),
-		"@brief Sort the contents of a list.\n\n"
+		"@brief Sort the contents of a list.\n"
+		"@arguments *,key=None,reverse=False\n\n"
 		"Performs an in-place sort of the elements in the list, returning @c None as a gentle reminder "
-		"that the sort is in-place. If a sorted copy is desired, use @ref sorted instead.");
+		"that the sort is in-place. If a sorted copy is desired, use @ref sorted instead. "
+		"The sort is stable. If @p key is given, it is called once for each element and elements "
+		"are ordered by the results. If @p reverse is set, elements are sorted in descending order.");
 	krk_defineNative(&list->methods, "__str__", FUNC_NAME(list,__repr__));
 	krk_defineNative(&list->methods, "__class_getitem__", krk_GenericAlias)->obj.flags |= KRK_OBJ_FLAGS_FUNCTION_IS_CLASS_METHOD;
 	krk_attachNamedValue(&list->methods, "__hash__", NONE_VAL());
 	krk_finalizeClass(list);
 	KRK_DOC(list, "Mutable sequence of arbitrary values.");
 
-	BUILTIN_FUNCTION("sorted", _sorted,
+	BUILTIN_FUNCTION("sorted", _krk_sorted,
 		"@brief Return a sorted representation of an iterable.\n"
-		"@arguments iterable\n\n"
-		"Creates a new, sorted list from the elements of @p iterable.");
+		"@arguments iterable,*,key=None,reverse=False\n\n"
+		"Creates a new, sorted list from the elements of @p iterable. "
+		"Accepts the same keyword arguments as @ref list.sort.");
 	BUILTIN_FUNCTION("reversed", _reversed,
 		"@brief Return a reversed representation of an iterable.\n"
 		"@arguments iterable\n\n"
@@ -12,17 +12,14 @@
  *
  * TODO:
  * - Implement proper float conversions, make float ops more accurate.
- * - Expose better functions for extracting and converting native integers,
- *   which would be useful in modules that want to take 64-bit values,
- *   extracted unsigned values, etc.
- * - Faster division for large divisors?
- * - Shifts without multiply/divide...
  * - Exponentiation...
  */
 #include <kuroko/vm.h>
 #include <kuroko/value.h>
 #include <kuroko/util.h>
 
+#include "private.h"
+
 #define DIGIT_SHIFT 31
 #define DIGIT_MAX   0x7FFFFFFF
 
@@ -49,7 +46,7 @@ static int krk_long_init_si(KrkLong * num, int64_t val) {
 
 	/* Digits store unsigned values, so flip things over. */
 	int sign = (val < 0) ? -1 : 1;
-	uint64_t abs = (val < 0) ? -val : val;
+	uint64_t abs = (val < 0) ? -(uint64_t)val : (uint64_t)val;
 
 	/* Quick case for things that fit in our digits... */
 	if (abs <= DIGIT_MAX) {
@@ -398,7 +395,10 @@ static int krk_long_add(KrkLong * res, const KrkLong * a, const KrkLong * b) {
 				FINISH_OUTPUT(res);
 				return 0;
 		}
-		return 1;
+		/* Equal magnitudes cancel out */
+		krk_long_clear(res);
+		FINISH_OUTPUT(res);
+		return 0;
 	} else if (a->width > 0 && b->width < 0) {
 		switch (krk_long_compare_abs(a,b)) {
 			case -1:
@@ -412,8 +412,9 @@ static int krk_long_add(KrkLong * res, const KrkLong * a, const KrkLong * b) {
 				FINISH_OUTPUT(res);
 				return 0;
 		}
+		krk_long_clear(res);
 		FINISH_OUTPUT(res);
-		return 1;
+		return 0;
 	}
 
 	/* sign must match for this, so take it from whichever */
@@ -476,25 +477,351 @@ static int krk_long_sub(KrkLong * res, const KrkLong * a, const KrkLong * b) {
 }
 
 /**
- * @brief Zero all of the digits in @p num
+ * Multiplication
  *
- * @p num remains untrimmed and will maintain these extra zeros.
+ * The routines below work directly on arrays of digits. Small operands use
+ * schoolbook multiplication; past @c KARATSUBA_CUTOFF digits we switch to
+ * Karatsuba's three-multiplication split, and past @c TOOM3_CUTOFF digits to
+ * Toom-3, which needs five multiplications of a third of the size. Squaring
+ * is detected (same digits, same length) and takes dedicated paths that skip
+ * the symmetric half of the work, which matters for @c pow.
+ *
+ * The cutoffs were picked by timing bench/bigint.krk against builds with
+ * different values; they can be overridden at build time to re-tune them.
  */
-static int krk_long_zero(KrkLong * num) {
-	size_t abs_width = num->width < 0 ? -num->width : num->width;
-	for (size_t i = 0; i < abs_width; ++i) {
-		num->digits[i] = 0;
+#ifndef KARATSUBA_CUTOFF
+#define KARATSUBA_CUTOFF 40
+#endif
+#ifndef TOOM3_CUTOFF
+#define TOOM3_CUTOFF 400
+#endif
+
+static void _digits_mul(uint32_t * out, const uint32_t * a, size_t an, const uint32_t * b, size_t bn);
+static int krk_long_mul(KrkLong * res, const KrkLong * a, const KrkLong * b);
+
+/**
+ * @brief Number of digits in @p d once leading zeros are dropped.
+ */
+static size_t _digits_len(const uint32_t * d, size_t n) {
+	while (n && d[n-1] == 0) n--;
+	return n;
+}
+
+/**
+ * @brief Add @p a into the @p n digits at @p out, propagating the carry.
+ *
+ * @return The carry out of the top digit, which should be 0 if the caller sized @p out correctly.
+ */
+static uint32_t _digits_add_in(uint32_t * out, size_t n, const uint32_t * a, size_t an) {
+	uint32_t carry = 0;
+	size_t i = 0;
+	for (; i < an; ++i) {
+		uint32_t tmp = out[i] + a[i] + carry;
+		out[i] = tmp & DIGIT_MAX;
+		carry = tmp >> DIGIT_SHIFT;
 	}
-	return 0;
+	for (; carry && i < n; ++i) {
+		uint32_t tmp = out[i] + carry;
+		out[i] = tmp & DIGIT_MAX;
+		carry = tmp >> DIGIT_SHIFT;
+	}
+	return carry;
 }
 
 /**
- * @brief Multiply the absolute values of two longs.
+ * @brief Subtract @p a from the @p n digits at @p out, propagating the borrow.
+ */
+static uint32_t _digits_sub_in(uint32_t * out, size_t n, const uint32_t * a, size_t an) {
+	uint32_t borrow = 0;
+	size_t i = 0;
+	for (; i < an; ++i) {
+		uint32_t tmp = out[i] - a[i] - borrow;
+		out[i] = tmp & DIGIT_MAX;
+		borrow = (tmp >> DIGIT_SHIFT) & 1;
+	}
+	for (; borrow && i < n; ++i) {
+		uint32_t tmp = out[i] - borrow;
+		out[i] = tmp & DIGIT_MAX;
+		borrow = (tmp >> DIGIT_SHIFT) & 1;
+	}
+	return borrow;
+}
+
+/**
+ * @brief Schoolbook multiplication; @p out holds @p an + @p bn digits.
+ */
+static void _digits_mul_basic(uint32_t * out, const uint32_t * a, size_t an, const uint32_t * b, size_t bn) {
+	memset(out, 0, sizeof(uint32_t) * (an + bn));
+
+	for (size_t i = 0; i < bn; ++i) {
+		uint64_t b_digit = b[i];
+		uint64_t carry = 0;
+		for (size_t j = 0; j < an; ++j) {
+			uint64_t a_digit = a[j];
+			uint64_t tmp = carry + a_digit * b_digit + out[i+j];
+			carry = tmp >> DIGIT_SHIFT;
+			out[i+j] = tmp & DIGIT_MAX;
+		}
+		out[i + an] = carry;
+	}
+}
+
+/**
+ * @brief Schoolbook squaring; @p out holds 2 * @p n digits.
+ *
+ * Each cross product a[i]*a[j] is computed once, then the sum is doubled
+ * and the squares of the digits are added on the diagonal.
+ */
+static void _digits_sqr_basic(uint32_t * out, const uint32_t * a, size_t n) {
+	memset(out, 0, sizeof(uint32_t) * n * 2);
+
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t a_digit = a[i];
+		uint64_t carry = 0;
+		for (size_t j = i + 1; j < n; ++j) {
+			uint64_t tmp = carry + a_digit * a[j] + out[i+j];
+			carry = tmp >> DIGIT_SHIFT;
+			out[i+j] = tmp & DIGIT_MAX;
+		}
+		out[i + n] = carry;
+	}
+
+	uint64_t carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		uint64_t square = (uint64_t)a[i] * a[i];
+		uint64_t low  = ((uint64_t)out[2*i] << 1) + (square & DIGIT_MAX) + carry;
+		out[2*i] = low & DIGIT_MAX;
+		carry = low >> DIGIT_SHIFT;
+		uint64_t high = ((uint64_t)out[2*i+1] << 1) + (square >> DIGIT_SHIFT) + carry;
+		out[2*i+1] = high & DIGIT_MAX;
+		carry = high >> DIGIT_SHIFT;
+	}
+}
+
+/**
+ * @brief Store @p x + @p y in @p out, which must have room for one digit more than the longer of the two.
+ *
+ * @return The number of digits written.
+ */
+static size_t _digits_sum(uint32_t * out, const uint32_t * x, size_t xn, const uint32_t * y, size_t yn) {
+	if (xn < yn) {
+		const uint32_t * t = x; x = y; y = t;
+		size_t tn = xn; xn = yn; yn = tn;
+	}
+	memcpy(out, x, sizeof(uint32_t) * xn);
+	out[xn] = 0;
+	_digits_add_in(out, xn + 1, y, yn);
+	return xn + 1;
+}
+
+/**
+ * @brief Karatsuba multiplication, for @p an >= @p bn > @p an / 2.
+ *
+ * With a = a1*B^h + a0 and b = b1*B^h + b0, a*b = z2*B^2h + z1*B^h + z0, where
+ * z0 = a0*b0, z2 = a1*b1 and z1 = (a0+a1)(b0+b1) - z0 - z2. z0 and z2 are
+ * computed in place in the low and high halves of @p out.
+ */
+static void _digits_mul_karatsuba(uint32_t * out, const uint32_t * a, size_t an, const uint32_t * b, size_t bn) {
+	int square = (a == b && an == bn);
+	size_t h = an / 2;
+	size_t outn = an + bn;
+
+	_digits_mul(out, a, h, b, h);
+	_digits_mul(out + 2 * h, a + h, an - h, b + h, bn - h);
+
+	size_t san = an - h + 1;
+	size_t sbn = (bn - h > h ? bn - h : h) + 1;
+	uint32_t * scratch = malloc(sizeof(uint32_t) * (san + sbn) * 2);
+	uint32_t * sa = scratch;
+	uint32_t * sb = scratch + san;
+	uint32_t * z1 = scratch + san + sbn;
+
+	san = _digits_len(sa, _digits_sum(sa, a, h, a + h, an - h));
+	size_t z1n;
+	if (square) {
+		_digits_mul(z1, sa, san, sa, san);
+		z1n = san * 2;
+	} else {
+		sbn = _digits_len(sb, _digits_sum(sb, b, h, b + h, bn - h));
+		_digits_mul(z1, sa, san, sb, sbn);
+		z1n = san + sbn;
+	}
+
+	_digits_sub_in(z1, z1n, out, _digits_len(out, 2 * h));
+	_digits_sub_in(z1, z1n, out + 2 * h, _digits_len(out + 2 * h, outn - 2 * h));
+	_digits_add_in(out + h, outn - h, z1, _digits_len(z1, z1n));
+
+	free(scratch);
+}
+
+/**
+ * @brief Load @p count digits of @p d starting at @p start into an uninitialized long.
+ */
+static void _long_from_digits(KrkLong * out, const uint32_t * d, size_t n, size_t start, size_t count) {
+	krk_long_init_si(out, 0);
+	if (start >= n) return;
+	if (start + count > n) count = n - start;
+	count = _digits_len(d + start, count);
+	if (!count) return;
+	krk_long_resize(out, count);
+	memcpy(out->digits, d + start, sizeof(uint32_t) * count);
+}
+
+/**
+ * @brief Divide a long of either sign by 2 or 3, which is known to divide it exactly.
+ *
+ * The divisor is a constant in each branch so the compiler can replace the
+ * division with a multiplication.
+ */
+static void _long_div_exact(KrkLong * a, uint32_t divisor) {
+	size_t width = a->width < 0 ? -a->width : a->width;
+	uint64_t remainder = 0;
+	for (size_t i = width; i > 0; --i) {
+		remainder = (remainder << DIGIT_SHIFT) | a->digits[i-1];
+		uint64_t digit = divisor == 2 ? remainder / 2 : remainder / 3;
+		a->digits[i-1] = digit;
+		remainder -= digit * divisor;
+	}
+	krk_long_trim(a);
+}
+
+/**
+ * @brief Add a non-negative long into @p out at a digit @p offset.
+ */
+static void _long_add_at(uint32_t * out, size_t n, const KrkLong * val, size_t offset) {
+	if (val->width == 0) return;
+	_digits_add_in(out + offset, n - offset, val->digits, val->width);
+}
+
+/**
+ * @brief Toom-3 multiplication, for @p an >= @p bn > @p an / 2.
+ *
+ * Both operands are split into three pieces of k digits, viewed as polynomials
+ * in B^k, and evaluated at 0, 1, -1, -2 and infinity. The five pointwise
+ * products are interpolated back into the five coefficients of the product
+ * using Bodrato's sequence. The pieces can be negative at -1 and -2, so this
+ * works on longs and recurses through @c krk_long_mul.
+ */
+static void _digits_mul_toom3(uint32_t * out, const uint32_t * a, size_t an, const uint32_t * b, size_t bn) {
+	int square = (a == b && an == bn);
+	size_t k = (an + 2) / 3;
+
+	KrkLong a0, a1, a2, b0, b1, b2;
+	KrkLong pa1, pam1, pam2, pb1, pbm1, pbm2;
+	KrkLong r0, r1, rm1, rm2, rinf, c1, c2, c3;
+
+	_long_from_digits(&a0, a, an, 0, k);
+	_long_from_digits(&a1, a, an, k, k);
+	_long_from_digits(&a2, a, an, 2 * k, k);
+	krk_long_init_many(&pa1, &pam1, &pam2, &r0, &r1, &rm1, &rm2, &rinf, &c1, &c2, &c3, NULL);
+
+	/* p(1) = a0 + a1 + a2; p(-1) = a0 - a1 + a2; p(-2) = 2 * (p(-1) + a2) - a0 */
+	krk_long_add(&pa1, &a0, &a2);
+	krk_long_sub(&pam1, &pa1, &a1);
+	krk_long_add(&pa1, &pa1, &a1);
+	krk_long_add(&pam2, &pam1, &a2);
+	krk_long_add(&pam2, &pam2, &pam2);
+	krk_long_sub(&pam2, &pam2, &a0);
+
+	if (square) {
+		krk_long_mul(&r0, &a0, &a0);
+		krk_long_mul(&r1, &pa1, &pa1);
+		krk_long_mul(&rm1, &pam1, &pam1);
+		krk_long_mul(&rm2, &pam2, &pam2);
+		krk_long_mul(&rinf, &a2, &a2);
+	} else {
+		_long_from_digits(&b0, b, bn, 0, k);
+		_long_from_digits(&b1, b, bn, k, k);
+		_long_from_digits(&b2, b, bn, 2 * k, k);
+		krk_long_init_many(&pb1, &pbm1, &pbm2, NULL);
+
+		krk_long_add(&pb1, &b0, &b2);
+		krk_long_sub(&pbm1, &pb1, &b1);
+		krk_long_add(&pb1, &pb1, &b1);
+		krk_long_add(&pbm2, &pbm1, &b2);
+		krk_long_add(&pbm2, &pbm2, &pbm2);
+		krk_long_sub(&pbm2, &pbm2, &b0);
+
+		krk_long_mul(&r0, &a0, &b0);
+		krk_long_mul(&r1, &pa1, &pb1);
+		krk_long_mul(&rm1, &pam1, &pbm1);
+		krk_long_mul(&rm2, &pam2, &pbm2);
+		krk_long_mul(&rinf, &a2, &b2);
+
+		krk_long_clear_many(&b0, &b1, &b2, &pb1, &pbm1, &pbm2, NULL);
+	}
+
+	/* c3 = (r(-2) - r(1)) / 3 */
+	krk_long_sub(&c3, &rm2, &r1);
+	_long_div_exact(&c3, 3);
+	/* c1 = (r(1) - r(-1)) / 2 */
+	krk_long_sub(&c1, &r1, &rm1);
+	_long_div_exact(&c1, 2);
+	/* c2 = r(-1) - r(0) */
+	krk_long_sub(&c2, &rm1, &r0);
+	/* c3 = (c2 - c3) / 2 + 2 * r(inf) */
+	krk_long_sub(&c3, &c2, &c3);
+	_long_div_exact(&c3, 2);
+	krk_long_add(&c3, &c3, &rinf);
+	krk_long_add(&c3, &c3, &rinf);
+	/* c2 = c2 + c1 - r(inf) */
+	krk_long_add(&c2, &c2, &c1);
+	krk_long_sub(&c2, &c2, &rinf);
+	/* c1 = c1 - c3 */
+	krk_long_sub(&c1, &c1, &c3);
+
+	size_t outn = an + bn;
+	memset(out, 0, sizeof(uint32_t) * outn);
+	_long_add_at(out, outn, &r0, 0);
+	_long_add_at(out, outn, &c1, k);
+	_long_add_at(out, outn, &c2, 2 * k);
+	_long_add_at(out, outn, &c3, 3 * k);
+	_long_add_at(out, outn, &rinf, 4 * k);
+
+	krk_long_clear_many(&a0, &a1, &a2, &pa1, &pam1, &pam2, &r0, &r1, &rm1, &rm2, &rinf, &c1, &c2, &c3, NULL);
+}
+
+/**
+ * @brief Multiply two digit arrays into @p out, which holds @p an + @p bn digits.
  *
- * Performs a simple chalkboard long multiplication, using the
- * result as the accumulator.
+ * @p a and @p b may be the same array, which selects squaring.
+ */
+static void _digits_mul(uint32_t * out, const uint32_t * a, size_t an, const uint32_t * b, size_t bn) {
+	if (an < bn) {
+		const uint32_t * t = a; a = b; b = t;
+		size_t tn = an; an = bn; bn = tn;
+	}
+
+	if (bn < KARATSUBA_CUTOFF) {
+		if (a == b && an == bn) _digits_sqr_basic(out, a, an);
+		else _digits_mul_basic(out, a, an, b, bn);
+		return;
+	}
+
+	if (an >= 2 * bn) {
+		/* Lopsided: multiply b by slices of a that are its own size. */
+		memset(out, 0, sizeof(uint32_t) * (an + bn));
+		uint32_t * tmp = malloc(sizeof(uint32_t) * bn * 2);
+		for (size_t offset = 0; offset < an; offset += bn) {
+			size_t slice = an - offset < bn ? an - offset : bn;
+			_digits_mul(tmp, a + offset, slice, b, bn);
+			_digits_add_in(out + offset, an + bn - offset, tmp, slice + bn);
+		}
+		free(tmp);
+		return;
+	}
+
+	if (bn < TOOM3_CUTOFF) {
+		_digits_mul_karatsuba(out, a, an, b, bn);
+	} else {
+		_digits_mul_toom3(out, a, an, b, bn);
+	}
+}
+
+/**
+ * @brief Multiply the absolute values of two longs.
  *
- * @p res must be initialized, but will be resized and zeroed on entry; it
+ * @p res must be initialized, but will be resized on entry; it
  * must not be equal to either of @p a or @p b.
  */
 static int _mul_abs(KrkLong * res, const KrkLong * a, const KrkLong * b) {
@@ -503,19 +830,12 @@ static int _mul_abs(KrkLong * res, const KrkLong * a, const KrkLong * b) {
 	size_t bwidth = b->width < 0 ? -b->width : b->width;
 
 	krk_long_resize(res, awidth+bwidth);
-	krk_long_zero(res);
 
-	for (size_t i = 0; i < bwidth; ++i) {
-		uint64_t b_digit = b->digits[i];
-		uint64_t carry = 0;
-		for (size_t j = 0; j < awidth; ++j) {
-			uint64_t a_digit = a->digits[j];
-			uint64_t tmp = carry + a_digit * b_digit + res->digits[i+j];
-			carry = tmp >> DIGIT_SHIFT;
-			res->digits[i+j] = tmp & DIGIT_MAX;
-		}
-		res->digits[i + awidth] = carry;
-	}
+	/* Operands are usually copies, so look at the digits to spot squaring. */
+	const uint32_t * bdigits = b->digits;
+	if (awidth == bwidth && !memcmp(a->digits, b->digits, sizeof(uint32_t) * awidth)) bdigits = a->digits;
+
+	_digits_mul(res->digits, a->digits, awidth, bdigits, bwidth);
 
 	krk_long_trim(res);
 
@@ -559,40 +879,6 @@ static int krk_long_mul(KrkLong * res, const KrkLong * a, const KrkLong * b) {
 	return 0;
 }
 
-/**
- * @brief Shift a long one bit left.
- *
- * Shifts @p in left one bit in-place, resizing as needed.
- */
-static int _lshift_one(KrkLong * in) {
-	if (in->width == 0) {
-		return 0;
-	}
-
-	size_t abs_width = in->width < 0 ? -in->width : in->width;
-	size_t out_width = abs_width;
-
-	if (in->digits[abs_width-1] >> (DIGIT_SHIFT - 1)) {
-		out_width += 1;
-	}
-
-	krk_long_resize(in, out_width);
-
-	int carry = 0;
-
-	for (size_t i = 0; i < abs_width; ++i) {
-		uint32_t digit = in->digits[i];
-		in->digits[i] = ((digit << 1) + carry) & DIGIT_MAX;
-		carry = (digit >> (DIGIT_SHIFT -1));
-	}
-
-	if (carry) {
-		in->digits[out_width-1] = 1;
-	}
-
-	return 0;
-}
-
 /**
  * @brief Calculate the highest set bit of a long.
  *
@@ -605,13 +891,8 @@ static size_t _bits_in(const KrkLong * num) {
 
 	size_t abs_width = num->width < 0 ? -num->width : num->width;
 
-	/* Top bit in digits[abs_width-1] */
-	size_t c = 0;
-	uint32_t digit = num->digits[abs_width-1];
-	while (digit) {
-		c++;
-		digit >>= 1;
-	}
+	/* Top bit in digits[abs_width-1], which is never 0 */
+	size_t c = 32 - __builtin_clz(num->digits[abs_width-1]);
 
 	return c + (abs_width-1) * DIGIT_SHIFT;
 }
@@ -626,41 +907,292 @@ static size_t _bit_is_set(const KrkLong * num, size_t bit) {
 }
 
 /**
- * @brief Set or unset the least significant bit of a long.
+ * Division
+ *
+ * Single-digit divisors are handled with one pass of short division. Larger
+ * divisors use Knuth's algorithm D (TAOCP vol. 2, 4.3.1), which produces a
+ * full digit of quotient per step from an estimate based on the top two
+ * digits of the remainder, corrected at most twice. Past @c BZ_CUTOFF digits
+ * of divisor, Burnikel and Ziegler's recursive division splits the work into
+ * half-size divisions and multiplications, so it benefits from the faster
+ * multiplication above. All of these expect a normalized divisor, whose top
+ * digit has its highest bit set.
  */
-static int _bit_set_zero(KrkLong * num, int val) {
-	if (num->width == 0) {
-		krk_long_clear(num);
-		krk_long_init_si(num, !!val);
-		return 0;
+#ifndef BZ_CUTOFF
+#define BZ_CUTOFF 80
+#endif
+
+/**
+ * @brief Shift @p n digits left by @p shift bits (less than a digit) into @p out.
+ *
+ * @return The bits shifted out of the top digit.
+ */
+static uint32_t _digits_shl(uint32_t * out, const uint32_t * in, size_t n, int shift) {
+	uint32_t carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		uint32_t digit = in[i];
+		out[i] = ((digit << shift) | carry) & DIGIT_MAX;
+		carry = shift ? digit >> (DIGIT_SHIFT - shift) : 0;
 	}
+	return carry;
+}
 
-	num->digits[0] = (num->digits[0] & ~1) | (!!val);
-	return 0;
+/**
+ * @brief Shift @p n digits right by @p shift bits (less than a digit) into @p out.
+ */
+static void _digits_shr(uint32_t * out, const uint32_t * in, size_t n, int shift) {
+	for (size_t i = 0; i < n; ++i) {
+		uint32_t high = (shift && i + 1 < n) ? (in[i+1] << (DIGIT_SHIFT - shift)) & DIGIT_MAX : 0;
+		out[i] = (in[i] >> shift) | high;
+	}
+}
+
+/**
+ * @brief Replace the digits of a long with @p n digits from @p d, trimming leading zeros.
+ */
+static void _long_set_digits(KrkLong * out, const uint32_t * d, size_t n) {
+	krk_long_clear(out);
+	n = _digits_len(d, n);
+	if (!n) return;
+	krk_long_resize(out, n);
+	memcpy(out->digits, d, sizeof(uint32_t) * n);
+}
+
+/**
+ * @brief Knuth's algorithm D.
+ *
+ * Divides the @p un digits of @p u by the @p vn >= 2 digits of normalized @p v.
+ * @p u must have room for one more digit above @p un, which need not be set.
+ * The @p un - @p vn + 1 digits of the quotient are written to @p q and the
+ * remainder is left in the low @p vn digits of @p u.
+ */
+static void _digits_divmod_knuth(uint32_t * q, uint32_t * u, size_t un, const uint32_t * v, size_t vn) {
+	u[un] = 0;
+	uint64_t vtop = v[vn-1];
+	uint64_t vnext = v[vn-2];
+
+	for (size_t j = un - vn + 1; j > 0; --j) {
+		uint32_t * window = u + j - 1;
+
+		/* Estimate from the top two digits, then correct with the third. */
+		uint64_t top = ((uint64_t)window[vn] << DIGIT_SHIFT) | window[vn-1];
+		uint64_t qhat = top / vtop;
+		uint64_t rhat = top - qhat * vtop;
+		while (qhat > DIGIT_MAX || qhat * vnext > ((rhat << DIGIT_SHIFT) | window[vn-2])) {
+			qhat--;
+			rhat += vtop;
+			if (rhat > DIGIT_MAX) break;
+		}
+
+		/* Multiply and subtract */
+		uint64_t carry = 0;
+		int64_t borrow = 0;
+		for (size_t i = 0; i < vn; ++i) {
+			uint64_t product = qhat * v[i] + carry;
+			carry = product >> DIGIT_SHIFT;
+			int64_t tmp = (int64_t)window[i] - (int64_t)(product & DIGIT_MAX) - borrow;
+			window[i] = tmp & DIGIT_MAX;
+			borrow = tmp < 0;
+		}
+		int64_t tmp = (int64_t)window[vn] - (int64_t)carry - borrow;
+		window[vn] = tmp & DIGIT_MAX;
+
+		/* The estimate was one too large; add the divisor back. */
+		if (tmp < 0) {
+			qhat--;
+			uint32_t c = 0;
+			for (size_t i = 0; i < vn; ++i) {
+				uint32_t sum = window[i] + v[i] + c;
+				window[i] = sum & DIGIT_MAX;
+				c = sum >> DIGIT_SHIFT;
+			}
+			window[vn] = (window[vn] + c) & DIGIT_MAX;
+		}
+
+		q[j-1] = qhat;
+	}
 }
 
 /**
- * @brief Set a given bit in a long.
+ * @brief Divide non-negative @p a by normalized, non-negative @p b with algorithm D.
  *
- * Because of how we use it, this only supports setting the bit,
- * eg. it performs: num |= (1 << bit)
+ * @p b must have at least two digits. @p quot and @p rem must be initialized
+ * and distinct from the inputs.
+ */
+static void _long_divmod_knuth(KrkLong * quot, KrkLong * rem, const KrkLong * a, const KrkLong * b) {
+	size_t an = a->width;
+	size_t bn = b->width;
+
+	if (krk_long_compare(a, b) < 0) {
+		krk_long_clear(quot);
+		krk_long_clear(rem);
+		krk_long_init_copy(rem, a);
+		return;
+	}
+
+	uint32_t * u = malloc(sizeof(uint32_t) * (an + 1));
+	uint32_t * q = malloc(sizeof(uint32_t) * (an - bn + 1));
+	memcpy(u, a->digits, sizeof(uint32_t) * an);
+	_digits_divmod_knuth(q, u, an, b->digits, bn);
+	_long_set_digits(quot, q, an - bn + 1);
+	_long_set_digits(rem, u, bn);
+	free(u);
+	free(q);
+}
+
+/**
+ * @brief Set @p out to @p in shifted up by @p count whole digits.
+ */
+static void _long_shift_digits(KrkLong * out, const KrkLong * in, size_t count) {
+	krk_long_clear(out);
+	if (in->width == 0) return;
+	krk_long_resize(out, in->width + count);
+	memset(out->digits, 0, sizeof(uint32_t) * count);
+	memcpy(out->digits + count, in->digits, sizeof(uint32_t) * in->width);
+}
+
+/**
+ * @brief Set @p out to @p count digits of @p in starting at @p start.
+ */
+static void _long_slice(KrkLong * out, const KrkLong * in, size_t start, size_t count) {
+	krk_long_clear(out);
+	_long_from_digits(out, in->digits, in->width, start, count);
+}
+
+static void _div_2n1n(KrkLong * quot, KrkLong * rem, const KrkLong * a, const KrkLong * b, size_t n);
+
+/**
+ * @brief Divide [@p a12, @p a3] by @p b = [@p b1, @p b2], where each part has @p n digits.
  *
- * @p num will be resized as needed.
+ * The quotient of the top two parts by @p b1 overestimates the real one by
+ * at most two, which is corrected by adding @p b back to the remainder.
  */
-static int krk_long_bit_set(KrkLong * num, size_t bit) {
-	size_t abs_width = num->width < 0 ? -num->width : num->width;
-	size_t digit_offset = bit / DIGIT_SHIFT;
-	size_t digit_bit    = bit % DIGIT_SHIFT;
+static void _div_3n2n(KrkLong * quot, KrkLong * rem, const KrkLong * a12, const KrkLong * a3,
+		const KrkLong * b, const KrkLong * b1, const KrkLong * b2, size_t n) {
+	KrkLong tmp, one;
+	krk_long_init_many(&tmp, &one, NULL);
+
+	_long_slice(&tmp, a12, n, a12->width);
+	if (krk_long_compare(&tmp, b1) == 0) {
+		/* quot = B^n - 1; rem = a12 - b1 * B^n + b1 */
+		krk_long_clear(quot);
+		krk_long_resize(quot, n);
+		for (size_t i = 0; i < n; ++i) quot->digits[i] = DIGIT_MAX;
+		_long_shift_digits(&tmp, b1, n);
+		krk_long_sub(rem, a12, &tmp);
+		krk_long_add(rem, rem, b1);
+	} else {
+		_div_2n1n(quot, rem, a12, b1, n);
+	}
+
+	/* rem = rem * B^n + a3 - quot * b2 */
+	_long_shift_digits(&tmp, rem, n);
+	krk_long_add(rem, &tmp, a3);
+	krk_long_mul(&tmp, quot, b2);
+	krk_long_sub(rem, rem, &tmp);
+
+	krk_long_init_si(&one, 1);
+	while (rem->width < 0) {
+		krk_long_sub(quot, quot, &one);
+		krk_long_add(rem, rem, b);
+	}
+
+	krk_long_clear_many(&tmp, &one, NULL);
+}
+
+/**
+ * @brief Divide @p a, less than B^n * @p b, by the @p n digits of normalized @p b.
+ */
+static void _div_2n1n(KrkLong * quot, KrkLong * rem, const KrkLong * a, const KrkLong * b, size_t n) {
+	if (n < BZ_CUTOFF || a->width <= (ssize_t)n + BZ_CUTOFF / 2) {
+		_long_divmod_knuth(quot, rem, a, b);
+		return;
+	}
+
+	KrkLong pa, pb;
+	krk_long_init_many(&pa, &pb, NULL);
+	if (n & 1) {
+		/* Pad both operands by one digit so they split evenly. */
+		_long_shift_digits(&pa, a, 1);
+		_long_shift_digits(&pb, b, 1);
+		a = &pa;
+		b = &pb;
+		n++;
+	}
+
+	size_t half = n / 2;
+	KrkLong b1, b2, a12, a3, q1, q2;
+	krk_long_init_many(&b1, &b2, &a12, &a3, &q1, &q2, NULL);
+	_long_slice(&b1, b, half, half);
+	_long_slice(&b2, b, 0, half);
+
+	_long_slice(&a12, a, n, a->width);
+	_long_slice(&a3, a, half, half);
+	_div_3n2n(&q1, rem, &a12, &a3, b, &b1, &b2, half);
+
+	_long_slice(&a3, a, 0, half);
+	_div_3n2n(&q2, &a12, rem, &a3, b, &b1, &b2, half);
+	_swap(rem, &a12);
+
+	/* quot = q1 * B^half + q2, and q2 has at most half digits */
+	_long_shift_digits(quot, &q1, half);
+	krk_long_add(quot, quot, &q2);
+
+	if (pb.width) {
+		_long_slice(&a12, rem, 1, rem->width);
+		_swap(rem, &a12);
+	}
 
-	if (digit_offset >= abs_width) {
-		krk_long_resize(num, digit_offset+1);
-		for (size_t i = abs_width; i < digit_offset + 1; ++i) {
-			num->digits[i] = 0;
+	krk_long_clear_many(&pa, &pb, &b1, &b2, &a12, &a3, &q1, &q2, NULL);
+}
+
+/**
+ * @brief Divide @p |a| by @p |b| using normalized copies of both.
+ *
+ * Small divisors go straight to algorithm D. Otherwise @p a is consumed in
+ * blocks of as many digits as the divisor, from the top, each one divided
+ * along with the running remainder by @c _div_2n1n.
+ */
+static void _div_normalized(KrkLong * quot, KrkLong * rem, const KrkLong * a, const KrkLong * b) {
+	size_t an = a->width < 0 ? -a->width : a->width;
+	size_t bn = b->width < 0 ? -b->width : b->width;
+	int shift = __builtin_clz(b->digits[bn-1]) - (32 - DIGIT_SHIFT);
+
+	KrkLong na, nb;
+	krk_long_init_many(&na, &nb, NULL);
+	krk_long_resize(&na, an + 1);
+	na.digits[an] = _digits_shl(na.digits, a->digits, an, shift);
+	krk_long_trim(&na);
+	krk_long_resize(&nb, bn);
+	_digits_shl(nb.digits, b->digits, bn, shift);
+
+	if (bn < BZ_CUTOFF || an < bn + BZ_CUTOFF) {
+		_long_divmod_knuth(quot, rem, &na, &nb);
+	} else {
+		size_t blocks = (na.width + bn - 1) / bn;
+		uint32_t * q = calloc(blocks * bn + 1, sizeof(uint32_t));
+		KrkLong block, chunk, digit;
+		krk_long_init_many(&block, &chunk, &digit, NULL);
+		krk_long_clear(rem);
+		for (size_t i = blocks; i > 0; --i) {
+			_long_slice(&chunk, &na, (i - 1) * bn, bn);
+			_long_shift_digits(&block, rem, bn);
+			krk_long_add(&block, &block, &chunk);
+			_div_2n1n(&digit, rem, &block, &nb, bn);
+			if (digit.width) memcpy(q + (i - 1) * bn, digit.digits, sizeof(uint32_t) * digit.width);
 		}
+		_long_set_digits(quot, q, blocks * bn);
+		krk_long_clear_many(&block, &chunk, &digit, NULL);
+		free(q);
 	}
 
-	num->digits[digit_offset] |= (1 << digit_bit);
-	return 0;
+	/* Undo the normalization of the remainder */
+	if (shift && rem->width) {
+		_digits_shr(rem->digits, rem->digits, rem->width, shift);
+		krk_long_trim(rem);
+	}
+
+	krk_long_clear_many(&na, &nb, NULL);
 }
 
 /**
@@ -668,10 +1200,6 @@ static int krk_long_bit_set(KrkLong * num, size_t bit) {
  *
  * Divides @p |a| by @p |b| placing the remainder in @p rem and the quotient in @p quot.
  *
- * Performs one of two division operations. For single-digit divisor, we perform
- * a quicker division. For anything else, performs a binary long division, which
- * is terribly slow, but is at least correct...
- *
  * @return 1 if divisor is 0, otherwise 0.
  */
 static int _div_abs(KrkLong * quot, KrkLong * rem, const KrkLong * a, const KrkLong * b) {
@@ -693,53 +1221,27 @@ static int _div_abs(KrkLong * quot, KrkLong * rem, const KrkLong * a, const KrkL
 		return 0;
 	}
 
-	if (awidth < bwidth) {
+	if (krk_long_compare_abs(a, b) < 0) {
 		krk_long_init_copy(rem, a);
 		krk_long_set_sign(rem, 1);
 		return 0;
 	}
 
-	KrkLong absa, absb;
-	krk_long_init_copy(&absa, a);
-	krk_long_set_sign(&absa, 1);
-	krk_long_init_copy(&absb, b);
-	krk_long_set_sign(&absb, 1);
-
 	if (bwidth == 1) {
 		uint64_t remainder = 0;
-		for (size_t i = 0; i < awidth; ++i) {
-			size_t _i = awidth - i - 1;
-			remainder = (remainder << DIGIT_SHIFT) | absa.digits[_i];
-			absa.digits[_i] = (uint32_t)(remainder / absb.digits[0]) & DIGIT_MAX;
-			remainder -= (uint64_t)(absa.digits[_i]) * absb.digits[0];
+		krk_long_init_copy(quot, a);
+		krk_long_set_sign(quot, 1);
+		for (size_t i = awidth; i > 0; --i) {
+			remainder = (remainder << DIGIT_SHIFT) | quot->digits[i-1];
+			quot->digits[i-1] = (uint32_t)(remainder / b->digits[0]);
+			remainder -= (uint64_t)(quot->digits[i-1]) * b->digits[0];
 		}
-
-		krk_long_init_si(rem, remainder);
-		_swap(quot, &absa);
 		krk_long_trim(quot);
-
-		krk_long_clear_many(&absa, &absb, NULL);
+		krk_long_init_si(rem, remainder);
 		return 0;
 	}
 
-	size_t bits = _bits_in(a);
-	for (size_t i = 0; i < bits; ++i) {
-		size_t _i = bits - i - 1;
-
-		/* Shift remainder by one */
-		_lshift_one(rem);
-
-		int is_set = _bit_is_set(&absa, _i);
-		_bit_set_zero(rem, is_set);
-		if (krk_long_compare(rem,&absb) >= 0) {
-			_sub_big_small(rem,rem,&absb);
-			krk_long_bit_set(quot, _i);
-		}
-	}
-
-	krk_long_trim(quot);
-	krk_long_clear_many(&absa,&absb,NULL);
-
+	_div_normalized(quot, rem, a, b);
 	return 0;
 }
 
@@ -830,19 +1332,19 @@ size_t krk_long_digits_in_base(KrkLong * num, int base) {
 /**
  * @brief Convert a long with up to 2 digits to a 64-bit value.
  */
-static int64_t krk_long_medium(KrkLong * num) {
+static int64_t krk_long_medium(const KrkLong * num) {
 	if (num->width == 0) return 0;
 
 	if (num->width < 0) {
 		uint64_t val = num->digits[0];
-		if (num->width < 1) {
-			val |= (num->digits[1]) << 31;
+		if (num->width < -1) {
+			val |= (uint64_t)(num->digits[1]) << 31;
 		}
 		return -val;
 	} else {
 		uint64_t val = num->digits[0];
 		if (num->width > 1) {
-			val |= (num->digits[1]) << 31;
+			val |= (uint64_t)(num->digits[1]) << 31;
 		}
 		return val;
 	}
@@ -854,6 +1356,9 @@ static int64_t krk_long_medium(KrkLong * num) {
  * Supports or, xor, (and) and. Does in-place twos-complement for
  * negatives - I thought that was pretty neat, but it's probably
  * slower than just doing it afterwards...
+ *
+ * Non-negative operands need no complementing, so they get straight
+ * loops over whole digits that the compiler can vectorize.
  */
 static int do_bin_op(KrkLong * res, const KrkLong * a, const KrkLong * b, char op) {
 	size_t awidth = a->width < 0 ? -a->width : a->width;
@@ -864,6 +1369,31 @@ static int do_bin_op(KrkLong * res, const KrkLong * a, const KrkLong * b, char o
 	int bneg = (b->width < 0);
 	int rneg = 0;
 
+	if (!aneg && !bneg) {
+		if (awidth < bwidth) {
+			const KrkLong * t = a; a = b; b = t;
+			size_t w = awidth; awidth = bwidth; bwidth = w;
+		}
+		/* a is now the wider operand */
+		size_t width = op == '&' ? bwidth : awidth;
+		if (!width) {
+			krk_long_clear(res);
+			return 0;
+		}
+		krk_long_resize(res, width);
+		uint32_t * out = res->digits;
+		const uint32_t * x = a->digits;
+		const uint32_t * y = b->digits;
+		switch (op) {
+			case '|': for (size_t i = 0; i < bwidth; ++i) out[i] = x[i] | y[i]; break;
+			case '^': for (size_t i = 0; i < bwidth; ++i) out[i] = x[i] ^ y[i]; break;
+			case '&': for (size_t i = 0; i < bwidth; ++i) out[i] = x[i] & y[i]; break;
+		}
+		if (width > bwidth) memcpy(out + bwidth, x + bwidth, sizeof(uint32_t) * (width - bwidth));
+		krk_long_trim(res);
+		return 0;
+	}
+
 	switch (op) {
 		case '|': rneg = aneg | bneg; break;
 		case '^': rneg = aneg ^ bneg; break;
@@ -981,17 +1511,100 @@ static uint32_t _div_inplace(KrkLong * a, uint32_t base) {
 	return remainder;
 }
 
+#ifndef CONVERT_CUTOFF
+#define CONVERT_CUTOFF 30
+#endif
+
 /**
- * @brief Convert a long to a string in a given base.
+ * @brief Find the largest power of @p base that fits in one digit.
+ *
+ * Conversions in bases that are not powers of two work in "chunks" of
+ * @p per characters, so each step costs one digit-sized multiply or
+ * divide rather than one per character.
  */
-static char * krk_long_to_str(const KrkLong * n, int _base, const char * prefix, size_t *size) {
-	static const char vals[] = "0123456789abcdef";
-	KrkLong abs;
+static uint32_t _chunk_base(unsigned int base, int * per) {
+	uint32_t out = base;
+	*per = 1;
+	while ((uint64_t)out * base <= DIGIT_MAX) {
+		out *= base;
+		(*per)++;
+	}
+	return out;
+}
 
-	krk_long_init_si(&abs, 0);
-	krk_long_abs(&abs, n);
+/**
+ * @brief Lazily-computed powers @c chunk**(2**i) for divide-and-conquer
+ *        base conversion.
+ */
+struct PowerTable {
+	uint32_t chunk;
+	size_t count;
+	KrkLong pow[64];
+};
 
-	int sign = krk_long_sign(n);   /* -? +? 0? */
+static const KrkLong * _power(struct PowerTable * table, size_t i) {
+	while (table->count <= i) {
+		KrkLong * next = &table->pow[table->count];
+		if (table->count == 0) {
+			krk_long_init_ui(next, table->chunk);
+		} else {
+			krk_long_init_si(next, 0);
+			krk_long_mul(next, next - 1, next - 1);
+		}
+		table->count++;
+	}
+	return &table->pow[i];
+}
+
+static void _power_table_clear(struct PowerTable * table) {
+	for (size_t i = 0; i < table->count; ++i) {
+		krk_long_clear(&table->pow[i]);
+	}
+}
+
+/**
+ * @brief Split a non-negative long into chunks, least significant first.
+ *
+ * @p n must be less than @c chunk**(2**(level+1)) and is destroyed. If
+ * @p pad is set, exactly @c 2**(level+1) chunks are written; otherwise
+ * the most significant chunk is nonzero. Splitting around the middle power
+ * keeps each division balanced, which makes this subquadratic.
+ */
+static size_t _to_chunks(KrkLong * n, struct PowerTable * table, int level, uint32_t * out, int pad) {
+	size_t count = 0;
+
+	/* Without padding, skip levels that would only produce zero chunks. */
+	if (!pad) while (level >= 0 && krk_long_compare_abs(n, _power(table, level)) < 0) level--;
+
+	if (level < 0 || n->width < CONVERT_CUTOFF) {
+		while (n->width) out[count++] = _div_inplace(n, table->chunk);
+		if (pad) while (count < ((size_t)1 << (level + 1))) out[count++] = 0;
+		return count;
+	}
+
+	KrkLong quot, rem;
+	krk_long_init_many(&quot, &rem, NULL);
+	krk_long_div_rem(&quot, &rem, n, _power(table, level));
+
+	size_t half = (size_t)1 << level;
+	_to_chunks(&rem, table, level - 1, out, 1);
+	count = half + _to_chunks(&quot, table, level - 1, out + half, pad);
+
+	krk_long_clear_many(&quot, &rem, NULL);
+	return count;
+}
+
+/**
+ * @brief Convert a long to a string in a given base.
+ */
+static char * krk_long_to_str(const KrkLong * n, int _base, const char * prefix, size_t *size) {
+	static const char vals[] = "0123456789abcdef";
+	KrkLong abs;
+
+	krk_long_init_si(&abs, 0);
+	krk_long_abs(&abs, n);
+
+	int sign = krk_long_sign(n);   /* -? +? 0? */
 
 	size_t len = (sign == -1 ? 1 : 0) + krk_long_digits_in_base(&abs,_base) + strlen(prefix) + 1;
 	char * tmp = malloc(len);
@@ -999,11 +1612,43 @@ static char * krk_long_to_str(const KrkLong * n, int _base, const char * prefix,
 
 	if (sign == 0) {
 		*writer++ = '0';
+	} else if (!(_base & (_base - 1))) {
+		/* Powers of two can just read out the bits. */
+		int bits = __builtin_ctz(_base);
+		size_t total = _bits_in(&abs);
+		for (size_t i = 0; i < total; i += bits) {
+			size_t digit = i / DIGIT_SHIFT, offset = i % DIGIT_SHIFT;
+			uint64_t window = abs.digits[digit] >> offset;
+			if (offset + bits > DIGIT_SHIFT && digit + 1 < (size_t)abs.width) {
+				window |= (uint64_t)abs.digits[digit+1] << (DIGIT_SHIFT - offset);
+			}
+			*writer++ = vals[window & (_base - 1)];
+		}
 	} else {
-		while (krk_long_sign(&abs) > 0) {
-			uint32_t rem = _div_inplace(&abs,_base);
-			*writer++ = vals[rem];
+		int per;
+		struct PowerTable table = {0};
+		table.chunk = _chunk_base(_base, &per);
+
+		/* Find a level where abs < chunk**(2**(level+1)) */
+		int level = -1;
+		if (abs.width >= CONVERT_CUTOFF) {
+			level = 0;
+			while (2 * (size_t)(_power(&table, level)->width - 1) < (size_t)abs.width) level++;
 		}
+
+		uint32_t * chunks = malloc(sizeof(uint32_t) * (krk_long_digits_in_base(&abs,_base) / per + 2));
+		size_t count = _to_chunks(&abs, &table, level, chunks, 0);
+
+		for (size_t i = 0; i < count; ++i) {
+			uint32_t chunk = chunks[i];
+			for (int j = 0; j < per && (chunk || i + 1 < count); ++j) {
+				*writer++ = vals[chunk % _base];
+				chunk /= _base;
+			}
+		}
+
+		free(chunks);
+		_power_table_clear(&table);
 	}
 
 	while (*prefix) { *writer++ = *prefix++; }
@@ -1055,6 +1700,44 @@ static int is_whitespace(char c) {
 	return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
 }
 
+/**
+ * @brief Build a long from chunks, least significant first.
+ *
+ * Short runs use Horner's rule with a single-digit multiply-add per chunk;
+ * longer ones are split at a power-of-two chunk count so that the halves
+ * can be combined with one large multiply by a shared power.
+ */
+static void _from_chunks(KrkLong * out, const uint32_t * chunks, size_t n, struct PowerTable * table) {
+	if (n < CONVERT_CUTOFF) {
+		size_t width = 0;
+		krk_long_resize(out, n + 1);
+		for (size_t i = n; i > 0; --i) {
+			uint64_t carry = chunks[i-1];
+			for (size_t j = 0; j < width; ++j) {
+				carry += (uint64_t)out->digits[j] * table->chunk;
+				out->digits[j] = carry & DIGIT_MAX;
+				carry >>= DIGIT_SHIFT;
+			}
+			if (carry) out->digits[width++] = carry;
+		}
+		out->width = width;
+		if (!width) krk_long_clear(out);
+		return;
+	}
+
+	size_t level = 0;
+	while (((size_t)2 << level) < n) level++;
+	size_t low = (size_t)1 << level;
+
+	KrkLong high;
+	krk_long_init_si(&high, 0);
+	_from_chunks(&high, chunks + low, n - low, table);
+	_from_chunks(out, chunks, low, table);
+	krk_long_mul(&high, &high, _power(table, level));
+	krk_long_add(out, out, &high);
+	krk_long_clear(&high);
+}
+
 /**
  * @brief Parse a number into a long.
  *
@@ -1068,6 +1751,8 @@ static int krk_long_parse_string(const char * str, KrkLong * num, unsigned int b
 	const char * c = str;
 	int sign = 1;
 
+	krk_long_init_si(num, 0);
+
 	/* Skip any leading whitespace */
 	while (c < end && is_whitespace(*c)) c++;
 
@@ -1099,7 +1784,6 @@ static int krk_long_parse_string(const char * str, KrkLong * num, unsigned int b
 
 			if (c == end) {
 				/* If we saw just '0', that's fine... */
-				krk_long_init_si(num, 0);
 				return 0;
 			}
 
@@ -1122,39 +1806,57 @@ static int krk_long_parse_string(const char * str, KrkLong * num, unsigned int b
 		return 1;
 	}
 
-	krk_long_init_si(num, 0);
-
-	KrkLong _base, scratch;
-	krk_long_init_si(&_base, 0);
-	krk_long_init_si(&scratch, 0);
-
+	/* Collect and validate the digits first, dropping underscores. */
+	char * digits = malloc(end - c);
+	size_t count = 0;
 	while (c < end && *c) {
-		uint64_t accum = 0;
-		uint64_t basediv = 1;
-		while (c < end && *c && (basediv * base < 0x10000000000000UL)) {
-			if (*c == '_') c++;
-			if (c == (str + len) || !is_valid(base, *c)) {
-				krk_long_clear_many(&_base, &scratch, num, NULL);
-				return 1;
-			}
+		if (*c == '_') c++;
+		if (c == end || !is_valid(base, *c)) {
+			free(digits);
+			return 1;
+		}
+		digits[count++] = convert_digit(*c);
+		c++;
+	}
 
-			basediv *= base;
-			accum *= base;
-			accum += convert_digit(*c);
-			c++;
+	if (!(base & (base - 1))) {
+		/* Powers of two can place each character's bits directly. */
+		int bits = __builtin_ctz(base);
+		size_t width = (count * bits) / DIGIT_SHIFT + 1;
+		krk_long_resize(num, width);
+		memset(num->digits, 0, sizeof(uint32_t) * width);
+		for (size_t i = 0; i < count; ++i) {
+			size_t bit = i * bits;
+			uint64_t value = (uint64_t)digits[count - i - 1] << (bit % DIGIT_SHIFT);
+			num->digits[bit / DIGIT_SHIFT] |= value & DIGIT_MAX;
+			if (value >> DIGIT_SHIFT) num->digits[bit / DIGIT_SHIFT + 1] |= value >> DIGIT_SHIFT;
 		}
-		krk_long_init_ui(&_base, basediv);
-		krk_long_mul(num, num, &_base);
-		krk_long_clear_many(&scratch, &_base, NULL);
-		krk_long_init_ui(&scratch, accum);
-		krk_long_add(num, num, &scratch);
+		krk_long_trim(num);
+	} else {
+		/* Everything else is read in chunks, least significant first. */
+		int per;
+		struct PowerTable table = {0};
+		table.chunk = _chunk_base(base, &per);
+		size_t nchunks = (count + per - 1) / per;
+		uint32_t * chunks = malloc(sizeof(uint32_t) * nchunks);
+		for (size_t i = 0; i < nchunks; ++i) {
+			size_t stop = count - i * per;
+			size_t start = stop > (size_t)per ? stop - per : 0;
+			uint32_t value = 0;
+			for (size_t j = start; j < stop; ++j) value = value * base + digits[j];
+			chunks[i] = value;
+		}
+		_from_chunks(num, chunks, nchunks, &table);
+		free(chunks);
+		_power_table_clear(&table);
 	}
 
+	free(digits);
+
 	if (sign == -1) {
 		krk_long_set_sign(num, -1);
 	}
 
-	krk_long_clear_many(&_base, &scratch, NULL);
 	return 0;
 }
 
@@ -1163,6 +1865,7 @@ typedef KrkLong krk_long[1];
 struct BigInt {
 	KrkInstance inst;
 	krk_long value;
+	uint32_t small[2]; /**< Inline digits for values of up to two digits */
 };
 
 #define AS_long(o) ((struct BigInt *)AS_OBJECT(o))
@@ -1171,12 +1874,30 @@ struct BigInt {
 #define CURRENT_CTYPE struct BigInt *
 #define CURRENT_NAME  self
 
+/**
+ * @brief Give a long object ownership of the digits in @p val.
+ *
+ * Values of up to two digits - 64-bit hashes, microsecond timestamps -
+ * are moved into the object itself so they don't hold a separate allocation.
+ */
+static void _long_take(struct BigInt * self, KrkLong * val) {
+	if (val->width && val->width >= -2 && val->width <= 2) {
+		memcpy(self->small, val->digits, sizeof(uint32_t) * (val->width < 0 ? -val->width : val->width));
+		free(val->digits);
+		self->value->width = val->width;
+		self->value->digits = self->small;
+	} else {
+		*self->value = *val;
+	}
+}
+
 static void make_long(krk_integer_type t, struct BigInt * self) {
 	krk_long_init_si(self->value, t);
 }
 
 static void _long_gcsweep(KrkInstance * self) {
-	krk_long_clear(((struct BigInt*)self)->value);
+	struct BigInt * _self = (struct BigInt*)self;
+	if (_self->value->digits != _self->small) krk_long_clear(_self->value);
 }
 
 KRK_Method(long,__init__) {
@@ -1198,6 +1919,8 @@ KRK_Method(long,__init__) {
 		return krk_runtimeError(vm.exceptions->typeError, "%s() argument must be a string or a number, not '%T'", "int", argv[1]);
 	}
 	/* our value should be set */
+	KrkLong value = *self->value;
+	_long_take(self, &value);
 	return argv[0];
 }
 
@@ -1294,7 +2017,7 @@ static KrkValue make_long_obj(KrkLong * val) {
 		maybe = -(((uint64_t)val->digits[1] << 31) | val->digits[0]);
 	} else {
 		krk_push(OBJECT_VAL(krk_newInstance(KRK_BASE_CLASS(long))));
-		*AS_long(krk_peek(0))->value = *val;
+		_long_take(AS_long(krk_peek(0)), val);
 		return krk_pop();
 	}
 
@@ -1311,31 +2034,191 @@ KrkValue krk_parse_int(const char * start, size_t width, unsigned int base) {
 	return make_long_obj(&_value);
 }
 
+/**
+ * @brief Build a long of up to two digits without going through a KrkLong.
+ */
+static KrkValue make_small_long(uint64_t abs, int negative) {
+	struct BigInt * self = (struct BigInt*)krk_newInstance(KRK_BASE_CLASS(long));
+	self->small[0] = abs & DIGIT_MAX;
+	self->small[1] = abs >> DIGIT_SHIFT;
+	self->value->width = (self->small[1] ? 2 : 1) * (negative ? -1 : 1);
+	self->value->digits = self->small;
+	return OBJECT_VAL(self);
+}
+
+KrkValue krk_int_from_int64(int64_t val) {
+	if (val >= -0x800000000000LL && val <= 0x7FFFFFFFFFFFLL) return INTEGER_VAL(val);
+	uint64_t abs = val < 0 ? -(uint64_t)val : (uint64_t)val;
+	if (!(abs >> (2 * DIGIT_SHIFT))) return make_small_long(abs, val < 0);
+	KrkLong _value;
+	krk_long_init_si(&_value, val);
+	return make_long_obj(&_value);
+}
+
+KrkValue krk_int_from_uint64(uint64_t val) {
+	if (val <= 0x7FFFFFFFFFFFULL) return INTEGER_VAL(val);
+	if (!(val >> (2 * DIGIT_SHIFT))) return make_small_long(val, 0);
+	KrkLong _value;
+	krk_long_init_ui(&_value, val);
+	return make_long_obj(&_value);
+}
+
+/* Magnitude of an int or long, if it fits in 64 bits; sign is 1 for negatives. */
+static int int_magnitude(KrkValue val, uint64_t * out, int * sign) {
+	if (IS_INTEGER(val)) {
+		krk_integer_type i = AS_INTEGER(val);
+		*sign = i < 0;
+		*out = i < 0 ? -(uint64_t)i : (uint64_t)i;
+		return 1;
+	}
+	if (!IS_long(val)) return 0;
+	KrkLong * num = AS_long(val)->value;
+	size_t width = num->width < 0 ? -num->width : num->width;
+	if (width > 3 || (width == 3 && num->digits[2] > 3)) return 0;
+	uint64_t mag = 0;
+	for (size_t i = width; i > 0; --i) mag = (mag << DIGIT_SHIFT) | num->digits[i-1];
+	*out = mag;
+	*sign = num->width < 0;
+	return 1;
+}
+
+int krk_int_to_int64(KrkValue val, int64_t * out) {
+	uint64_t mag;
+	int sign;
+	if (!int_magnitude(val, &mag, &sign)) return 0;
+	if (sign ? mag > (uint64_t)INT64_MAX + 1 : mag > INT64_MAX) return 0;
+	*out = sign ? (int64_t)(0 - mag) : (int64_t)mag;
+	return 1;
+}
+
+int krk_int_to_uint64(KrkValue val, uint64_t * out) {
+	uint64_t mag;
+	int sign;
+	if (!int_magnitude(val, &mag, &sign) || (sign && mag)) return 0;
+	*out = mag;
+	return 1;
+}
+
 KRK_Method(long,__int__) {
 	return INTEGER_VAL(krk_long_medium(self->value));
 }
 
+/**
+ * @brief Get the value of an int, or of a long of at most two digits.
+ *
+ * Either way the magnitude is below 2**62, so sums and differences
+ * of two such values can not overflow.
+ */
+static int _small_value(KrkValue val, int64_t * out) {
+	if (IS_INTEGER(val)) {
+		*out = AS_INTEGER(val);
+		return 1;
+	}
+	if (!IS_long(val)) return 0;
+	KrkLong * num = AS_long(val)->value;
+	switch (num->width) {
+		case 0:  *out = 0; return 1;
+		case 1:  *out = num->digits[0]; return 1;
+		case -1: *out = -(int64_t)num->digits[0]; return 1;
+		case 2:  *out = ((int64_t)num->digits[1] << DIGIT_SHIFT) | num->digits[0]; return 1;
+		case -2: *out = -(((int64_t)num->digits[1] << DIGIT_SHIFT) | num->digits[0]); return 1;
+	}
+	return 0;
+}
+
+/*
+ * Fast paths for operands that fit in 64 bits. Each returns 0 if the
+ * result would overflow or needs an error raised, in which case the
+ * caller falls back to the general implementation.
+ */
+static int _small_add(int64_t a, int64_t b, int64_t * out) { *out = a + b; return 1; }
+static int _small_sub(int64_t a, int64_t b, int64_t * out) { *out = a - b; return 1; }
+static int _small_or (int64_t a, int64_t b, int64_t * out) { *out = a | b; return 1; }
+static int _small_xor(int64_t a, int64_t b, int64_t * out) { *out = a ^ b; return 1; }
+static int _small_and(int64_t a, int64_t b, int64_t * out) { *out = a & b; return 1; }
+
+static int _small_mul(int64_t a, int64_t b, int64_t * out) {
+#ifndef __TINYC__
+	return !__builtin_mul_overflow(a, b, out);
+#else
+	if ((int32_t)a != a || (int32_t)b != b) return 0;
+	*out = a * b;
+	return 1;
+#endif
+}
+
+static int _small_floordiv(int64_t a, int64_t b, int64_t * out) {
+	if (!b) return 0;
+	*out = a / b - ((a % b) && ((a < 0) != (b < 0)));
+	return 1;
+}
+
+static int _small_mod(int64_t a, int64_t b, int64_t * out) {
+	if (!b) return 0;
+	int64_t rem = a % b;
+	*out = (rem && ((rem < 0) != (b < 0))) ? rem + b : rem;
+	return 1;
+}
+
+static int _small_lshift(int64_t a, int64_t b, int64_t * out) {
+	if (b < 0 || b > 62) return 0;
+	int64_t limit = (int64_t)1 << (62 - b);
+	if (a >= limit || a < -limit) return 0;
+	*out = a * ((int64_t)1 << b);
+	return 1;
+}
+
+static int _small_rshift(int64_t a, int64_t b, int64_t * out) {
+	if (b < 0) return 0;
+	*out = b > 62 ? (a < 0 ? -1 : 0) : (a >> b);
+	return 1;
+}
+
+static int _small_pow(int64_t a, int64_t b, int64_t * out) {
+	if (b < 0) return 0;
+	int64_t result = 1;
+	while (b) {
+		if ((b & 1) && !_small_mul(result, a, &result)) return 0;
+		b >>= 1;
+		if (b && !_small_mul(a, a, &a)) return 0;
+	}
+	*out = result;
+	return 1;
+}
+
 #define BASIC_BIN_OP_FLOATS(name, long_func, MAYBE_FLOAT, MAYBE_FLOAT_INV) \
 	KRK_Method(long,__ ## name ## __) { \
-		krk_long tmp; \
-		if (IS_long(argv[1])) krk_long_init_copy(tmp, AS_long(argv[1])->value); \
-		else if (IS_INTEGER(argv[1])) krk_long_init_si(tmp, AS_INTEGER(argv[1])); \
+		int64_t a, b, result; \
+		if (_small_value(argv[0], &a) && _small_value(argv[1], &b) && _small_ ## name(a, b, &result)) return krk_int_from_int64(result); \
+		krk_long tmp, other; \
+		const KrkLong * rhs = other; \
+		if (IS_long(argv[1])) rhs = AS_long(argv[1])->value; \
+		else if (IS_INTEGER(argv[1])) krk_long_init_si(other, AS_INTEGER(argv[1])); \
 		MAYBE_FLOAT \
 		else return NOTIMPL_VAL(); \
-		long_func(tmp,self->value,tmp); \
+		krk_long_init_si(tmp, 0); \
+		long_func(tmp,self->value,rhs); \
+		if (rhs == other) krk_long_clear(other); \
 		return make_long_obj(tmp); \
 	} \
 	KRK_Method(long,__r ## name ## __) { \
-		krk_long tmp; \
-		if (IS_long(argv[1])) krk_long_init_copy(tmp, AS_long(argv[1])->value); \
-		else if (IS_INTEGER(argv[1])) krk_long_init_si(tmp, AS_INTEGER(argv[1])); \
+		int64_t a, b, result; \
+		if (_small_value(argv[1], &a) && _small_value(argv[0], &b) && _small_ ## name(a, b, &result)) return krk_int_from_int64(result); \
+		krk_long tmp, other; \
+		const KrkLong * lhs = other; \
+		if (IS_long(argv[1])) lhs = AS_long(argv[1])->value; \
+		else if (IS_INTEGER(argv[1])) krk_long_init_si(other, AS_INTEGER(argv[1])); \
 		MAYBE_FLOAT_INV \
 		else return NOTIMPL_VAL(); \
-		long_func(tmp,tmp,self->value); \
+		krk_long_init_si(tmp, 0); \
+		long_func(tmp,lhs,self->value); \
+		if (lhs == other) krk_long_clear(other); \
 		return make_long_obj(tmp); \
 	} \
 	_noexport \
 	KrkValue krk_long_coerced_ ## name (krk_integer_type a, krk_integer_type b) { \
+		int64_t result; \
+		if (_small_ ## name(a, b, &result)) return krk_int_from_int64(result); \
 		krk_long tmp_res, tmp_a, tmp_b; \
 		krk_long_init_si(tmp_res, 0); \
 		krk_long_init_si(tmp_a, a); \
@@ -1357,41 +2240,105 @@ BASIC_BIN_OP(or, krk_long_or)
 BASIC_BIN_OP(xor,krk_long_xor)
 BASIC_BIN_OP(and,krk_long_and)
 
-static void _krk_long_lshift(krk_long out, krk_long val, krk_long shift) {
-	if (krk_long_sign(shift) < 0) { krk_runtimeError(vm.exceptions->valueError, "negative shift count"); return; }
-	krk_long multiplier;
-	krk_long_init_si(multiplier,0);
-	krk_long_bit_set(multiplier, krk_long_medium(shift));
-	krk_long_mul(out,val,multiplier);
-	krk_long_clear(multiplier);
+/**
+ * @brief Get a shift count, which must be non-negative.
+ *
+ * Counts that do not fit in 62 bits are reported as -1; no value could
+ * be shifted left that far, and anything shifted right that far is 0 or -1.
+ */
+static int _shift_count(const KrkLong * shift, int64_t * out) {
+	if (krk_long_sign(shift) < 0) {
+		krk_runtimeError(vm.exceptions->valueError, "negative shift count");
+		return 0;
+	}
+	*out = shift->width > 2 ? -1 : krk_long_medium(shift);
+	return 1;
 }
 
-static void _krk_long_rshift(krk_long out, krk_long val, krk_long shift) {
-	if (krk_long_sign(shift) < 0) { krk_runtimeError(vm.exceptions->valueError, "negative shift count"); return; }
-	krk_long multiplier, garbage;
-	krk_long_init_many(multiplier,garbage,NULL);
-	krk_long_bit_set(multiplier, krk_long_medium(shift));
-	krk_long_div_rem(out,garbage,val,multiplier);
-	krk_long_clear_many(multiplier,garbage,NULL);
+/**
+ * @brief Replace the value of @p out with the @p n digits in @p d, which it takes ownership of.
+ */
+static void _long_adopt_digits(KrkLong * out, uint32_t * d, size_t n, int negative) {
+	krk_long_clear(out);
+	out->digits = d;
+	out->width = n;
+	krk_long_trim(out);
+	if (negative) krk_long_set_sign(out, -1);
 }
 
-static void _krk_long_mod(krk_long out, krk_long a, krk_long b) {
-	if (krk_long_sign(b) == 0) { krk_runtimeError(vm.exceptions->valueError, "integer division or modulo by zero"); return; }
+static void _krk_long_lshift(krk_long out, const KrkLong * val, const KrkLong * shift) {
+	int64_t count;
+	if (!_shift_count(shift, &count)) return;
+	size_t width = val->width < 0 ? -val->width : val->width;
+	if (!width) {
+		krk_long_clear(out);
+		return;
+	}
+	if (count < 0 || (uint64_t)count / DIGIT_SHIFT > (SIZE_MAX / sizeof(uint32_t)) - width - 1) {
+		krk_runtimeError(vm.exceptions->valueError, "shift count too large");
+		return;
+	}
+
+	/* Whole digits move up; the remaining bits shift across neighbouring digits. */
+	size_t digits = count / DIGIT_SHIFT;
+	uint32_t * d = malloc(sizeof(uint32_t) * (width + digits + 1));
+	memset(d, 0, sizeof(uint32_t) * digits);
+	d[width + digits] = _digits_shl(d + digits, val->digits, width, count % DIGIT_SHIFT);
+	_long_adopt_digits(out, d, width + digits + 1, val->width < 0);
+}
+
+static void _krk_long_rshift(krk_long out, const KrkLong * val, const KrkLong * shift) {
+	int64_t count;
+	if (!_shift_count(shift, &count)) return;
+	size_t width = val->width < 0 ? -val->width : val->width;
+	int negative = val->width < 0;
+	size_t digits = count < 0 ? SIZE_MAX : (uint64_t)count / DIGIT_SHIFT;
+	int bits = count < 0 ? 0 : count % DIGIT_SHIFT;
+
+	if (digits >= width) {
+		krk_long_clear(out);
+		krk_long_init_si(out, negative ? -1 : 0);
+		return;
+	}
+
+	/* Negative values round towards negative infinity, so if any
+	 * bits set in the magnitude were shifted out, add one to it. */
+	int inexact = 0;
+	if (negative) {
+		for (size_t i = 0; i < digits && !inexact; ++i) inexact = !!val->digits[i];
+		if (val->digits[digits] & (((uint32_t)1 << bits) - 1)) inexact = 1;
+	}
+
+	size_t n = width - digits;
+	uint32_t * d = malloc(sizeof(uint32_t) * (n + 1));
+	_digits_shr(d, val->digits + digits, n, bits);
+	d[n] = 0;
+	if (inexact) {
+		for (size_t i = 0; i <= n; ++i) {
+			if (++d[i] <= DIGIT_MAX) break;
+			d[i] = 0;
+		}
+	}
+	_long_adopt_digits(out, d, n + 1, negative);
+}
+
+static void _krk_long_mod(krk_long out, const KrkLong * a, const KrkLong * b) {
+	if (krk_long_sign(b) == 0) { krk_runtimeError(vm.exceptions->zeroDivisionError, "integer division or modulo by zero"); return; }
 	krk_long garbage;
 	krk_long_init_si(garbage,0);
 	krk_long_div_rem(garbage,out,a,b);
 	krk_long_clear(garbage);
 }
 
-static void _krk_long_div(krk_long out, krk_long a, krk_long b) {
-	if (krk_long_sign(b) == 0) { krk_runtimeError(vm.exceptions->valueError, "integer division or modulo by zero"); return; }
+static void _krk_long_div(krk_long out, const KrkLong * a, const KrkLong * b) {
+	if (krk_long_sign(b) == 0) { krk_runtimeError(vm.exceptions->zeroDivisionError, "integer division or modulo by zero"); return; }
 	krk_long garbage;
 	krk_long_init_si(garbage,0);
 	krk_long_div_rem(out,garbage,a,b);
 	krk_long_clear(garbage);
 }
 
-static void _krk_long_pow(krk_long out, krk_long a, krk_long b) {
+static void _krk_long_pow(krk_long out, const KrkLong * a, const KrkLong * b) {
 	if (krk_long_sign(b) == 0) {
 		krk_long_clear(out);
 		krk_long_init_si(out, 1);
@@ -1456,6 +2403,295 @@ BASIC_BIN_OP(mod,_krk_long_mod)
 BASIC_BIN_OP(floordiv,_krk_long_div)
 BASIC_BIN_OP(pow,_krk_long_pow)
 
+/**
+ * @brief State for multiplication modulo a fixed positive modulus.
+ *
+ * Odd moduli of more than one digit use Montgomery form: values are
+ * kept as @c x*R mod m with @c R = 2**(31*n), and each product is reduced
+ * one digit at a time by adding multiples of the modulus rather than
+ * through a full division.
+ */
+struct ModContext {
+	const KrkLong * mod;
+	size_t width;
+	int montgomery;
+	uint32_t minv;    /* -1/m mod 2**31 */
+	uint32_t * work;  /* 2*width+1 digits for Montgomery reduction */
+	KrkLong product, garbage;
+};
+
+static void _mod_init(struct ModContext * ctx, const KrkLong * mod) {
+	ctx->mod = mod;
+	ctx->width = mod->width;
+	ctx->montgomery = mod->width > 1 && (mod->digits[0] & 1);
+	ctx->work = NULL;
+	krk_long_init_many(&ctx->product, &ctx->garbage, NULL);
+	if (ctx->montgomery) {
+		/* Newton's iteration doubles the number of correct low bits each step. */
+		uint32_t m0 = mod->digits[0], inv = m0;
+		for (int i = 0; i < 5; ++i) inv *= 2 - m0 * inv;
+		ctx->minv = (-inv) & DIGIT_MAX;
+		ctx->work = malloc(sizeof(uint32_t) * (2 * ctx->width + 1));
+	}
+}
+
+static void _mod_clear(struct ModContext * ctx) {
+	free(ctx->work);
+	krk_long_clear_many(&ctx->product, &ctx->garbage, NULL);
+}
+
+/**
+ * @brief Montgomery reduction: set @p out to @c t/R mod m for @c t < m*R.
+ */
+static void _mod_redc(struct ModContext * ctx, KrkLong * out, const KrkLong * t) {
+	size_t n = ctx->width;
+	uint32_t * T = ctx->work;
+	const uint32_t * m = ctx->mod->digits;
+	memset(T, 0, sizeof(uint32_t) * (2 * n + 1));
+	memcpy(T, t->digits, sizeof(uint32_t) * t->width);
+
+	for (size_t i = 0; i < n; ++i) {
+		uint32_t u = ((uint64_t)T[i] * ctx->minv) & DIGIT_MAX;
+		uint64_t carry = 0;
+		for (size_t j = 0; j < n; ++j) {
+			carry += (uint64_t)u * m[j] + T[i+j];
+			T[i+j] = carry & DIGIT_MAX;
+			carry >>= DIGIT_SHIFT;
+		}
+		for (size_t k = i + n; carry; ++k) {
+			carry += T[k];
+			T[k] = carry & DIGIT_MAX;
+			carry >>= DIGIT_SHIFT;
+		}
+	}
+
+	_long_set_digits(out, T + n, n + 1);
+	if (krk_long_compare_abs(out, ctx->mod) >= 0) krk_long_sub(out, out, ctx->mod);
+}
+
+/**
+ * @brief Set @p out to the product of @p x and @p y, both already reduced.
+ */
+static void _mod_mul(struct ModContext * ctx, KrkLong * out, const KrkLong * x, const KrkLong * y) {
+	krk_long_mul(&ctx->product, x, y);
+	if (ctx->montgomery) {
+		_mod_redc(ctx, out, &ctx->product);
+	} else {
+		krk_long_div_rem(&ctx->garbage, out, &ctx->product, ctx->mod);
+	}
+}
+
+/**
+ * @brief Move a reduced value into the representation used by @p ctx.
+ */
+static void _mod_enter(struct ModContext * ctx, KrkLong * out, const KrkLong * in) {
+	if (ctx->montgomery) {
+		_long_shift_digits(&ctx->product, in, ctx->width);
+		krk_long_div_rem(&ctx->garbage, out, &ctx->product, ctx->mod);
+	} else if (out != in) {
+		krk_long_clear(out);
+		krk_long_init_copy(out, in);
+	}
+}
+
+/**
+ * @brief Inverse of @p a modulo @p m, for 0 <= @p a < @p m.
+ *
+ * @return 0 if there is no inverse.
+ */
+static int _long_mod_inverse(KrkLong * out, const KrkLong * a, const KrkLong * m) {
+	krk_long r0, r1, t0, t1, quot, rem, tmp;
+	krk_long_init_copy(r0, m);
+	krk_long_init_copy(r1, a);
+	krk_long_init_si(t0, 0);
+	krk_long_init_si(t1, 1);
+	krk_long_init_many(quot, rem, tmp, NULL);
+
+	/* Extended Euclid, keeping only the coefficient of a. */
+	while (r1->width) {
+		krk_long_div_rem(quot, rem, r0, r1);
+		_swap(r0, r1);
+		_swap(r1, rem);
+		krk_long_mul(tmp, quot, t1);
+		krk_long_sub(tmp, t0, tmp);
+		_swap(t0, t1);
+		_swap(t1, tmp);
+	}
+
+	int invertible = r0->width == 1 && r0->digits[0] == 1;
+	if (invertible) {
+		if (t0->width < 0) krk_long_add(t0, t0, m);
+		krk_long_clear(out);
+		_swap(out, t0);
+	}
+
+	krk_long_clear_many(r0, r1, t0, t1, quot, rem, tmp, NULL);
+	return invertible;
+}
+
+/**
+ * @brief Compute @p base ** @p exp mod @p mod for non-negative @p base < @p mod.
+ *
+ * Left-to-right sliding window exponentiation (HAC 14.85): the exponent
+ * is consumed in windows of up to @c k bits ending in a set bit, each
+ * costing one multiply by a precomputed odd power of @p base.
+ */
+static void _long_pow_mod(KrkLong * out, const KrkLong * base, const KrkLong * exp, const KrkLong * mod) {
+	struct ModContext ctx;
+	_mod_init(&ctx, mod);
+
+	size_t bits = _bits_in(exp);
+	int k = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 6 ? 2 : 1;
+
+	/* Odd powers base**1, base**3, ... base**(2**k-1) */
+	size_t count = (size_t)1 << (k - 1);
+	KrkLong * table = malloc(sizeof(KrkLong) * count);
+	KrkLong square;
+	krk_long_init_si(&table[0], 0);
+	krk_long_init_si(&square, 0);
+	_mod_enter(&ctx, &table[0], base);
+	_mod_mul(&ctx, &square, &table[0], &table[0]);
+	for (size_t i = 1; i < count; ++i) {
+		krk_long_init_si(&table[i], 0);
+		_mod_mul(&ctx, &table[i], &table[i-1], &square);
+	}
+
+	krk_long result;
+	krk_long_init_si(result, 0);
+	int started = 0;
+
+	for (ssize_t i = bits - 1; i >= 0; ) {
+		if (!_bit_is_set(exp, i)) {
+			if (started) _mod_mul(&ctx, result, result, result);
+			i--;
+			continue;
+		}
+
+		/* Find the longest window of at most k bits ending in a set bit. */
+		ssize_t low = i - k + 1 < 0 ? 0 : i - k + 1;
+		while (!_bit_is_set(exp, low)) low++;
+		size_t window = 0;
+		for (ssize_t j = i; j >= low; --j) window = (window << 1) | _bit_is_set(exp, j);
+
+		if (started) {
+			for (ssize_t j = i; j >= low; --j) _mod_mul(&ctx, result, result, result);
+			_mod_mul(&ctx, result, result, &table[window >> 1]);
+		} else {
+			krk_long_init_copy(result, &table[window >> 1]);
+			started = 1;
+		}
+		i = low - 1;
+
+		if (krk_currentThread.flags & KRK_THREAD_SIGNALLED) break;
+	}
+
+	if (!started) {
+		/* exp was 0; mod is never 1 here */
+		krk_long_init_si(result, 1);
+	} else if (ctx.montgomery) {
+		_mod_redc(&ctx, result, result);
+	}
+
+	krk_long_clear(out);
+	_swap(out, result);
+
+	for (size_t i = 0; i < count; ++i) krk_long_clear(&table[i]);
+	free(table);
+	krk_long_clear(&square);
+	_mod_clear(&ctx);
+}
+
+/**
+ * @brief Three-argument @c pow for ints and longs.
+ *
+ * Small moduli are handled directly in 64-bit arithmetic. A negative
+ * exponent raises the modular inverse of @p base to the matching positive
+ * power. Like Python, the result takes the sign of @p mod.
+ *
+ * @return @c NotImplemented if any argument is not an integer.
+ */
+_noexport
+KrkValue krk_long_pow_mod(KrkValue base, KrkValue exp, KrkValue mod) {
+	krk_long a, e, m;
+
+	if (!IS_INTEGER(base) && !IS_long(base)) return NOTIMPL_VAL();
+	if (!IS_INTEGER(exp) && !IS_long(exp)) return NOTIMPL_VAL();
+	if (!IS_INTEGER(mod) && !IS_long(mod)) return NOTIMPL_VAL();
+
+#define LOAD(out, val) if (IS_INTEGER(val)) krk_long_init_si(out, AS_INTEGER(val)); else krk_long_init_copy(out, AS_long(val)->value);
+	LOAD(a, base);
+	LOAD(e, exp);
+	LOAD(m, mod);
+#undef LOAD
+
+	int negative = m->width < 0;
+	krk_long_set_sign(m, 1);
+
+	if (m->width == 0) {
+		krk_long_clear_many(a, e, m, NULL);
+		return krk_runtimeError(vm.exceptions->valueError, "pow() 3rd argument cannot be 0");
+	}
+
+	/* Reduce the base into [0, m) */
+	krk_long garbage;
+	krk_long_init_si(garbage, 0);
+	krk_long_div_rem(garbage, a, a, m);
+	krk_long_clear(garbage);
+
+	if (e->width < 0) {
+		if (!_long_mod_inverse(a, a, m)) {
+			krk_long_clear_many(a, e, m, NULL);
+			return krk_runtimeError(vm.exceptions->valueError, "base is not invertible for the given modulus");
+		}
+		krk_long_set_sign(e, 1);
+	}
+
+	if (m->width == 1 && m->digits[0] == 1) {
+		krk_long_clear(a);
+	} else if (m->width == 1) {
+		/* Everything fits in 64 bits, so there's no need for long arithmetic at all. */
+		uint64_t modulus = m->digits[0];
+		uint64_t x = a->width ? a->digits[0] : 0;
+		uint64_t result = 1;
+		size_t bits = _bits_in(e);
+		for (size_t i = 0; i < bits; ++i) {
+			if (_bit_is_set(e, i)) result = result * x % modulus;
+			x = x * x % modulus;
+		}
+		krk_long_clear(a);
+		krk_long_init_ui(a, result);
+	} else {
+		_long_pow_mod(a, a, e, m);
+	}
+
+	if (krk_currentThread.flags & KRK_THREAD_SIGNALLED) {
+		krk_long_clear_many(a, e, m, NULL);
+		return NONE_VAL();
+	}
+
+	if (negative && a->width) krk_long_sub(a, a, m);
+	krk_long_clear_many(e, m, NULL);
+	return make_long_obj(a);
+}
+
+KRK_Method(long,__divmod__) {
+	krk_long quot, rem;
+	if (IS_long(argv[1])) krk_long_init_copy(rem, AS_long(argv[1])->value);
+	else if (IS_INTEGER(argv[1])) krk_long_init_si(rem, AS_INTEGER(argv[1]));
+	else return NOTIMPL_VAL();
+	if (krk_long_sign(rem) == 0) {
+		krk_long_clear(rem);
+		return krk_runtimeError(vm.exceptions->zeroDivisionError, "integer division or modulo by zero");
+	}
+	krk_long_init_si(quot, 0);
+	krk_long_div_rem(quot,rem,self->value,rem);
+	KrkTuple * out = krk_newTuple(2);
+	krk_push(OBJECT_VAL(out));
+	out->values.values[out->values.count++] = make_long_obj(quot);
+	out->values.values[out->values.count++] = make_long_obj(rem);
+	return krk_pop();
+}
+
 #define COMPARE_OP(name, comp) \
 	KRK_Method(long,__ ## name ## __) { \
 		krk_long tmp; \
@@ -1534,24 +2770,32 @@ KRK_Method(long,__format__) {
 	return result;
 }
 
-static KrkValue long_bit_count(KrkLong * val) {
+static inline int _digit_popcount(uint32_t d) {
+#ifndef __TINYC__
+	return __builtin_popcount(d);
+#else
+	d = d - ((d >> 1) & 0x55555555);
+	d = (d & 0x33333333) + ((d >> 2) & 0x33333333);
+	return (((d + (d >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+}
+
+static KrkValue long_bit_count(const KrkLong * val) {
 	size_t count = 0;
-	size_t bits = _bits_in(val);
+	size_t width = val->width < 0 ? -val->width : val->width;
 
-	for (size_t i = 0; i < bits; ++i) {
-		count += _bit_is_set(val, i);
+	for (size_t i = 0; i < width; ++i) {
+		count += _digit_popcount(val->digits[i]);
 	}
 
-	KrkLong tmp;
-	krk_long_init_ui(&tmp, count);
-	return make_long_obj(&tmp);
+	return INTEGER_VAL(count);
 }
 
 KRK_Method(long,bit_count) {
 	return long_bit_count(self->value);
 }
 
-static KrkValue long_bit_length(KrkLong * val) {
+static KrkValue long_bit_length(const KrkLong * val) {
 	size_t bits = _bits_in(val);
 	KrkLong tmp;
 	krk_long_init_ui(&tmp, bits);
@@ -1562,10 +2806,45 @@ KRK_Method(long,bit_length) {
 	return long_bit_length(self->value);
 }
 
-static KrkValue long_to_bytes(KrkLong * val, size_t argc, const KrkValue argv[], int hasKw) {
-	static const char _method_name[] = "to_bytes";
+static int _byteorder(const char * byteorder) {
+	if (!strcmp(byteorder,"little")) return 1;
+	if (!strcmp(byteorder,"big")) return -1;
+	krk_runtimeError(vm.exceptions->valueError, "byteorder must be either 'little' or 'big'");
+	return 0;
+}
+
+/**
+ * @brief Write the low @p length bytes of a value in twos-complement, least significant first.
+ *
+ * Digits are gathered into a 64-bit accumulator, so each one is read once and
+ * each byte is written once. Negative values are complemented along the way.
+ */
+static void _digits_to_bytes(uint8_t * out, size_t length, const uint32_t * d, size_t n, int negative) {
+	uint64_t accum = 0;
+	int bits = 0;
+	unsigned int carry = negative;
+	size_t j = 0;
+
+	for (size_t i = 0; i < length; ++i) {
+		if (bits < 8 && j < n) {
+			accum |= (uint64_t)d[j++] << bits;
+			bits += DIGIT_SHIFT;
+		}
+		unsigned int byte = accum & 0xFF;
+		accum >>= 8;
+		bits -= 8;
+		if (negative) {
+			byte = (byte ^ 0xFF) + carry;
+			carry = byte >> 8;
+		}
+		out[i] = byte;
+	}
+}
+
+static KrkValue long_to_bytes(const KrkLong * val, int argc, const KrkValue argv[], int hasKw) {
+	static const char * _method_name = "to_bytes";
 	/**
-	 * @fn to_bytes(length: int, byteorder: str, *, signed: bool = False) -> bytes
+	 * @fn to_bytes(length: int = 1, byteorder: str = 'big', *, signed: bool = False) -> bytes
 	 *
 	 * @param length    size of the bytes object to produce; restricted to an int; anything bigger
 	 *                  is probably going to cause trouble for repring a result anyway, so, whatever...
@@ -1573,115 +2852,147 @@ static KrkValue long_to_bytes(KrkLong * val, size_t argc, const KrkValue argv[],
 	 * @param signed    needs to be a keyword arg because apparently that's how it is in Python...
 	 *                  If a negative value is passed without @c signed=True an error will be raised.
 	 */
-
-	CHECK_ARG(1,int,krk_integer_type,length);
-	CHECK_ARG(2,str,KrkString*,byteorder);
+	int length = 1;
+	const char * byteorder = "big";
 	int _signed = 0;
-	if (hasKw) {
-		KrkValue tmp;
-		if (krk_tableGet(AS_DICT(argv[argc]), OBJECT_VAL(S("signed")), &tmp)) {
-			_signed = !krk_isFalsey(tmp);
-		}
-	}
+	if (!krk_parseArgs(".|is$p", (const char*[]){"length","byteorder","signed"}, &length, &byteorder, &_signed)) return NONE_VAL();
 
 	if (length < 0) {
 		return krk_runtimeError(vm.exceptions->valueError, "length must be non-negative");
 	}
 
-	int order = 0;
-	if (!strcmp(byteorder->chars,"little")) {
-		order = 1;
-	} else if (!strcmp(byteorder->chars,"big")) {
-		order = -1;
-	} else {
-		return krk_runtimeError(vm.exceptions->valueError, "byteorder must be either 'little' or 'big'");
-	}
+	int order = _byteorder(byteorder);
+	if (!order) return NONE_VAL();
+
+	size_t width = val->width < 0 ? -val->width : val->width;
+	int negative = val->width < 0;
 
-	if (krk_long_sign(val) < 0 && !_signed) {
+	if (negative && !_signed) {
 		return krk_runtimeError(vm.exceptions->notImplementedError, "can not convert negative value to unsigned");
 	}
 
-	/* We could avoid the copy for a positive value, but whatever... */
-	KrkLong tmp;
-	krk_long_init_ui(&tmp, 0);
-	krk_long_abs(&tmp, val);
-
-	/* Invert negative values; already checked for signed... */
-	if (krk_long_sign(val) < 0) {
-		KrkLong one;
-		krk_long_init_ui(&one, 1);
-		krk_long_sub(&tmp, &tmp, &one);
-		krk_long_clear(&one);
+	/* If it is signed, we need to reserve the top bit for the sign;
+	 * eg., (127).to_bytes(1,...,signed=True) is fine, but (128) is not.
+	 * The exception is -(2**(8*length-1)), eg. (-128), whose magnitude
+	 * is a lone bit that lands on the sign bit when complemented. As a
+	 * weird special case, 0 still has no bits even if 'signed', which
+	 * allows (0).to_bytes(0,...,signed=True). */
+	size_t bits = _bits_in(val);
+	size_t available = (size_t)length * 8;
+	int fits = bits <= available;
+	if (_signed && width && bits == available) {
+		fits = negative && !(val->digits[width-1] & (val->digits[width-1] - 1));
+		for (size_t i = 0; fits && i < width - 1; ++i) fits = !val->digits[i];
 	}
 
-	/* Use bits from inverted value */
-	size_t bitCount = _bits_in(&tmp);
-
-	/* If it is signed, we need to reserve the top bit for the sign;
-	 * eg., (127).to_bytes(1,...,signed=True) is fine, but (128) is not,
-	 * and also (-128) should work, which is taken care of by using the
-	 * inverted value... Also, as a weird special case, 0 still has no
-	 * bits even if 'signed', which allows (0).to_bytes(0,...,signed=True)
-	 * even though that makes no sense to me... */
-	if (_signed && val->width != 0) bitCount++;
-
-	if ((size_t)length * 8 < bitCount) {
-		krk_long_clear(&tmp);
+	if (!fits) {
 		/* Should be OverflowError, but we don't have that and I don't care to add it right now */
 		return krk_runtimeError(vm.exceptions->valueError, "int too big to convert");
 	}
 
-	/* Allocate bytes for final representation */
-	krk_push(OBJECT_VAL(krk_newBytes(length, NULL)));
-	memset(AS_BYTES(krk_peek(0))->bytes, 0, length);
+	KrkBytes * out = krk_newBytes(length, NULL);
+	_digits_to_bytes(out->bytes, length, val->digits, width, negative);
 
-	/* We'll use a 'bit reader':
-	 * - We want 8 bits for each byte.
-	 * - We can collect 31 bits from each digit.
-	 * - If we run out of digits, we're done.
-	 */
-	ssize_t i = 0;
-	ssize_t j = 0;
-
-	uint64_t accum = 0;
-	int32_t remaining = 0;
-	int break_here = 0;
-
-	while (i < length && !break_here) {
-		if (remaining < 8) {
-			if (j < tmp.width) {
-				accum |= ((uint64_t)tmp.digits[j]) << remaining;
-				j++;
-			} else {
-				break_here = 1;
-			}
-			remaining += 31;
+	if (order == -1) {
+		for (size_t i = 0; i < (size_t)length / 2; ++i) {
+			uint8_t t = out->bytes[i];
+			out->bytes[i] = out->bytes[length - i - 1];
+			out->bytes[length - i - 1] = t;
 		}
+	}
 
-		uint8_t byte = accum & 0xFF;
-		accum >>= 8;
-		remaining -= 8;
+	return OBJECT_VAL(out);
+}
 
-		AS_BYTES(krk_peek(0))->bytes[order == 1 ? i : (length - i - 1)] = byte;
-		i++;
+KRK_Method(long,to_bytes) {
+	return long_to_bytes(self->value, argc, argv, hasKw);
+}
+
+/**
+ * @brief Build an int from @p n bytes of twos-complement or unsigned data.
+ *
+ * Up to eight bytes are assembled directly into a 64-bit value. Longer
+ * inputs are packed into 31-bit digits through a 64-bit accumulator,
+ * complementing negative values along the way to obtain their magnitude.
+ */
+static KrkValue _long_from_bytes(const uint8_t * in, size_t n, int little, int _signed) {
+	int negative = _signed && n && (in[little ? n - 1 : 0] & 0x80);
+
+	if (n <= 8) {
+		uint64_t val = 0;
+		for (size_t i = 0; i < n; ++i) {
+			val |= (uint64_t)in[little ? i : n - i - 1] << (8 * i);
+		}
+		if (!negative) return krk_int_from_uint64(val);
+		if (n < 8) val |= UINT64_MAX << (8 * n);
+		return krk_int_from_int64((int64_t)val);
 	}
 
-	/* If input was negative, at this point we're producing an inverted value;
-	 * we already encoded (|n|-1), so now we just need to bit invert. */
-	if (krk_long_sign(val) < 0) {
-		for (size_t i = 0; i < (size_t)length; ++i) {
-			AS_BYTES(krk_peek(0))->bytes[i] ^= 0xFF;
+	size_t width = (n * 8 + DIGIT_SHIFT - 1) / DIGIT_SHIFT;
+	uint32_t * d = malloc(sizeof(uint32_t) * width);
+	uint64_t accum = 0;
+	int bits = 0;
+	unsigned int carry = negative;
+	size_t j = 0;
+
+	for (size_t i = 0; i < n; ++i) {
+		unsigned int byte = in[little ? i : n - i - 1];
+		if (negative) {
+			byte = (byte ^ 0xFF) + carry;
+			carry = byte >> 8;
+			byte &= 0xFF;
+		}
+		accum |= (uint64_t)byte << bits;
+		bits += 8;
+		if (bits >= DIGIT_SHIFT) {
+			d[j++] = accum & DIGIT_MAX;
+			accum >>= DIGIT_SHIFT;
+			bits -= DIGIT_SHIFT;
 		}
 	}
+	if (bits) d[j++] = accum;
 
-	/* We produced a bytes object, so we no longer need the long. */
-	krk_long_clear(&tmp);
-	return krk_pop();
+	KrkLong out = {0, NULL};
+	_long_adopt_digits(&out, d, j, negative);
+	return make_long_obj(&out);
 }
 
-KRK_Method(long,to_bytes) {
-	METHOD_TAKES_AT_LEAST(2);
-	return long_to_bytes(self->value, argc, argv, hasKw);
+/**
+ * @fn int.from_bytes(bytes, byteorder: str = 'big', *, signed: bool = False) -> int
+ *
+ * Class method. @p bytes may be any bytes-like object or an iterable of ints.
+ */
+FUNC_SIG(int,from_bytes) {
+	static const char * _method_name = "from_bytes";
+	KrkValue source;
+	const char * byteorder = "big";
+	int _signed = 0;
+	if (!krk_parseArgs(".V|s$p", (const char*[]){"bytes","byteorder","signed"}, &source, &byteorder, &_signed)) return NONE_VAL();
+
+	int order = _byteorder(byteorder);
+	if (!order) return NONE_VAL();
+
+	/* Views may have gaps between their items and iterables need to be
+	 * collected, so either way gather them into a bytes object first. */
+	if (krk_isInstanceOf(source, vm.baseClasses->memoryviewClass)) {
+		source = krk_bufferToBytes(source);
+		if (!IS_BYTES(source)) return NONE_VAL();
+	} else if (!krk_getType(source)->_ongetbuffer) {
+		if (IS_STRING(source)) {
+			return krk_runtimeError(vm.exceptions->typeError, "cannot convert '%T' object to bytes", source);
+		}
+		krk_push(OBJECT_VAL(vm.baseClasses->bytesClass));
+		krk_push(source);
+		source = krk_callStack(1);
+		if (!IS_BYTES(source)) return NONE_VAL();
+	}
+
+	krk_push(source);
+	KrkBuffer buffer;
+	if (!krk_getBuffer(source, &buffer)) return NONE_VAL();
+	KrkValue result = _long_from_bytes(buffer.data, buffer.length, order == 1, _signed);
+	krk_pop();
+	return result;
 }
 
 /**
@@ -1741,31 +3052,29 @@ KRK_Method(long,_get_digit) {
 /**
  * @c int wrapper implementations of the byte conversions.
  *
- * Convert to a @c long and just use those versions...
+ * The magnitude of an @c int fits in two digits, so we can view it
+ * as a @c long with digits on the stack and use those versions...
  */
+#define SMALL_AS_LONG(name, value) \
+	uint64_t _abs_ ## name = (value) < 0 ? -(uint64_t)(value) : (uint64_t)(value); \
+	uint32_t _digits_ ## name[2] = { _abs_ ## name & DIGIT_MAX, _abs_ ## name >> DIGIT_SHIFT }; \
+	KrkLong name[1] = {{ \
+		(_digits_ ## name[1] ? 2 : !!_digits_ ## name[0]) * ((value) < 0 ? -1 : 1), \
+		_digits_ ## name }}
 
 KRK_Method(int,bit_count) {
-	krk_long value;
-	krk_long_init_si(value, self);
-	KrkValue out = long_bit_count(value);
-	krk_long_clear(value);
-	return out;
+	SMALL_AS_LONG(value, self);
+	return long_bit_count(value);
 }
 
 KRK_Method(int,bit_length) {
-	krk_long value;
-	krk_long_init_si(value, self);
-	KrkValue out = long_bit_length(value);
-	krk_long_clear(value);
-	return out;
+	SMALL_AS_LONG(value, self);
+	return long_bit_length(value);
 }
 
 KRK_Method(int,to_bytes) {
-	krk_long value;
-	krk_long_init_si(value, self);
-	KrkValue out = long_to_bytes(value, argc, argv, hasKw);
-	krk_long_clear(value);
-	return out;
+	SMALL_AS_LONG(value, self);
+	return long_to_bytes(value, argc, argv, hasKw);
 }
 
 #undef BIND_METHOD
@@ -1807,6 +3116,7 @@ void _createAndBind_longClass(void) {
 	BIND_TRIPLET(long,truediv);
 	BIND_TRIPLET(long,floordiv);
 	BIND_TRIPLET(long,pow);
+	BIND_METHOD(long,__divmod__);
 
 	BIND_METHOD(long,__lt__);
 	BIND_METHOD(long,__gt__);
@@ -1833,6 +3143,7 @@ void _createAndBind_longClass(void) {
 	BIND_METHOD(int,bit_count);
 	BIND_METHOD(int,bit_length);
 	BIND_METHOD(int,to_bytes);
+	krk_defineNative(&_int->methods, "from_bytes", FUNC_NAME(int,from_bytes))->obj.flags |= KRK_OBJ_FLAGS_FUNCTION_IS_CLASS_METHOD;
 
 }
 
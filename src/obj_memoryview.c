@@ -0,0 +1,506 @@
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <kuroko/vm.h>
+#include <kuroko/value.h>
+#include <kuroko/memory.h>
+#include <kuroko/util.h>
+
+#include "private.h"
+
+/**
+ * @brief `memoryview` object.
+ * @extends KrkInstance
+ *
+ * A window onto the buffer of another object. Only the exporter, the
+ * item layout and the position of the window are stored; the buffer
+ * itself is looked up again on every access, so a view stays safe
+ * to use if a @ref bytearray behind it is resized.
+ */
+struct MemoryView {
+	KrkInstance inst;
+	KrkValue obj;        /**< Exporting object, or None once released */
+	size_t offset;       /**< Byte offset of the first item */
+	size_t length;       /**< Number of items */
+	ssize_t stride;      /**< Distance in bytes between items; negative for reversed slices */
+	size_t itemsize;
+	char format;
+	int readonly;
+};
+
+#define IS_memoryview(o) (krk_isInstanceOf(o,KRK_BASE_CLASS(memoryview)))
+#define AS_memoryview(o) ((struct MemoryView*)AS_OBJECT(o))
+
+int krk_getBuffer(KrkValue value, KrkBuffer * out) {
+	KrkClass * type = krk_getType(value);
+	if (unlikely(!type->_ongetbuffer)) {
+		krk_runtimeError(vm.exceptions->typeError, "a bytes-like object is required, not '%T'", value);
+		return 0;
+	}
+	return type->_ongetbuffer(value, out);
+}
+
+static size_t formatSize(char format) {
+	switch (format) {
+		case 'b': case 'B': return 1;
+		case 'h': case 'H': return sizeof(short);
+		case 'i': case 'I': return sizeof(int);
+		case 'l': case 'L': return sizeof(long);
+		case 'q': case 'Q': return sizeof(long long);
+		case 'f': return sizeof(float);
+		case 'd': return sizeof(double);
+	}
+	return 0;
+}
+
+/* Items are copied through locals, as slices and casts do not keep them aligned. */
+#define LOAD(type,box) { type v; memcpy(&v, p, sizeof(v)); return box(v); }
+
+static KrkValue loadItem(char format, const uint8_t * p) {
+	switch (format) {
+		case 'b': LOAD(signed char, krk_int_from_int64)
+		case 'B': return INTEGER_VAL(*p);
+		case 'h': LOAD(short, krk_int_from_int64)
+		case 'H': LOAD(unsigned short, krk_int_from_uint64)
+		case 'i': LOAD(int, krk_int_from_int64)
+		case 'I': LOAD(unsigned int, krk_int_from_uint64)
+		case 'l': LOAD(long, krk_int_from_int64)
+		case 'L': LOAD(unsigned long, krk_int_from_uint64)
+		case 'q': LOAD(long long, krk_int_from_int64)
+		case 'Q': LOAD(unsigned long long, krk_int_from_uint64)
+		case 'f': LOAD(float, FLOATING_VAL)
+		case 'd': LOAD(double, FLOATING_VAL)
+	}
+	return NONE_VAL();
+}
+
+#define STORE_SIGNED(type,min,max) { \
+	int64_t v; \
+	if (!krk_int_to_int64(value, &v) || v < (min) || v > (max)) goto _range; \
+	type out = v; memcpy(p, &out, sizeof(out)); return 1; }
+#define STORE_UNSIGNED(type,max) { \
+	uint64_t v; \
+	if (!krk_int_to_uint64(value, &v) || v > (max)) goto _range; \
+	type out = v; memcpy(p, &out, sizeof(out)); return 1; }
+#define STORE_FLOAT(type) { \
+	type out = IS_FLOATING(value) ? AS_FLOATING(value) : AS_INTEGER(value); \
+	memcpy(p, &out, sizeof(out)); return 1; }
+
+static int storeItem(char format, uint8_t * p, KrkValue value) {
+	if (format == 'f' || format == 'd') {
+		if (!IS_FLOATING(value) && !IS_INTEGER(value)) {
+			krk_runtimeError(vm.exceptions->typeError, "memoryview: invalid type for format '%c'", format);
+			return 0;
+		}
+		if (format == 'f') STORE_FLOAT(float)
+		STORE_FLOAT(double)
+	}
+	if (!IS_INTEGER(value) && !krk_isInstanceOf(value, vm.baseClasses->longClass)) {
+		krk_runtimeError(vm.exceptions->typeError, "memoryview: invalid type for format '%c'", format);
+		return 0;
+	}
+	switch (format) {
+		case 'b': STORE_SIGNED(signed char, SCHAR_MIN, SCHAR_MAX)
+		case 'B': STORE_UNSIGNED(unsigned char, UCHAR_MAX)
+		case 'h': STORE_SIGNED(short, SHRT_MIN, SHRT_MAX)
+		case 'H': STORE_UNSIGNED(unsigned short, USHRT_MAX)
+		case 'i': STORE_SIGNED(int, INT_MIN, INT_MAX)
+		case 'I': STORE_UNSIGNED(unsigned int, UINT_MAX)
+		case 'l': STORE_SIGNED(long, LONG_MIN, LONG_MAX)
+		case 'L': STORE_UNSIGNED(unsigned long, ULONG_MAX)
+		case 'q': STORE_SIGNED(long long, LLONG_MIN, LLONG_MAX)
+		case 'Q': STORE_UNSIGNED(unsigned long long, ULLONG_MAX)
+	}
+_range:
+	krk_runtimeError(vm.exceptions->valueError, "memoryview: invalid value for format '%c'", format);
+	return 0;
+}
+
+static void _memoryview_gcscan(KrkInstance * self) {
+	krk_markValue(((struct MemoryView*)self)->obj);
+}
+
+/**
+ * Look up the exporter's buffer and return a pointer to the first item of the view,
+ * or NULL with an exception set if the view is released or no longer fits.
+ */
+static uint8_t * viewData(struct MemoryView * self) {
+	if (IS_NONE(self->obj)) {
+		krk_runtimeError(vm.exceptions->valueError, "operation forbidden on released memoryview object");
+		return NULL;
+	}
+	KrkBuffer buffer;
+	if (!krk_getBuffer(self->obj, &buffer)) return NULL;
+	if (self->length) {
+		ssize_t last = (ssize_t)self->offset + (ssize_t)(self->length - 1) * self->stride;
+		if (self->offset + self->itemsize > buffer.length || last < 0 || (size_t)last + self->itemsize > buffer.length) {
+			krk_runtimeError(vm.exceptions->valueError, "memoryview: underlying buffer was resized");
+			return NULL;
+		}
+	}
+	return buffer.data + self->offset;
+}
+
+static int isContiguous(struct MemoryView * self) {
+	return self->length <= 1 || self->stride == (ssize_t)self->itemsize;
+}
+
+static int _memoryview_getbuffer(KrkValue value, KrkBuffer * out) {
+	struct MemoryView * self = AS_memoryview(value);
+	uint8_t * data = viewData(self);
+	if (!data) return 0;
+	if (!isContiguous(self)) {
+		krk_runtimeError(vm.exceptions->typeError, "memoryview: underlying buffer is not C-contiguous");
+		return 0;
+	}
+	out->owner = value;
+	out->data = data;
+	out->length = self->length * self->itemsize;
+	out->itemsize = self->itemsize;
+	out->format = self->format;
+	out->readonly = self->readonly;
+	return 1;
+}
+
+static struct MemoryView * newView(struct MemoryView * from) {
+	struct MemoryView * out = (struct MemoryView*)krk_newInstance(KRK_BASE_CLASS(memoryview));
+	out->obj = from->obj;
+	out->offset = from->offset;
+	out->length = from->length;
+	out->stride = from->stride;
+	out->itemsize = from->itemsize;
+	out->format = from->format;
+	out->readonly = from->readonly;
+	return out;
+}
+
+#define CURRENT_CTYPE struct MemoryView *
+#define CURRENT_NAME  self
+
+#define VIEW_DATA(name) \
+	uint8_t * name = viewData(self); \
+	if (!name) return NONE_VAL()
+
+KRK_Method(memoryview,__init__) {
+	KrkValue obj;
+	if (!krk_parseArgs(".V", (const char*[]){"object"}, &obj)) return NONE_VAL();
+	if (IS_memoryview(obj)) {
+		struct MemoryView * them = AS_memoryview(obj);
+		if (!viewData(them)) return NONE_VAL();
+		self->obj = them->obj;
+		self->offset = them->offset;
+		self->length = them->length;
+		self->stride = them->stride;
+		self->itemsize = them->itemsize;
+		self->format = them->format;
+		self->readonly = them->readonly;
+		return argv[0];
+	}
+	KrkBuffer buffer;
+	if (!krk_getBuffer(obj, &buffer)) return NONE_VAL();
+	self->obj = obj;
+	self->offset = 0;
+	self->itemsize = buffer.itemsize;
+	self->length = buffer.length / buffer.itemsize;
+	self->stride = buffer.itemsize;
+	self->format = buffer.format;
+	self->readonly = buffer.readonly;
+	return argv[0];
+}
+
+KRK_Method(memoryview,obj) {
+	ATTRIBUTE_NOT_ASSIGNABLE();
+	return self->obj;
+}
+
+KRK_Method(memoryview,nbytes) {
+	ATTRIBUTE_NOT_ASSIGNABLE();
+	return INTEGER_VAL(self->length * self->itemsize);
+}
+
+KRK_Method(memoryview,itemsize) {
+	ATTRIBUTE_NOT_ASSIGNABLE();
+	return INTEGER_VAL(self->itemsize);
+}
+
+KRK_Method(memoryview,format) {
+	ATTRIBUTE_NOT_ASSIGNABLE();
+	return OBJECT_VAL(krk_copyString(&self->format, 1));
+}
+
+KRK_Method(memoryview,readonly) {
+	ATTRIBUTE_NOT_ASSIGNABLE();
+	return BOOLEAN_VAL(self->readonly);
+}
+
+KRK_Method(memoryview,contiguous) {
+	ATTRIBUTE_NOT_ASSIGNABLE();
+	return BOOLEAN_VAL(isContiguous(self));
+}
+
+KRK_Method(memoryview,__len__) {
+	METHOD_TAKES_NONE();
+	return INTEGER_VAL(self->length);
+}
+
+KRK_Method(memoryview,__repr__) {
+	METHOD_TAKES_NONE();
+	char tmp[64];
+	size_t len = snprintf(tmp, sizeof(tmp), "<%smemory at %p>", IS_NONE(self->obj) ? "released " : "", (void*)self);
+	return OBJECT_VAL(krk_copyString(tmp, len));
+}
+
+KRK_Method(memoryview,__getitem__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (IS_INTEGER(argv[1])) {
+		VIEW_DATA(data);
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		if (index < 0) index += self->length;
+		if (index < 0 || index >= (krk_integer_type)self->length) {
+			return krk_runtimeError(vm.exceptions->indexError, "index out of bounds on dimension 1");
+		}
+		return loadItem(self->format, data + index * self->stride);
+	} else if (IS_slice(argv[1])) {
+		if (!viewData(self)) return NONE_VAL();
+		KRK_SLICER(argv[1],self->length) {
+			return NONE_VAL();
+		}
+		size_t count = 0;
+		if (step > 0 && end > start) count = (end - start + step - 1) / step;
+		else if (step < 0 && start > end) count = (start - end - step - 1) / -step;
+		struct MemoryView * out = newView(self);
+		out->offset = self->offset + start * self->stride;
+		out->length = count;
+		out->stride = self->stride * step;
+		return OBJECT_VAL(out);
+	}
+	return TYPE_ERROR(int or slice,argv[1]);
+}
+
+KRK_Method(memoryview,__setitem__) {
+	METHOD_TAKES_EXACTLY(2);
+	if (self->readonly) return krk_runtimeError(vm.exceptions->typeError, "cannot modify read-only memory");
+	if (IS_INTEGER(argv[1])) {
+		VIEW_DATA(data);
+		krk_integer_type index = AS_INTEGER(argv[1]);
+		if (index < 0) index += self->length;
+		if (index < 0 || index >= (krk_integer_type)self->length) {
+			return krk_runtimeError(vm.exceptions->indexError, "index out of bounds on dimension 1");
+		}
+		storeItem(self->format, data + index * self->stride, argv[2]);
+		return argv[2];
+	} else if (IS_slice(argv[1])) {
+		KrkBuffer source;
+		if (!krk_getBuffer(argv[2], &source)) return NONE_VAL();
+		VIEW_DATA(data);
+		KRK_SLICER(argv[1],self->length) {
+			return NONE_VAL();
+		}
+		size_t count = 0;
+		if (step > 0 && end > start) count = (end - start + step - 1) / step;
+		else if (step < 0 && start > end) count = (start - end - step - 1) / -step;
+		if (source.itemsize != self->itemsize || source.length != count * self->itemsize) {
+			return krk_runtimeError(vm.exceptions->valueError, "memoryview assignment: lvalue and rvalue have different structures");
+		}
+		ssize_t stride = self->stride * step;
+		uint8_t * target = data + start * self->stride;
+		if (stride == (ssize_t)self->itemsize) {
+			memmove(target, source.data, source.length);
+		} else if (count) {
+			/* Items are copied one at a time, so a source that overlaps the target must be copied out first. */
+			uint8_t * lo = stride < 0 ? target + (ssize_t)(count - 1) * stride : target;
+			uint8_t * hi = (stride < 0 ? target : target + (ssize_t)(count - 1) * stride) + self->itemsize;
+			uint8_t * from = source.data;
+			uint8_t * tmp = NULL;
+			if (source.data < hi && source.data + source.length > lo) {
+				tmp = malloc(source.length);
+				if (!tmp) return krk_runtimeError(vm.exceptions->baseException, "out of memory");
+				memcpy(tmp, source.data, source.length);
+				from = tmp;
+			}
+			for (size_t i = 0; i < count; ++i) {
+				memcpy(target + (ssize_t)i * stride, from + i * self->itemsize, self->itemsize);
+			}
+			free(tmp);
+		}
+		return argv[2];
+	}
+	return TYPE_ERROR(int or slice,argv[1]);
+}
+
+KRK_Method(memoryview,tobytes) {
+	METHOD_TAKES_NONE();
+	VIEW_DATA(data);
+	if (isContiguous(self)) return OBJECT_VAL(krk_newBytes(self->length * self->itemsize, data));
+	KrkBytes * out = krk_newBytes(self->length * self->itemsize, NULL);
+	for (size_t i = 0; i < self->length; ++i) {
+		memcpy(out->bytes + i * self->itemsize, data + (ssize_t)i * self->stride, self->itemsize);
+	}
+	return OBJECT_VAL(out);
+}
+
+KRK_Method(memoryview,tolist) {
+	METHOD_TAKES_NONE();
+	VIEW_DATA(data);
+	KrkValue list = krk_list_of(0, NULL, 0);
+	krk_push(list);
+	for (size_t i = 0; i < self->length; ++i) {
+		krk_writeValueArray(AS_LIST(list), loadItem(self->format, data + (ssize_t)i * self->stride));
+	}
+	return krk_pop();
+}
+
+KRK_Method(memoryview,hex) {
+	METHOD_TAKES_NONE();
+	VIEW_DATA(data);
+	static const char digits[] = "0123456789abcdef";
+	struct StringBuilder sb = {0};
+	for (size_t i = 0; i < self->length; ++i) {
+		const uint8_t * item = data + (ssize_t)i * self->stride;
+		for (size_t j = 0; j < self->itemsize; ++j) {
+			pushStringBuilder(&sb, digits[item[j] >> 4]);
+			pushStringBuilder(&sb, digits[item[j] & 0xF]);
+		}
+	}
+	return finishStringBuilder(&sb);
+}
+
+KRK_Method(memoryview,cast) {
+	const char * format;
+	if (!krk_parseArgs(".s", (const char*[]){"format"}, &format)) return NONE_VAL();
+	if (strlen(format) != 1 || !formatSize(format[0])) {
+		return krk_runtimeError(vm.exceptions->valueError, "memoryview: destination format must be a native single character format");
+	}
+	if (!viewData(self)) return NONE_VAL();
+	if (!isContiguous(self)) {
+		return krk_runtimeError(vm.exceptions->typeError, "memoryview: casts are restricted to C-contiguous views");
+	}
+	size_t itemsize = formatSize(format[0]);
+	size_t nbytes = self->length * self->itemsize;
+	if (nbytes % itemsize) {
+		return krk_runtimeError(vm.exceptions->typeError, "memoryview: length is not a multiple of itemsize");
+	}
+	struct MemoryView * out = newView(self);
+	out->format = format[0];
+	out->itemsize = itemsize;
+	out->length = nbytes / itemsize;
+	out->stride = itemsize;
+	return OBJECT_VAL(out);
+}
+
+KRK_Method(memoryview,toreadonly) {
+	METHOD_TAKES_NONE();
+	struct MemoryView * out = newView(self);
+	out->readonly = 1;
+	return OBJECT_VAL(out);
+}
+
+KRK_Method(memoryview,release) {
+	METHOD_TAKES_NONE();
+	self->obj = NONE_VAL();
+	return NONE_VAL();
+}
+
+KRK_Method(memoryview,__enter__) {
+	METHOD_TAKES_NONE();
+	return NONE_VAL();
+}
+
+KRK_Method(memoryview,__exit__) {
+	self->obj = NONE_VAL();
+	return NONE_VAL();
+}
+
+KRK_Method(memoryview,__eq__) {
+	METHOD_TAKES_EXACTLY(1);
+	if (IS_NONE(self->obj)) return BOOLEAN_VAL(argv[0] == argv[1]);
+	KrkClass * type = krk_getType(argv[1]);
+	if (!type->_ongetbuffer) return NOTIMPL_VAL();
+	VIEW_DATA(data);
+	/* Another memoryview may be strided, so walk it directly rather than asking for a contiguous export. */
+	uint8_t * otherData;
+	size_t otherLength;
+	ssize_t otherStride;
+	char otherFormat;
+	if (IS_memoryview(argv[1])) {
+		struct MemoryView * them = AS_memoryview(argv[1]);
+		if (IS_NONE(them->obj)) return BOOLEAN_VAL(0);
+		if (!(otherData = viewData(them))) return NONE_VAL();
+		otherLength = them->length;
+		otherStride = them->stride;
+		otherFormat = them->format;
+	} else {
+		KrkBuffer other;
+		if (!krk_getBuffer(argv[1], &other)) return NONE_VAL();
+		otherData = other.data;
+		otherLength = other.length / other.itemsize;
+		otherStride = other.itemsize;
+		otherFormat = other.format;
+	}
+	if (otherLength != self->length) return BOOLEAN_VAL(0);
+	if (otherFormat == self->format && isContiguous(self) && (otherLength <= 1 || otherStride == (ssize_t)self->itemsize)) {
+		return BOOLEAN_VAL(!memcmp(data, otherData, self->length * self->itemsize));
+	}
+	for (size_t i = 0; i < self->length; ++i) {
+		KrkValue a = loadItem(self->format, data + (ssize_t)i * self->stride);
+		KrkValue b = loadItem(otherFormat, otherData + (ssize_t)i * otherStride);
+		if (!krk_valuesEqual(a, b)) return BOOLEAN_VAL(0);
+	}
+	return BOOLEAN_VAL(1);
+}
+
+KRK_Method(memoryview,__iter__) {
+	METHOD_TAKES_NONE();
+	KrkValue list = FUNC_NAME(memoryview,tolist)(1, argv, 0);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return NONE_VAL();
+	krk_push(list);
+	return krk_callDirect(vm.baseClasses->listClass->_iter, 1);
+}
+
+_noexport
+KrkValue krk_bufferToBytes(KrkValue value) {
+	if (IS_memoryview(value)) {
+		return FUNC_NAME(memoryview,tobytes)(1, &value, 0);
+	}
+	KrkBuffer buffer;
+	if (!krk_getBuffer(value, &buffer)) return NONE_VAL();
+	return OBJECT_VAL(krk_newBytes(buffer.length, buffer.data));
+}
+
+_noexport
+void _createAndBind_memoryviewClass(void) {
+	KrkClass * memoryview = ADD_BASE_CLASS(vm.baseClasses->memoryviewClass, "memoryview", vm.baseClasses->objectClass);
+	memoryview->obj.flags |= KRK_OBJ_FLAGS_NO_INHERIT;
+	memoryview->allocSize = sizeof(struct MemoryView);
+	memoryview->_ongcscan = _memoryview_gcscan;
+	memoryview->_ongetbuffer = _memoryview_getbuffer;
+	KRK_DOC(BIND_METHOD(memoryview,__init__),
+		"@brief Access the memory of a bytes-like object without copying it.\n"
+		"@arguments object\n\n"
+		"Slicing a memoryview produces another view onto the same memory. "
+		"Views of writable objects, such as @ref bytearray, can be assigned to.");
+	KRK_DOC(BIND_PROP(memoryview,obj), "@brief The object this view refers to.");
+	KRK_DOC(BIND_PROP(memoryview,nbytes), "@brief Size of the view in bytes.");
+	KRK_DOC(BIND_PROP(memoryview,itemsize), "@brief Size in bytes of one item.");
+	KRK_DOC(BIND_PROP(memoryview,format), "@brief Type code of the items, as used by the @c array module.");
+	KRK_DOC(BIND_PROP(memoryview,readonly), "@brief Whether the memory can be modified through this view.");
+	KRK_DOC(BIND_PROP(memoryview,contiguous), "@brief Whether the items are adjacent in memory.");
+	KRK_DOC(BIND_METHOD(memoryview,tobytes), "@brief Copy the viewed memory into a new @ref bytes object.");
+	KRK_DOC(BIND_METHOD(memoryview,tolist), "@brief Convert the items to a list of numbers.");
+	KRK_DOC(BIND_METHOD(memoryview,hex), "@brief Convert the viewed memory to a string of hexadecimal digits.");
+	KRK_DOC(BIND_METHOD(memoryview,cast), "@brief Reinterpret the memory as items of another type.\n"
+		"@arguments format\n\n"
+		"The view must be contiguous, and its size must be a multiple of the new item size.");
+	KRK_DOC(BIND_METHOD(memoryview,toreadonly), "@brief Return a read-only view of the same memory.");
+	KRK_DOC(BIND_METHOD(memoryview,release), "@brief Drop the reference to the underlying object.\n\n"
+		"Any further use of the view raises @ref ValueError.");
+	BIND_METHOD(memoryview,__len__);
+	BIND_METHOD(memoryview,__repr__);
+	BIND_METHOD(memoryview,__getitem__);
+	BIND_METHOD(memoryview,__setitem__);
+	BIND_METHOD(memoryview,__eq__);
+	BIND_METHOD(memoryview,__iter__);
+	BIND_METHOD(memoryview,__enter__);
+	BIND_METHOD(memoryview,__exit__);
+	krk_finalizeClass(memoryview);
+}
@@ -306,15 +306,24 @@ KRK_Method(int,__format__) {
 }
 
 /**
- * We _could_ use the __builtin_XXX_overflow(_p) functions gcc+clang provide,
- * but let's just do this ourselves, I guess?
- *
- * We cheat: We only bother calculating + checking if both values would fit
- * in int32_t's. This ensures multiplication works fine.
- *
- * For any case where an int32_t would overflow, we do the 'long' operation
- * and then reduce if that still yields something that would fit in our 'int48'.
+ * Ints are 48 bits, so sums and differences always fit in an int64_t; only
+ * products need an overflow check. Results that no longer fit in an int
+ * become small longs directly, without going through the general long
+ * arithmetic. Anything that overflows 64 bits is left to the long code.
  */
+#ifndef __TINYC__
+#define OVERFLOW_CHECKED_INT_OPERATION(name,operator) \
+	extern KrkValue krk_long_coerced_ ## name (krk_integer_type a, krk_integer_type b); \
+	_noexport \
+	KrkValue krk_int_op_ ## name (krk_integer_type a, krk_integer_type b) { \
+		int64_t result; \
+		if (likely(!__builtin_ ## name ## _overflow(a, b, &result))) { \
+			if (likely(result >= -0x800000000000LL && result <= 0x7FFFFFFFFFFFLL)) return INTEGER_VAL(result); \
+			return krk_int_from_int64(result); \
+		} \
+		return krk_long_coerced_ ## name (a, b); \
+	}
+#else
 #define OVERFLOW_CHECKED_INT_OPERATION(name,operator) \
 	extern KrkValue krk_long_coerced_ ## name (krk_integer_type a, krk_integer_type b); \
 	_noexport \
@@ -326,6 +335,7 @@ KRK_Method(int,__format__) {
 		} \
 		return krk_long_coerced_ ## name (a, b); \
 	}
+#endif
 
 OVERFLOW_CHECKED_INT_OPERATION(add,+)
 OVERFLOW_CHECKED_INT_OPERATION(sub,-)
@@ -577,20 +587,9 @@ FUNC_SIG(float,__init__) {
 KRK_Method(float,__int__) { return INTEGER_VAL(self); }
 KRK_Method(float,__float__) { return argv[0]; }
 
-static int isDigits(const char * c) {
-	while (*c) {
-		if (*c < '0' || *c > '9') return 0;
-		c++;
-	}
-	return 1;
-}
-
 KRK_Method(float,__str__) {
-	char tmp[100];
-	size_t l = snprintf(tmp, 97, "%.16g", self);
-	if (!strstr(tmp,".") && isDigits(tmp)) {
-		l = snprintf(tmp,100,"%.16g.0",self);
-	}
+	char tmp[32];
+	size_t l = krk_doubleToString(self, tmp);
 	return OBJECT_VAL(krk_copyString(tmp, l));
 }
 
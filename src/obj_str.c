@@ -101,7 +101,11 @@ KRK_Method(str,__int__) {
 /* str.__float__() */
 KRK_Method(str,__float__) {
 	METHOD_TAKES_NONE();
-	return FLOATING_VAL(strtod(AS_CSTRING(argv[0]),NULL));
+	double value;
+	if (krk_parseDouble(AS_CSTRING(argv[0]), AS_STRING(argv[0])->length, &value)) {
+		return krk_runtimeError(vm.exceptions->valueError, "could not convert string to float: %R", argv[0]);
+	}
+	return FLOATING_VAL(value);
 }
 
 KRK_Method(str,__getitem__) {
@@ -114,11 +118,13 @@ KRK_Method(str,__getitem__) {
 		}
 		if ((self->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) == KRK_OBJ_FLAGS_STRING_ASCII) {
 			return OBJECT_VAL(krk_copyString(self->chars + asInt, 1));
-		} else {
-			krk_unicodeString(self);
+		} else if (self->codes) {
 			unsigned char asbytes[5];
 			size_t length = krk_codepointToBytes(KRK_STRING_FAST(self,asInt),(unsigned char*)&asbytes);
 			return OBJECT_VAL(krk_copyString((char*)&asbytes, length));
+		} else {
+			size_t offset = krk_unicodeOffset(self, asInt);
+			return OBJECT_VAL(krk_copyString(self->chars + offset, UTF8_LEAD_BYTES((unsigned char)self->chars[offset])));
 		}
 	} else if (IS_slice(argv[1])) {
 		KRK_SLICER(argv[1], self->codesLength) {
@@ -129,19 +135,12 @@ KRK_Method(str,__getitem__) {
 			long len = end - start;
 			if ((self->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) == KRK_OBJ_FLAGS_STRING_ASCII) {
 				return OBJECT_VAL(krk_copyString(self->chars + start, len));
+			} else if (len <= 0) {
+				return OBJECT_VAL(S(""));
 			} else {
-				size_t offset = 0;
-				size_t length = 0;
-				/* Figure out where the UTF8 for this string starts. */
-				krk_unicodeString(self);
-				for (long i = 0; i < start; ++i) {
-					uint32_t cp = KRK_STRING_FAST(self,i);
-					offset += CODEPOINT_BYTES(cp);
-				}
-				for (long i = start; i < end; ++i) {
-					uint32_t cp = KRK_STRING_FAST(self,i);
-					length += CODEPOINT_BYTES(cp);
-				}
+				/* Figure out where the UTF8 for this string starts and ends. */
+				size_t offset = krk_unicodeOffset(self, start);
+				size_t length = krk_unicodeOffset(self, end) - offset;
 				return OBJECT_VAL(krk_copyString(self->chars + offset, length));
 			}
 		} else {
@@ -449,10 +448,131 @@ static int isWhitespace(char c) {
 
 static int substringMatch(const char * haystack, size_t haystackLen, const char * needle, size_t needleLength) {
 	if (haystackLen < needleLength) return 0;
-	for (size_t i = 0; i < needleLength; ++i) {
-		if (haystack[i] != needle[i]) return 0;
+	return !memcmp(haystack, needle, needleLength);
+}
+
+#define BYTESET_TEST(set,c) ((set)[(c) / (8 * sizeof(size_t))] &  ((size_t)1 << ((c) % (8 * sizeof(size_t)))))
+#define BYTESET_ADD(set,c)  ((set)[(c) / (8 * sizeof(size_t))] |= ((size_t)1 << ((c) % (8 * sizeof(size_t)))))
+
+/**
+ * Crochemore-Perrin Two-Way search, with a last-byte shift table.
+ *
+ * Linear in the worst case, constant extra space beyond the shift table,
+ * and usually sublinear thanks to skipping on the last byte of the window.
+ * Assumes @p needleLength >= 2 and that the haystack is at least that long.
+ */
+static const char * twoWaySearch(const unsigned char * h, const unsigned char * z, const unsigned char * n, size_t l) {
+	size_t byteset[32 / sizeof(size_t)] = {0};
+	size_t shift[256];
+
+	for (size_t i = 0; i < l; ++i) {
+		BYTESET_ADD(byteset, n[i]);
+		shift[n[i]] = i + 1;
+	}
+
+	/* Critical factorization: maximal suffix under both orderings */
+	size_t ip = -1, jp = 0, k = 1, p = 1, ms, p0;
+	while (jp + k < l) {
+		if (n[ip+k] == n[jp+k]) {
+			if (k == p) { jp += p; k = 1; }
+			else k++;
+		} else if (n[ip+k] > n[jp+k]) {
+			jp += k; k = 1; p = jp - ip;
+		} else {
+			ip = jp++; k = p = 1;
+		}
+	}
+	ms = ip;
+	p0 = p;
+
+	ip = -1; jp = 0; k = p = 1;
+	while (jp + k < l) {
+		if (n[ip+k] == n[jp+k]) {
+			if (k == p) { jp += p; k = 1; }
+			else k++;
+		} else if (n[ip+k] < n[jp+k]) {
+			jp += k; k = 1; p = jp - ip;
+		} else {
+			ip = jp++; k = p = 1;
+		}
+	}
+	if (ip + 1 > ms + 1) ms = ip;
+	else p = p0;
+
+	/* For non-periodic needles we can shift by more and need no memory */
+	size_t mem0, mem = 0;
+	if (memcmp(n, n + p, ms + 1)) {
+		mem0 = 0;
+		p = (ms > l - ms - 1 ? ms : l - ms - 1) + 1;
+	} else {
+		mem0 = l - p;
+	}
+
+	while ((size_t)(z - h) >= l) {
+		/* Check the last byte of the window first */
+		if (BYTESET_TEST(byteset, h[l-1])) {
+			k = l - shift[h[l-1]];
+			if (k) {
+				if (k < mem) k = mem;
+				h += k;
+				mem = 0;
+				continue;
+			}
+		} else {
+			h += l;
+			mem = 0;
+			continue;
+		}
+
+		/* Right half */
+		for (k = (ms + 1 > mem ? ms + 1 : mem); k < l && n[k] == h[k]; k++);
+		if (k < l) {
+			h += k - ms;
+			mem = 0;
+			continue;
+		}
+
+		/* Left half */
+		for (k = ms + 1; k > mem && n[k-1] == h[k-1]; k--);
+		if (k <= mem) return (const char *)h;
+		h += p;
+		mem = mem0;
+	}
+
+	return NULL;
+}
+
+#undef BYTESET_TEST
+#undef BYTESET_ADD
+
+_noexport
+const char * krk_memmem(const char * haystack, size_t haystackLen, const char * needle, size_t needleLength) {
+	if (needleLength == 0) return haystack;
+	if (haystackLen < needleLength) return NULL;
+
+	/* memchr is vectorized by any libc worth using, so use it to find candidate starts. */
+	const char * h = memchr(haystack, (unsigned char)needle[0], haystackLen - needleLength + 1);
+	if (!h || needleLength == 1) return h;
+
+	const char * end = haystack + haystackLen;
+
+	/* Short needles: try a few candidates directly before paying for Two-Way setup. */
+	for (int tries = 0; tries < 4; ++tries) {
+		if (!memcmp(h + 1, needle + 1, needleLength - 1)) return h;
+		h = memchr(h + 1, (unsigned char)needle[0], (end - needleLength + 1) - (h + 1));
+		if (!h) return NULL;
 	}
-	return 1;
+
+	return twoWaySearch((const unsigned char *)h, (const unsigned char *)end, (const unsigned char *)needle, needleLength);
+}
+
+/* Number of codepoints in a range of (valid) UTF-8 */
+static size_t countCodepoints(const char * start, size_t length) {
+	size_t out = 0;
+	for (size_t i = 0; i < length; ++i) {
+		if ((start[i] & 0xC0) != 0x80) out++;
+	}
+	return out;
 }
 
 /* str.__contains__ */
@@ -460,12 +580,7 @@ KRK_Method(str,__contains__) {
 	METHOD_TAKES_EXACTLY(1);
 	if (IS_NONE(argv[1])) return BOOLEAN_VAL(0);
 	CHECK_ARG(1,str,KrkString*,needle);
-	for (size_t i = 0; i < self->length; ++i) {
-		if (substringMatch(self->chars + i, self->length - i, needle->chars, needle->length)) {
-			return BOOLEAN_VAL(1);
-		}
-	}
-	return BOOLEAN_VAL(0);
+	return BOOLEAN_VAL(krk_memmem(self->chars, self->length, needle->chars, needle->length) != NULL);
 }
 
 static int charIn(uint32_t c, KrkString * str) {
@@ -527,8 +642,8 @@ KRK_Method(str,rstrip) {
 		} \
 		size_t aLen = AS_STRING(argv[0])->length; \
 		size_t bLen = AS_STRING(argv[1])->length; \
-		const char * a = AS_CSTRING(argv[0]); \
-		const char * b = AS_CSTRING(argv[1]); \
+		const unsigned char * a = (const unsigned char *)AS_CSTRING(argv[0]); \
+		const unsigned char * b = (const unsigned char *)AS_CSTRING(argv[1]); \
 		for (size_t i = 0; i < ((aLen < bLen) ? aLen : bLen); i++) { \
 			if (a[i] lop b[i]) return BOOLEAN_VAL(1); \
 			if (a[i] iop b[i]) return BOOLEAN_VAL(0); \
@@ -701,15 +816,13 @@ KRK_Method(str,split) {
 		}
 
 		while (i != self->length) {
-			struct StringBuilder sb = {0};
-			while (i != self->length && !substringMatch(c, self->length - i, sep, sepLen)) {
-				pushStringBuilder(&sb, *c);
-				i++;
-				c++;
-			}
-			krk_push(finishStringBuilder(&sb));
+			const char * match = krk_memmem(c, self->length - i, sep, sepLen);
+			size_t segment = match ? (size_t)(match - c) : self->length - i;
+			krk_push(OBJECT_VAL(krk_copyString(c, segment)));
 			krk_writeValueArray(AS_LIST(myList), krk_peek(0));
 			krk_pop();
+			i += segment;
+			c += segment;
 			if (i == self->length) break;
 			i += sepLen;
 			c += sepLen;
@@ -738,23 +851,27 @@ KRK_Method(str,replace) {
 	int replacements = 0;
 	size_t i = 0;
 	char * c = self->chars;
-	while (i < self->length) {
-		if ( substringMatch(c, self->length - i, oldStr->chars, oldStr->length) && (IS_NONE(count) || replacements < AS_INTEGER(count))) {
+	while (i < self->length && (IS_NONE(count) || replacements < AS_INTEGER(count))) {
+		if (oldStr->length == 0) {
+			/* Insert between codepoints, not between bytes */
+			size_t width = UTF8_LEAD_BYTES((unsigned char)*c);
+			if (width > self->length - i) width = self->length - i;
 			pushStringBuilderStr(&sb, newStr->chars, newStr->length);
-			if (oldStr->length == 0) {
-				pushStringBuilder(&sb, *c);
-				c++;
-				i++;
-			}
-			c += oldStr->length;
-			i += oldStr->length;
+			pushStringBuilderStr(&sb, c, width);
+			c += width;
+			i += width;
 			replacements++;
-		} else {
-			pushStringBuilder(&sb, *c);
-			c++;
-			i++;
+			continue;
 		}
+		const char * match = krk_memmem(c, self->length - i, oldStr->chars, oldStr->length);
+		if (!match) break;
+		pushStringBuilderStr(&sb, c, match - c);
+		pushStringBuilderStr(&sb, newStr->chars, newStr->length);
+		i += (match - c) + oldStr->length;
+		c = (char*)match + oldStr->length;
+		replacements++;
 	}
+	pushStringBuilderStr(&sb, c, self->length - i);
 
 	return finishStringBuilder(&sb);
 }
@@ -791,19 +908,60 @@ KRK_Method(str,find) {
 	WRAP_INDEX(start);
 	WRAP_INDEX(end);
 
-	/* Make sure both strings have code representations */
-	krk_unicodeString(self);
-	krk_unicodeString(substr);
+	if (start > end) return INTEGER_VAL(-1);
 
-	for (krk_integer_type i = start; i < end; ++i) {
-		krk_integer_type j;
-		for (j = 0; j < (krk_integer_type)substr->codesLength && (i + j < end); ++j) {
-			if (KRK_STRING_FAST(self,i+j) != KRK_STRING_FAST(substr,j)) break;
+	/* UTF-8 is self-synchronizing, so a byte match is always a codepoint match. */
+	size_t startOffset = krk_unicodeOffset(self, start);
+	size_t endOffset   = krk_unicodeOffset(self, end);
+
+	const char * match = krk_memmem(self->chars + startOffset, endOffset - startOffset, substr->chars, substr->length);
+	if (!match) return INTEGER_VAL(-1);
+
+	if ((self->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) == KRK_OBJ_FLAGS_STRING_ASCII) return INTEGER_VAL(match - self->chars);
+	return INTEGER_VAL(start + countCodepoints(self->chars + startOffset, match - (self->chars + startOffset)));
+}
+
+KRK_Method(str,count) {
+	METHOD_TAKES_AT_LEAST(1);
+	METHOD_TAKES_AT_MOST(3);
+	CHECK_ARG(1,str,KrkString*,substr);
+
+	krk_integer_type start = 0;
+	krk_integer_type end = self->codesLength;
+
+	if (argc > 2) {
+		if (IS_INTEGER(argv[2])) {
+			start = AS_INTEGER(argv[2]);
+		} else {
+			return TYPE_ERROR(int,argv[2]);
 		}
-		if (j == (krk_integer_type)substr->codesLength) return INTEGER_VAL(i);
 	}
 
-	return INTEGER_VAL(-1);
+	if (argc > 3) {
+		if (IS_INTEGER(argv[3])) {
+			end = AS_INTEGER(argv[3]);
+		} else {
+			return TYPE_ERROR(int,argv[3]);
+		}
+	}
+
+	WRAP_INDEX(start);
+	WRAP_INDEX(end);
+
+	if (start > end) return INTEGER_VAL(0);
+	if (substr->length == 0) return INTEGER_VAL(end - start + 1);
+
+	size_t offset = krk_unicodeOffset(self, start);
+	size_t endOffset = krk_unicodeOffset(self, end);
+	krk_integer_type found = 0;
+
+	const char * match;
+	while ((match = krk_memmem(self->chars + offset, endOffset - offset, substr->chars, substr->length))) {
+		found++;
+		offset = (match - self->chars) + substr->length;
+	}
+
+	return INTEGER_VAL(found);
 }
 
 KRK_Method(str,index) {
@@ -1001,38 +1159,38 @@ KRK_Method(str,title) {
 }
 
 #undef CURRENT_CTYPE
-#define CURRENT_CTYPE KrkInstance *
+#define CURRENT_CTYPE struct StrIterator *
+
+static void _striterator_gcscan(KrkInstance * self) {
+	krk_markValue(((struct StrIterator*)self)->s);
+}
+
 KRK_Method(striterator,__init__) {
 	METHOD_TAKES_EXACTLY(1);
 	CHECK_ARG(1,str,KrkString*,base);
-	krk_push(OBJECT_VAL(self));
-	krk_attachNamedObject(&self->fields, "s", (KrkObj*)base);
-	krk_attachNamedValue(&self->fields, "i", INTEGER_VAL(0));
-	return krk_pop();
+	self->s = argv[1];
+	self->offset = 0;
+	return argv[0];
 }
 
-KRK_Method(striterator,__call__) {
-	METHOD_TAKES_NONE();
-	KrkValue _str;
-	KrkValue _counter;
-	const char * errorStr = NULL;
-	if (!krk_tableGet(&self->fields, OBJECT_VAL(S("s")), &_str) || !IS_STRING(_str)) {
-		errorStr = "no str pointer";
-		goto _corrupt;
-	}
-	if (!krk_tableGet(&self->fields, OBJECT_VAL(S("i")), &_counter) || !IS_INTEGER(_counter)) {
-		errorStr = "no index";
-		goto _corrupt;
+_noexport
+KrkValue krk_strIteratorNext(struct StrIterator * self) {
+	KrkString * str = AS_STRING(self->s);
+	if (self->offset >= str->length) return OBJECT_VAL(self);
+	size_t width = UTF8_LEAD_BYTES((unsigned char)str->chars[self->offset]);
+	/* A truncated sequence at the end is not counted as a codepoint. */
+	if (width > str->length - self->offset) {
+		self->offset = str->length;
+		return OBJECT_VAL(self);
 	}
+	KrkValue out = OBJECT_VAL(krk_copyString(str->chars + self->offset, width));
+	self->offset += width;
+	return out;
+}
 
-	if ((size_t)AS_INTEGER(_counter) >= AS_STRING(_str)->codesLength) {
-		return argv[0];
-	} else {
-		krk_attachNamedValue(&self->fields, "i", INTEGER_VAL(AS_INTEGER(_counter)+1));
-		return FUNC_NAME(str,__getitem__)(2,(KrkValue[]){_str,_counter},3);
-	}
-_corrupt:
-	return krk_runtimeError(vm.exceptions->typeError, "Corrupt str iterator: %s", errorStr);
+KRK_Method(striterator,__call__) {
+	METHOD_TAKES_NONE();
+	return krk_strIteratorNext(self);
 }
 
 _noexport
@@ -1069,6 +1227,7 @@ void _createAndBind_strClass(void) {
 	BIND_METHOD(str,format);
 	BIND_METHOD(str,replace);
 	BIND_METHOD(str,find);
+	BIND_METHOD(str,count);
 	BIND_METHOD(str,index);
 	BIND_METHOD(str,startswith);
 	BIND_METHOD(str,endswith);
@@ -1092,6 +1251,8 @@ void _createAndBind_strClass(void) {
 	KRK_DOC(str, "Obtain a string representation of an object.");
 
 	KrkClass * striterator = ADD_BASE_CLASS(vm.baseClasses->striteratorClass, "striterator", vm.baseClasses->objectClass);
+	striterator->allocSize = sizeof(struct StrIterator);
+	striterator->_ongcscan = _striterator_gcscan;
 	striterator->obj.flags |= KRK_OBJ_FLAGS_NO_INHERIT;
 	BIND_METHOD(striterator,__init__);
 	BIND_METHOD(striterator,__call__);
@@ -5,6 +5,8 @@
 #include <kuroko/memory.h>
 #include <kuroko/util.h>
 
+#include "private.h"
+
 #define TUPLE_WRAP_INDEX() \
 	if (index < 0) index += self->values.count; \
 	if (index < 0 || index >= (krk_integer_type)self->values.count) return krk_runtimeError(vm.exceptions->indexError, "tuple index out of range: %zd", (ssize_t)index)
@@ -195,12 +197,6 @@ KRK_Method(tuple,__add__) {
  * @brief Iterator over the values in a tuple.
  * @extends KrkInstance
  */
-struct TupleIter {
-	KrkInstance inst;
-	KrkValue myTuple;
-	int i;
-};
-
 static KrkValue _tuple_iter_init(int argc, const KrkValue argv[], int hasKw) {
 	struct TupleIter * self = (struct TupleIter *)AS_OBJECT(argv[0]);
 	self->myTuple = argv[1];
@@ -215,8 +211,8 @@ static void _tuple_iter_gcscan(KrkInstance * self) {
 static KrkValue _tuple_iter_call(int argc, const KrkValue argv[], int hasKw) {
 	struct TupleIter * self = (struct TupleIter *)AS_OBJECT(argv[0]);
 	KrkValue t = self->myTuple; /* Tuple to iterate */
-	int i = self->i;
-	if (i >= (krk_integer_type)AS_TUPLE(t)->values.count) {
+	size_t i = self->i;
+	if (i >= AS_TUPLE(t)->values.count) {
 		return argv[0];
 	} else {
 		self->i = i+1;
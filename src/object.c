@@ -8,6 +8,8 @@
 #include <kuroko/vm.h>
 #include <kuroko/table.h>
 
+#include "private.h"
+
 #define ALLOCATE_OBJECT(type, objectType) \
 	(type*)allocateObject(sizeof(type), objectType)
 
@@ -16,8 +18,10 @@ static volatile int _stringLock = 0;
 static volatile int _objectLock = 0;
 #endif
 
-static KrkObj * allocateObject(size_t size, KrkObjType type) {
-	KrkObj * object = (KrkObj*)krk_reallocate(NULL, 0, size);
+/**
+ * Clear a freshly allocated or recycled object and link it into the GC's object list.
+ */
+static KrkObj * initObject(KrkObj * object, size_t size, KrkObjType type) {
 	memset(object,0,size);
 	object->type = type;
 
@@ -32,6 +36,10 @@ static KrkObj * allocateObject(size_t size, KrkObjType type) {
 	return object;
 }
 
+static KrkObj * allocateObject(size_t size, KrkObjType type) {
+	return initObject((KrkObj*)krk_reallocate(NULL, 0, size), size, type);
+}
+
 size_t krk_codepointToBytes(krk_integer_type value, unsigned char * out) {
 	if (value > 0xFFFF) {
 		out[0] = (0xF0 | (value >> 18));
@@ -100,22 +108,64 @@ _reject:
 	return *state;
 }
 
+#define HIGH_BITS 0x8080808080808080ULL
+
+/**
+ * Validate UTF-8, count codepoints, and determine the compact storage type.
+ *
+ * Runs of ASCII are skipped a word at a time (four words per step when
+ * the run is long enough), which is where most real text spends its time.
+ * Multibyte sequences are decoded directly, accepting exactly what the
+ * byte-at-a-time @c decode state machine accepts: a truncated sequence at
+ * the end of the input is ignored rather than rejected.
+ */
 static int checkString(const char * chars, size_t length, size_t *codepointCount) {
-	uint32_t state = 0;
-	uint32_t codepoint = 0;
-	unsigned char * end = (unsigned char *)chars + length;
+	const unsigned char * c = (const unsigned char *)chars;
+	const unsigned char * end = c + length;
 	uint32_t maxCodepoint = 0;
-	for (unsigned char * c = (unsigned char *)chars; c < end; ++c) {
-		if (!decode(&state, &codepoint, *c)) {
-			if (codepoint > maxCodepoint) maxCodepoint = codepoint;
-			(*codepointCount)++;
-		} else if (state == UTF8_REJECT) {
-			_release_lock(_stringLock);
-			krk_runtimeError(vm.exceptions->valueError, "Invalid UTF-8 sequence in string.");
-			*codepointCount = 0;
-			return -1;
+	size_t continuations = 0;
+
+	while (c < end) {
+		if (*c < 0x80) {
+			while (end - c >= 32) {
+				uint64_t w[4];
+				memcpy(w, c, sizeof(w));
+				if ((w[0] | w[1] | w[2] | w[3]) & HIGH_BITS) break;
+				c += 32;
+			}
+			while (end - c >= 8) {
+				uint64_t w;
+				memcpy(&w, c, sizeof(w));
+				if (w & HIGH_BITS) break;
+				c += 8;
+			}
+			while (c < end && *c < 0x80) c++;
+			continue;
+		}
+
+		size_t need;
+		uint32_t codepoint;
+		if (*c < 0xC2) goto _reject;
+		else if (*c < 0xE0) { need = 1; codepoint = *c & 0x1F; }
+		else if (*c < 0xF0) { need = 2; codepoint = *c & 0x0F; }
+		else if (*c < 0xF8) { need = 3; codepoint = *c & 0x07; }
+		else goto _reject;
+
+		size_t avail = (size_t)(end - c) - 1;
+		for (size_t i = 1; i <= need && i <= avail; ++i) {
+			if ((c[i] & 0xC0) != 0x80) goto _reject;
+			codepoint = (codepoint << 6) | (c[i] & 0x3F);
 		}
+		if (avail < need) break;
+
+		if (codepoint > maxCodepoint) maxCodepoint = codepoint;
+		continuations += need;
+		c += need + 1;
 	}
+
+	/* Every byte is one codepoint, less the continuation bytes we counted above. */
+	*codepointCount += (size_t)(c - (const unsigned char *)chars) - continuations;
+
 	if (maxCodepoint > 0xFFFF) {
 		return KRK_OBJ_FLAGS_STRING_UCS4;
 	} else if (maxCodepoint > 0xFF) {
@@ -125,6 +175,24 @@ static int checkString(const char * chars, size_t length, size_t *codepointCount
 	} else {
 		return KRK_OBJ_FLAGS_STRING_ASCII;
 	}
+
+_reject:
+	_release_lock(_stringLock);
+	krk_runtimeError(vm.exceptions->valueError, "Invalid UTF-8 sequence in string.");
+	*codepointCount = 0;
+	return -1;
+}
+
+#undef HIGH_BITS
+
+/*
+ * Another thread may be reading the same string, so lazily built tables are
+ * filled in first and then published in one step. A table, once published,
+ * stays until the string is freed; if another thread got there first, ours
+ * is discarded and theirs is used.
+ */
+static void _publish(void * slot, void * table) {
+	if (!__sync_bool_compare_and_swap((void**)slot, NULL, table)) free(table);
 }
 
 #define GENREADY(size,type) \
@@ -132,8 +200,8 @@ static int checkString(const char * chars, size_t length, size_t *codepointCount
 		uint32_t state = 0; \
 		uint32_t codepoint = 0; \
 		unsigned char * end = (unsigned char *)string->chars + string->length; \
-		string->codes = malloc(sizeof(type) * string->codesLength); \
-		type *outPtr = (type *)string->codes; \
+		void * codes = malloc(sizeof(type) * string->codesLength); \
+		type *outPtr = (type *)codes; \
 		for (unsigned char * c = (unsigned char *)string->chars; c < end; ++c) { \
 			if (!decode(&state, &codepoint, *c)) { \
 				*(outPtr++) = (type)codepoint; \
@@ -141,12 +209,34 @@ static int checkString(const char * chars, size_t length, size_t *codepointCount
 				state = 0; \
 			} \
 		} \
+		_publish(&string->codes, codes); \
 	}
 GENREADY(1,uint8_t)
 GENREADY(2,uint16_t)
 GENREADY(4,uint32_t)
 #undef GENREADY
 
+/**
+ * Build the sparse checkpoint index for a non-ASCII string.
+ *
+ * Entry n holds the byte offset of codepoint n * KRK_STRING_INDEX_STRIDE.
+ * The string has already been validated, so we only need to look at
+ * lead bytes to find codepoint boundaries.
+ */
+static void _readyIndex(KrkString * string) {
+	size_t count = (string->codesLength + KRK_STRING_INDEX_STRIDE - 1) / KRK_STRING_INDEX_STRIDE;
+	size_t * index = malloc(sizeof(size_t) * (count ? count : 1));
+	const unsigned char * c = (const unsigned char *)string->chars;
+	size_t offset = 0;
+	for (size_t i = 0; i < count; ++i) {
+		index[i] = offset;
+		for (size_t j = 0; j < KRK_STRING_INDEX_STRIDE && offset < string->length; ++j) {
+			offset += UTF8_LEAD_BYTES(c[offset]);
+		}
+	}
+	_publish(&string->index, index);
+}
+
 void * krk_unicodeString(KrkString * string) {
 	if (string->codes) return string->codes;
 	else if ((string->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) == KRK_OBJ_FLAGS_STRING_UCS1) _readyUCS1(string);
@@ -156,17 +246,39 @@ void * krk_unicodeString(KrkString * string) {
 	return string->codes;
 }
 
+size_t krk_unicodeOffset(KrkString * string, size_t index) {
+	if ((string->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) == KRK_OBJ_FLAGS_STRING_ASCII) return index;
+	if (index >= string->codesLength) return string->length;
+
+	const unsigned char * c = (const unsigned char *)string->chars;
+	if (!string->index) _readyIndex(string);
+	size_t offset = string->index[index / KRK_STRING_INDEX_STRIDE];
+	size_t skip   = index % KRK_STRING_INDEX_STRIDE;
+
+	while (skip--) offset += UTF8_LEAD_BYTES(c[offset]);
+	return offset;
+}
+
 uint32_t krk_unicodeCodepoint(KrkString * string, size_t index) {
-	krk_unicodeString(string);
 	switch (string->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) {
-		case KRK_OBJ_FLAGS_STRING_ASCII:
-		case KRK_OBJ_FLAGS_STRING_UCS1: return ((uint8_t*)string->codes)[index];
-		case KRK_OBJ_FLAGS_STRING_UCS2: return ((uint16_t*)string->codes)[index];
-		case KRK_OBJ_FLAGS_STRING_UCS4: return ((uint32_t*)string->codes)[index];
-		default:
-			krk_runtimeError(vm.exceptions->valueError, "Internal string error.");
-			return 0;
+		case KRK_OBJ_FLAGS_STRING_ASCII: return ((uint8_t*)string->chars)[index];
+		case KRK_OBJ_FLAGS_STRING_UCS1:
+			if (string->codes) return ((uint8_t*)string->codes)[index];
+			break;
+		case KRK_OBJ_FLAGS_STRING_UCS2:
+			if (string->codes) return ((uint16_t*)string->codes)[index];
+			break;
+		case KRK_OBJ_FLAGS_STRING_UCS4:
+			if (string->codes) return ((uint32_t*)string->codes)[index];
+			break;
 	}
+
+	/* No full codepoint representation; decode from the sparse index. */
+	const unsigned char * c = (const unsigned char *)string->chars + krk_unicodeOffset(string, index);
+	uint32_t state = 0;
+	uint32_t codepoint = 0;
+	while (decode(&state, &codepoint, *c) && state != UTF8_REJECT) c++;
+	return codepoint;
 }
 
 static KrkString * allocateString(char * chars, size_t length, uint32_t hash) {
@@ -182,6 +294,7 @@ static KrkString * allocateString(char * chars, size_t length, uint32_t hash) {
 	string->obj.flags |= KRK_OBJ_FLAGS_VALID_HASH | type;
 	string->codesLength = codesLength;
 	string->codes = NULL;
+	string->index = NULL;
 	if (type == KRK_OBJ_FLAGS_STRING_ASCII) string->codes = string->chars;
 	krk_push(OBJECT_VAL(string));
 	krk_tableSet(&vm.strings, OBJECT_VAL(string), NONE_VAL());
@@ -248,6 +361,7 @@ KrkString * krk_takeStringVetted(char * chars, size_t length, size_t codesLength
 	string->obj.flags |= KRK_OBJ_FLAGS_VALID_HASH | type;
 	string->codesLength = codesLength;
 	string->codes = NULL;
+	string->index = NULL;
 	if (type == KRK_OBJ_FLAGS_STRING_ASCII) string->codes = string->chars;
 	krk_push(OBJECT_VAL(string));
 	krk_tableSet(&vm.strings, OBJECT_VAL(string), NONE_VAL());
@@ -326,6 +440,7 @@ KrkClass * krk_newClass(KrkString * name, KrkClass * baseClass) {
 		_class->allocSize = baseClass->allocSize;
 		_class->_ongcscan = baseClass->_ongcscan;
 		_class->_ongcsweep = baseClass->_ongcsweep;
+		_class->_ongetbuffer = baseClass->_ongetbuffer;
 
 		krk_tableSet(&baseClass->subclasses, OBJECT_VAL(_class), NONE_VAL());
 	}
@@ -334,20 +449,39 @@ KrkClass * krk_newClass(KrkString * name, KrkClass * baseClass) {
 }
 
 KrkInstance * krk_newInstance(KrkClass * _class) {
-	KrkInstance * instance = (KrkInstance*)allocateObject(_class->allocSize, KRK_OBJ_INSTANCE);
+	KrkObj * cached = NULL;
+	size_t extra = _class->allocSize - sizeof(KrkInstance);
+	if (!(extra % sizeof(void*)) && extra / sizeof(void*) < KRK_CACHE_INSTANCE_SIZES) {
+		cached = krk_takeCachedObject(&krk_currentThread.instanceCache[extra / sizeof(void*)], _class->allocSize);
+	}
+	KrkInstance * instance = cached ? (KrkInstance*)initObject(cached, _class->allocSize, KRK_OBJ_INSTANCE)
+		: (KrkInstance*)allocateObject(_class->allocSize, KRK_OBJ_INSTANCE);
 	instance->_class = _class;
 	krk_initTable(&instance->fields);
 	return instance;
 }
 
 KrkBoundMethod * krk_newBoundMethod(KrkValue receiver, KrkObj * method) {
-	KrkBoundMethod * bound = ALLOCATE_OBJECT(KrkBoundMethod, KRK_OBJ_BOUND_METHOD);
+	KrkObj * cached = krk_takeCachedObject(&krk_currentThread.boundMethodCache, sizeof(KrkBoundMethod));
+	KrkBoundMethod * bound = cached ? (KrkBoundMethod*)initObject(cached, sizeof(KrkBoundMethod), KRK_OBJ_BOUND_METHOD)
+		: ALLOCATE_OBJECT(KrkBoundMethod, KRK_OBJ_BOUND_METHOD);
 	bound->receiver = receiver;
 	bound->method = method;
 	return bound;
 }
 
 KrkTuple * krk_newTuple(size_t length) {
+	if (length < KRK_CACHE_TUPLE_LENGTHS) {
+		KrkObj * cached = krk_takeCachedObject(&krk_currentThread.tupleCache[length], sizeof(KrkTuple) + sizeof(KrkValue) * length);
+		if (cached) {
+			/* Recycled tuples keep a value array of exactly this capacity. */
+			KrkValue * values = ((KrkTuple*)cached)->values.values;
+			KrkTuple * tuple = (KrkTuple*)initObject(cached, sizeof(KrkTuple), KRK_OBJ_TUPLE);
+			tuple->values.capacity = length;
+			tuple->values.values = values;
+			return tuple;
+		}
+	}
 	KrkTuple * tuple = ALLOCATE_OBJECT(KrkTuple, KRK_OBJ_TUPLE);
 	krk_initValueArray(&tuple->values);
 	krk_push(OBJECT_VAL(tuple));
@@ -364,7 +498,7 @@ KrkBytes * krk_newBytes(size_t length, uint8_t * source) {
 	krk_push(OBJECT_VAL(bytes));
 	bytes->bytes  = ALLOCATE(uint8_t, length);
 	bytes->obj.hash = -1;
-	if (source) {
+	if (source && length) {
 		memcpy(bytes->bytes, source, length);
 	}
 	krk_pop();
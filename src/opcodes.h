@@ -110,5 +110,8 @@ SIMPLE(OP_INPLACE_MULTIPLY)
 OPERAND(OP_EXPAND_ARGS,EXPAND_ARGS_MORE)
 SIMPLE(OP_INHERIT)
 JUMP(OP_CALL_ITER,+)
+OPERAND(OP_RANGE_START, (void)0)
+JUMP(OP_RANGE_ITER,+)
+JUMP(OP_RANGE_LOOP,-)
 JUMP(OP_JUMP_IF_TRUE_OR_POP,+)
 SIMPLE(OP_TRY_ELSE)
@@ -120,7 +120,9 @@ int krk_parseVArgs(
 
 		int wasPositional = 0;
 		KrkValue arg = KWARGS_VAL(0);
-		krk_push(OBJECT_VAL(krk_copyString(names[oarg],strlen(names[oarg]))));
+		/* The name is only needed to look up a keyword argument or to report a missing one,
+		 * so plain positional calls skip interning it. */
+		krk_push((hasKw || (required && iarg >= argc)) ? OBJECT_VAL(krk_copyString(names[oarg],strlen(names[oarg]))) : NONE_VAL());
 
 		if (iarg < argc) {
 			/* Positional arguments are pretty straightforward. */
@@ -349,7 +351,7 @@ int krk_parseVArgs(
 		 * remaining key (or keys) should be a string, so we should find at least one
 		 * thing to complain about by name...
 		 */
-		for (size_t i = 0; i < AS_DICT(argv[argc])->capacity; ++i) {
+		for (size_t i = 0; i < AS_DICT(argv[argc])->used; ++i) {
 			KrkTableEntry * entry = &AS_DICT(argv[argc])->entries[i];
 			if (IS_STRING(entry->key)) {
 				krk_runtimeError(vm.exceptions->typeError, "%s() got an unexpected keyword argument '%S'",
@@ -1,3 +1,4 @@
+#pragma once
 /**
  * @file private.h
  * @brief Internal header.
@@ -6,12 +7,14 @@
  * They are used internally by the interpreter library.
  */
 #include "kuroko/kuroko.h"
+#include "kuroko/object.h"
 
 extern void _createAndBind_numericClasses(void);
 extern void _createAndBind_strClass(void);
 extern void _createAndBind_listClass(void);
 extern void _createAndBind_tupleClass(void);
 extern void _createAndBind_bytesClass(void);
+extern void _createAndBind_memoryviewClass(void);
 extern void _createAndBind_dictClass(void);
 extern void _createAndBind_functionClass(void);
 extern void _createAndBind_rangeClass(void);
@@ -24,6 +27,49 @@ extern void _createAndBind_exceptions(void);
 extern void _createAndBind_longClass(void);
 extern void _createAndBind_compilerClass(void);
 
+/**
+ * @brief Copy the contents of a bytes-like object into a new @c bytes.
+ *
+ * Unlike going through @c krk_getBuffer directly, this also accepts
+ * @c memoryview slices whose items are not adjacent.
+ *
+ * @return The new @c bytes object, or @c None with an exception set.
+ */
+extern KrkValue krk_bufferToBytes(KrkValue value);
+
+/**
+ * @brief Find the first occurrence of a byte sequence in another.
+ *
+ * Shared search kernel for @c str and @c bytes methods. Uses @c memchr
+ * to find candidates and falls back to a Two-Way search, so the worst
+ * case remains linear in the length of the haystack.
+ *
+ * @return Pointer to the start of the match, or @c NULL if not found.
+ */
+extern const char * krk_memmem(const char * haystack, size_t haystackLen, const char * needle, size_t needleLength);
+
+/**
+ * @brief Format a double as the shortest string that parses back to it.
+ *
+ * Output matches Python's @c repr for floats, including @c inf, @c nan
+ * and exponent notation outside of 1e-4 to 1e16. @p out must have room
+ * for at least 32 bytes.
+ *
+ * @return Length of the string written to @p out, which is nul-terminated.
+ */
+extern size_t krk_doubleToString(double value, char * out);
+
+/**
+ * @brief Parse a decimal float literal, as accepted by @c float(str).
+ *
+ * Allows surrounding whitespace, a sign, underscores between digits,
+ * an exponent, and the special values @c inf, @c infinity and @c nan.
+ * The result is correctly rounded.
+ *
+ * @return 0 on success, nonzero if @p str is not a valid float.
+ */
+extern int krk_parseDouble(const char * str, size_t len, double * out);
+
 /**
  * @brief Index numbers for always-available interned strings representing important method and member names.
  *
@@ -62,3 +108,80 @@ struct ParsedFormatSpec {
 	int hasPrecision;
 	int fillSize;
 };
+
+/**
+ * @brief Size of the single allocation backing a table's entries and index.
+ *
+ * Covers the entries array, the control bytes, and the hash index.
+ */
+extern size_t krk_tableBytes(size_t capacity);
+
+/**
+ * @brief Take an object from one of the current thread's free lists.
+ *
+ * The object is counted as @p size allocated bytes again, and a collection
+ * may run first if one is due. The caller must reinitialize it.
+ *
+ * @return The recycled object, or @c NULL if the list was empty.
+ */
+extern KrkObj * krk_takeCachedObject(struct KrkObjectCache * cache, size_t size);
+
+/**
+ * @brief Release the objects held in the current thread's free lists.
+ */
+extern void krk_freeObjectCaches(void);
+
+/*
+ * Layouts of the builtin iterator types. The VM advances these directly
+ * in OP_CALL_ITER and OP_LOOP_ITER instead of calling their __call__.
+ */
+struct ListIterator {
+	KrkInstance inst;
+	KrkValue l;
+	size_t i;
+};
+
+struct TupleIter {
+	KrkInstance inst;
+	KrkValue myTuple;
+	size_t i;
+};
+
+struct RangeIterator {
+	KrkInstance inst;
+	krk_integer_type i;
+	krk_integer_type max;
+	krk_integer_type step;
+};
+
+/**
+ * @brief Length in bytes of the UTF-8 sequence that starts with lead byte @p c.
+ *
+ * Only meaningful on validated string data, where @p c is known to be a lead byte.
+ */
+#define UTF8_LEAD_BYTES(c) ((c) < 0x80 ? 1 : ((c) < 0xE0 ? 2 : ((c) < 0xF0 ? 3 : 4)))
+
+struct StrIterator {
+	KrkInstance inst;
+	KrkValue s;
+	size_t offset; /**< Byte offset of the next codepoint */
+};
+
+/**
+ * @brief Layout of a @c bytearray.
+ *
+ * The storage is over-allocated, so @c capacity may exceed @c length.
+ */
+struct ByteArray {
+	KrkInstance inst;
+	uint8_t * bytes;
+	size_t length;
+	size_t capacity;
+};
+
+/**
+ * @brief Produce the next character from a string iterator.
+ *
+ * @return A one-character string, or the iterator itself when exhausted.
+ */
+extern KrkValue krk_strIteratorNext(struct StrIterator * self);
@@ -176,7 +176,15 @@ static KrkToken number(KrkScanner * scanner, char c) {
 	/* Floating point */
 	if (peek(scanner) == '.' && isDigit(peekNext(scanner, 1))) {
 		advance(scanner);
-		while (isDigit(peek(scanner))) advance(scanner);
+		while (isDigit(peek(scanner)) || peek(scanner) == '_') advance(scanner);
+	}
+
+	/* Exponent */
+	if ((peek(scanner) == 'e' || peek(scanner) == 'E') && (isDigit(peekNext(scanner, 1)) ||
+	    ((peekNext(scanner, 1) == '+' || peekNext(scanner, 1) == '-') && isDigit(peekNext(scanner, 2))))) {
+		advance(scanner);
+		if (peek(scanner) == '+' || peek(scanner) == '-') advance(scanner);
+		while (isDigit(peek(scanner)) || peek(scanner) == '_') advance(scanner);
 	}
 
 	return makeToken(scanner, TOKEN_NUMBER);
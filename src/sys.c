@@ -3,6 +3,8 @@
 #include <kuroko/object.h>
 #include <kuroko/util.h>
 
+#include "private.h"
+
 #define KRK_VERSION_MAJOR  1
 #define KRK_VERSION_MINOR  3
 #define KRK_VERSION_PATCH  0
@@ -61,6 +63,9 @@ KRK_Function(getsizeof) {
 		case KRK_OBJ_STRING: {
 			KrkString * self = AS_STRING(argv[0]);
 			mySize += sizeof(KrkString) + self->length + 1; /* For the UTF8 */
+			if (self->index) {
+				mySize += sizeof(size_t) * ((self->codesLength + KRK_STRING_INDEX_STRIDE - 1) / KRK_STRING_INDEX_STRIDE);
+			}
 			if (self->codes && self->chars != self->codes) {
 				if ((self->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) <= KRK_OBJ_FLAGS_STRING_UCS1) mySize += self->codesLength;
 				else if ((self->obj.flags & KRK_OBJ_FLAGS_STRING_MASK) == KRK_OBJ_FLAGS_STRING_UCS2) mySize += 2 * self->codesLength;
@@ -102,13 +107,13 @@ KRK_Function(getsizeof) {
 		case KRK_OBJ_CLASS: {
 			KrkClass * self = AS_CLASS(argv[0]);
 			mySize += sizeof(KrkClass);
-			mySize += sizeof(KrkTableEntry) * self->methods.capacity;
-			mySize += sizeof(KrkTableEntry) * self->subclasses.capacity;
+			mySize += krk_tableBytes(self->methods.capacity);
+			mySize += krk_tableBytes(self->subclasses.capacity);
 			break;
 		}
 		case KRK_OBJ_INSTANCE: {
 			KrkInstance * self = AS_INSTANCE(argv[0]);
-			mySize += sizeof(KrkTableEntry) * self->fields.capacity;
+			mySize += krk_tableBytes(self->fields.capacity);
 			KrkClass * type = krk_getType(argv[0]);
 			mySize += type->allocSize; /* All instance types have an allocSize set */
 
@@ -116,7 +121,7 @@ KRK_Function(getsizeof) {
 			if (krk_isInstanceOf(argv[0], vm.baseClasses->listClass)) {
 				mySize += sizeof(KrkValue) * AS_LIST(argv[0])->capacity;
 			} else if (krk_isInstanceOf(argv[0], vm.baseClasses->dictClass)) {
-				mySize += sizeof(KrkTableEntry) * AS_DICT(argv[0])->capacity;
+				mySize += krk_tableBytes(AS_DICT(argv[0])->capacity);
 			}
 			break;
 		}
@@ -159,7 +164,7 @@ KRK_Function(modules) {
 	FUNCTION_TAKES_NONE();
 	KrkValue moduleList = krk_list_of(0,NULL,0);
 	krk_push(moduleList);
-	for (size_t i = 0; i < vm.modules.capacity; ++i) {
+	for (size_t i = 0; i < vm.modules.used; ++i) {
 		KrkTableEntry * entry = &vm.modules.entries[i];
 		if (IS_KWARGS(entry->key)) continue;
 		krk_writeValueArray(AS_LIST(moduleList), entry->key);
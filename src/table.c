@@ -9,16 +9,165 @@
 #include <kuroko/threads.h>
 #include <kuroko/util.h>
 
-#define TABLE_MAX_LOAD 0.75
+#include "private.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* The entries array holds 3/4 as many pairs as the index has slots. */
+#define INDEX_SIZE(capacity) ((capacity) / 3 * 4)
+#define USABLE(indexSize)    ((indexSize) / 4 * 3)
+
+/*
+ * Each index slot has a control byte: either one of these markers, or
+ * a 7-bit tag taken from the hash of the key it points to. Lookups match
+ * tags a whole group of control bytes at a time, so most slots holding
+ * other keys are rejected without touching the entries array at all.
+ */
+#define CTRL_EMPTY   0x80
+#define CTRL_DELETED 0xFE
+
+static inline uint8_t hashTag(uint32_t hash) {
+	/* Mix first: small integers hash to themselves and would all share a tag. */
+	return (uint32_t)(hash * 2654435761U) >> 25;
+}
+
+#ifdef __SSE2__
+#define GROUP_WIDTH 16
+typedef uint32_t GroupMask;
+#define GROUP_SLOT(mask) ((size_t)__builtin_ctz(mask))
+
+static inline GroupMask groupMatch(const uint8_t * group, uint8_t tag) {
+	__m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag)));
+}
+
+static inline GroupMask groupMatchEmpty(const uint8_t * group) {
+	return groupMatch(group, CTRL_EMPTY);
+}
+
+static inline GroupMask groupMatchFree(const uint8_t * group) {
+	return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+}
+#else
+/* Portable fallback: eight control bytes at a time, one flag bit at the top of each byte. */
+#define GROUP_WIDTH 8
+typedef uint64_t GroupMask;
+#define GROUP_SLOT(mask) ((size_t)__builtin_ctzll(mask) / 8)
+#define LSB 0x0101010101010101ULL
+#define MSB 0x8080808080808080ULL
+
+static inline uint64_t groupLoad(const uint8_t * group) {
+	uint64_t word;
+	memcpy(&word, group, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	word = __builtin_bswap64(word);
+#endif
+	return word;
+}
+
+/* May flag a byte directly above a real match; callers always verify keys. */
+static inline GroupMask groupMatch(const uint8_t * group, uint8_t tag) {
+	uint64_t x = groupLoad(group) ^ (LSB * tag);
+	return (x - LSB) & ~x & MSB;
+}
+
+static inline GroupMask groupMatchEmpty(const uint8_t * group) {
+	uint64_t word = groupLoad(group);
+	return word & ~(word << 1) & MSB;
+}
+
+static inline GroupMask groupMatchFree(const uint8_t * group) {
+	return groupLoad(group) & MSB;
+}
+#undef LSB
+#undef MSB
+#endif
+
+/* Tables smaller than a group are padded with deleted markers up to a full group. */
+#define CTRL_BYTES(indexSize) ((indexSize) < GROUP_WIDTH ? GROUP_WIDTH : (indexSize))
+
+/* Width of an index slot, chosen so that every entry offset fits. */
+static inline size_t indexWidth(size_t indexSize) {
+	if (indexSize <= 0x100) return 1;
+	if (indexSize <= 0x10000) return 2;
+	if (indexSize <= 0x100000000ULL) return 4;
+	return 8;
+}
+
+_noexport
+size_t krk_tableBytes(size_t capacity) {
+	size_t indexSize = INDEX_SIZE(capacity);
+	if (!capacity) return 0;
+	return sizeof(KrkTableEntry) * capacity + CTRL_BYTES(indexSize) + indexWidth(indexSize) * indexSize;
+}
+
+static inline uint8_t * getCtrl(const KrkTable * table) {
+	return (uint8_t*)&table->entries[table->capacity];
+}
+
+static inline size_t getIndex(const KrkTable * table, size_t width, size_t slot) {
+	void * index = getCtrl(table) + CTRL_BYTES(INDEX_SIZE(table->capacity));
+	switch (width) {
+		case 1:  return ((uint8_t*)index)[slot];
+		case 2:  return ((uint16_t*)index)[slot];
+		case 4:  return ((uint32_t*)index)[slot];
+		default: return ((uint64_t*)index)[slot];
+	}
+}
+
+static inline void setSlot(KrkTable * table, size_t slot, uint8_t tag, size_t value) {
+	size_t indexSize = INDEX_SIZE(table->capacity);
+	void * index = getCtrl(table) + CTRL_BYTES(indexSize);
+	getCtrl(table)[slot] = tag;
+	switch (indexWidth(indexSize)) {
+		case 1:  ((uint8_t*)index)[slot]  = value; break;
+		case 2:  ((uint16_t*)index)[slot] = value; break;
+		case 4:  ((uint32_t*)index)[slot] = value; break;
+		default: ((uint64_t*)index)[slot] = value; break;
+	}
+}
+
+/* Groups are aligned; tables smaller than a group have just the one. */
+static inline size_t firstGroup(uint32_t hash, size_t indexSize) {
+	return indexSize < GROUP_WIDTH ? 0 : (hash & (indexSize - 1) & ~(size_t)(GROUP_WIDTH - 1));
+}
+
+static inline size_t nextGroup(size_t pos, size_t indexSize) {
+	return indexSize < GROUP_WIDTH ? 0 : ((pos + GROUP_WIDTH) & (indexSize - 1));
+}
+
+/*
+ * Walk the probe sequence for a hash, running @c MATCHES on each entry
+ * whose tag matches and stopping at the first group with an empty slot.
+ */
+#define PROBE(table, hash, MATCHES) do { \
+	size_t _size  = INDEX_SIZE((table)->capacity); \
+	size_t _width = indexWidth(_size); \
+	uint8_t _tag  = hashTag(hash); \
+	const uint8_t * _ctrl = getCtrl(table); \
+	for (size_t _pos = firstGroup(hash, _size);; _pos = nextGroup(_pos, _size)) { \
+		for (GroupMask _m = groupMatch(_ctrl + _pos, _tag); _m; _m &= _m - 1) { \
+			size_t slot = _pos + GROUP_SLOT(_m); \
+			if (_ctrl[slot] != _tag) continue; \
+			size_t ix = getIndex((table), _width, slot); \
+			KrkTableEntry * entry = &(table)->entries[ix]; \
+			MATCHES \
+		} \
+		if (groupMatchEmpty(_ctrl + _pos)) break; \
+	} \
+} while (0)
 
 void krk_initTable(KrkTable * table) {
 	table->count = 0;
 	table->capacity = 0;
+	table->used = 0;
 	table->entries = NULL;
 }
 
 void krk_freeTable(KrkTable * table) {
-	FREE_ARRAY(KrkTableEntry, table->entries, table->capacity);
+	if (table->entries) krk_reallocate(table->entries, krk_tableBytes(table->capacity), 0);
 	krk_initTable(table);
 }
 
@@ -59,52 +208,32 @@ _unhashable:
 	return 1;
 }
 
-KrkTableEntry * krk_findEntry(KrkTableEntry * entries, size_t capacity, KrkValue key) {
-	uint32_t index;
-	if (krk_hashValue(key, &index)) {
-		return NULL;
-	}
-	index &= (capacity-1);
-	KrkTableEntry * tombstone = NULL;
-	for (;;) {
-		KrkTableEntry * entry = &entries[index];
-		if (IS_KWARGS(entry->key)) {
-			if (IS_NONE(entry->value)) {
-				return tombstone != NULL ? tombstone : entry;
-			} else {
-				if (tombstone == entry) return tombstone;
-				if (tombstone == NULL) tombstone = entry;
-			}
-		} else if (krk_valuesSameOrEqual(entry->key, key)) {
-			return entry;
-		}
-		index = (index + 1) & (capacity-1);
-	}
+static ssize_t lookup(KrkTable * table, KrkValue key, uint32_t hash, int exact) {
+	PROBE(table, hash, {
+		if (exact ? krk_valuesSame(entry->key, key) : krk_valuesSameOrEqual(entry->key, key)) return ix;
+	});
+	return -1;
 }
 
-KrkTableEntry * krk_findEntryExact(KrkTableEntry * entries, size_t capacity, KrkValue key) {
-	uint32_t index;
-	if (krk_hashValue(key, &index)) {
-		return NULL;
-	}
-	index &= (capacity-1);
-	KrkTableEntry * tombstone = NULL;
-	for (;;) {
-		KrkTableEntry * entry = &entries[index];
-		if (IS_KWARGS(entry->key)) {
-			if (IS_NONE(entry->value)) {
-				return tombstone != NULL ? tombstone : entry;
-			} else {
-				if (tombstone == entry) return tombstone;
-				if (tombstone == NULL) tombstone = entry;
-			}
-		} else if (krk_valuesSame(entry->key, key)) {
-			return entry;
-		}
-		index = (index + 1) & (capacity-1);
+/* Find an index slot for a key known not to be in the table. */
+static size_t freeSlotFor(KrkTable * table, uint32_t hash) {
+	size_t size = INDEX_SIZE(table->capacity);
+	const uint8_t * ctrl = getCtrl(table);
+	for (size_t pos = firstGroup(hash, size);; pos = nextGroup(pos, size)) {
+		GroupMask m = groupMatchFree(ctrl + pos);
+		/* Padding past the end of a small table looks free, but isn't. */
+		while (m && pos + GROUP_SLOT(m) >= size) m &= m - 1;
+		if (m) return pos + GROUP_SLOT(m);
 	}
 }
 
+KrkTableEntry * krk_findEntry(KrkTable * table, KrkValue key) {
+	uint32_t hash;
+	if (!table->count || krk_hashValue(key, &hash)) return NULL;
+	ssize_t ix = lookup(table, key, hash, 0);
+	return ix < 0 ? NULL : &table->entries[ix];
+}
+
 #ifdef __TINYC__
 int __builtin_clz(unsigned int x) {
 	int i = 31;
@@ -114,60 +243,83 @@ int __builtin_clz(unsigned int x) {
 #endif
 
 void krk_tableAdjustCapacity(KrkTable * table, size_t capacity) {
-	if (capacity) {
-		/* Fast power-of-two calculation */
-		size_t powerOfTwoCapacity = __builtin_clz(1) - __builtin_clz(capacity);
-		if ((1UL << powerOfTwoCapacity) != capacity) powerOfTwoCapacity++;
-		capacity = (1UL << powerOfTwoCapacity);
-	}
+	/* Fast power-of-two calculation of the index size */
+	size_t indexSize = capacity + capacity / 3;
+	if (indexSize < 8) indexSize = 8;
+	size_t powerOfTwo = __builtin_clz(1) - __builtin_clz(indexSize);
+	if ((1UL << powerOfTwo) != indexSize) powerOfTwo++;
+	indexSize = (1UL << powerOfTwo);
+	capacity = USABLE(indexSize);
+	if (capacity < table->count) return;
 
-	KrkTableEntry * entries = ALLOCATE(KrkTableEntry, capacity);
+	KrkTable newTable;
+	newTable.capacity = capacity;
+	newTable.count = 0;
+	newTable.used = 0;
+	newTable.entries = krk_reallocate(NULL, 0, krk_tableBytes(capacity));
 	for (size_t i = 0; i < capacity; ++i) {
-		entries[i].key = KWARGS_VAL(0);
-		entries[i].value = NONE_VAL();
+		newTable.entries[i].key = KWARGS_VAL(0);
+		newTable.entries[i].value = NONE_VAL();
 	}
+	memset(getCtrl(&newTable), CTRL_EMPTY, indexSize);
+	memset(getCtrl(&newTable) + indexSize, CTRL_DELETED, CTRL_BYTES(indexSize) - indexSize);
 
-	table->count = 0;
-	for (size_t i = 0; i < table->capacity; ++i) {
+	/* Entries move over in order, which also squeezes out deleted pairs. */
+	for (size_t i = 0; i < table->used; ++i) {
 		KrkTableEntry * entry = &table->entries[i];
 		if (IS_KWARGS(entry->key)) continue;
-		KrkTableEntry * dest = krk_findEntry(entries, capacity, entry->key);
-		dest->key = entry->key;
-		dest->value = entry->value;
-		table->count++;
+		uint32_t hash = 0;
+		krk_hashValue(entry->key, &hash);
+		setSlot(&newTable, freeSlotFor(&newTable, hash), hashTag(hash), newTable.used);
+		newTable.entries[newTable.used++] = *entry;
+		newTable.count++;
 	}
 
-	FREE_ARRAY(KrkTableEntry, table->entries, table->capacity);
-	table->entries = entries;
-	table->capacity = capacity;
+	krk_freeTable(table);
+	*table = newTable;
+}
+
+/* Make room for one more entry at the end of the entries array. */
+static void makeRoom(KrkTable * table) {
+	if (table->used < table->capacity) return;
+	/* If deletions freed up enough space, rebuild at the same size; otherwise grow. */
+	if (table->count + 1 <= table->capacity / 2) {
+		krk_tableAdjustCapacity(table, table->capacity);
+	} else {
+		krk_tableAdjustCapacity(table, USABLE(GROW_CAPACITY(INDEX_SIZE(table->capacity))));
+	}
 }
 
 int krk_tableSet(KrkTable * table, KrkValue key, KrkValue value) {
-	if (table->count + 1 > table->capacity * TABLE_MAX_LOAD) {
-		size_t capacity = GROW_CAPACITY(table->capacity);
-		krk_tableAdjustCapacity(table, capacity);
+	uint32_t hash;
+	if (krk_hashValue(key, &hash)) return 0;
+	if (table->count) {
+		ssize_t ix = lookup(table, key, hash, 0);
+		if (ix >= 0) {
+			table->entries[ix].key = key;
+			table->entries[ix].value = value;
+			return 0;
+		}
 	}
-	KrkTableEntry * entry = krk_findEntry(table->entries, table->capacity, key);
-	if (!entry) return 0;
-	int isNewKey = IS_KWARGS(entry->key);
-	if (isNewKey) table->count++;
-	entry->key = key;
-	entry->value = value;
-	return isNewKey;
+	makeRoom(table);
+	setSlot(table, freeSlotFor(table, hash), hashTag(hash), table->used);
+	table->entries[table->used].key = key;
+	table->entries[table->used].value = value;
+	table->used++;
+	table->count++;
+	return 1;
 }
 
 int krk_tableSetIfExists(KrkTable * table, KrkValue key, KrkValue value) {
-	if (table->count == 0) return 0;
-	KrkTableEntry * entry = krk_findEntry(table->entries, table->capacity, key);
+	KrkTableEntry * entry = krk_findEntry(table, key);
 	if (!entry) return 0;
-	if (IS_KWARGS(entry->key)) return 0; /* Not found */
 	entry->key = key;
 	entry->value = value;
 	return 1;
 }
 
 void krk_tableAddAll(KrkTable * from, KrkTable * to) {
-	for (size_t i = 0; i < from->capacity; ++i) {
+	for (size_t i = 0; i < from->used; ++i) {
 		KrkTableEntry * entry = &from->entries[i];
 		if (!IS_KWARGS(entry->key)) {
 			krk_tableSet(to, entry->key, entry->value);
@@ -176,69 +328,53 @@ void krk_tableAddAll(KrkTable * from, KrkTable * to) {
 }
 
 int krk_tableGet(KrkTable * table, KrkValue key, KrkValue * value) {
-	if (table->count == 0) return 0;
-	KrkTableEntry * entry = krk_findEntry(table->entries, table->capacity, key);
-	if (!entry || IS_KWARGS(entry->key)) {
-		return 0;
-	} else {
-		*value = entry->value;
-		return 1;
-	}
+	KrkTableEntry * entry = krk_findEntry(table, key);
+	if (!entry) return 0;
+	*value = entry->value;
+	return 1;
 }
 
 int krk_tableGet_fast(KrkTable * table, KrkString * str, KrkValue * value) {
 	if (unlikely(table->count == 0)) return 0;
-	uint32_t index = str->obj.hash & (table->capacity-1);
-	for (;;) {
-		KrkTableEntry * entry = &table->entries[index];
-		if (entry->key == KWARGS_VAL(0)) return 0;
+	PROBE(table, str->obj.hash, {
 		if (entry->key == OBJECT_VAL(str)) {
 			*value = entry->value;
 			return 1;
 		}
-		index = (index + 1) & (table->capacity-1);
-	}
+	});
+	return 0;
+}
+
+static int deleteEntry(KrkTable * table, KrkValue key, int exact) {
+	uint32_t hash;
+	if (table->count == 0 || krk_hashValue(key, &hash)) return 0;
+	PROBE(table, hash, {
+		if (exact ? krk_valuesSame(entry->key, key) : krk_valuesSameOrEqual(entry->key, key)) {
+			getCtrl(table)[slot] = CTRL_DELETED;
+			entry->key = KWARGS_VAL(0);
+			entry->value = KWARGS_VAL(0);
+			table->count--;
+			return 1;
+		}
+	});
+	return 0;
 }
 
 int krk_tableDelete(KrkTable * table, KrkValue key) {
-	if (table->count == 0) return 0;
-	KrkTableEntry * entry = krk_findEntry(table->entries, table->capacity, key);
-	if (!entry || IS_KWARGS(entry->key)) {
-		return 0;
-	}
-	table->count--;
-	entry->key = KWARGS_VAL(0);
-	entry->value = KWARGS_VAL(0);
-	return 1;
+	return deleteEntry(table, key, 0);
 }
 
 int krk_tableDeleteExact(KrkTable * table, KrkValue key) {
-	if (table->count == 0) return 0;
-	KrkTableEntry * entry = krk_findEntryExact(table->entries, table->capacity, key);
-	if (!entry || IS_KWARGS(entry->key)) {
-		return 0;
-	}
-	table->count--;
-	entry->key = KWARGS_VAL(0);
-	entry->value = KWARGS_VAL(0);
-	return 1;
+	return deleteEntry(table, key, 1);
 }
 
 KrkString * krk_tableFindString(KrkTable * table, const char * chars, size_t length, uint32_t hash) {
 	if (table->count == 0) return NULL;
-
-	uint32_t index = hash & (table->capacity-1);
-	for (;;) {
-		KrkTableEntry * entry = &table->entries[index];
-		if (IS_KWARGS(entry->key)) {
-			if (IS_NONE(entry->value)) {
-				return NULL;
-			}
-		} else if (AS_STRING(entry->key)->length == length &&
-		           AS_OBJECT(entry->key)->hash == hash &&
-		           memcmp(AS_STRING(entry->key)->chars, chars, length) == 0) {
-			return AS_STRING(entry->key);
+	PROBE(table, hash, {
+		KrkString * key = AS_STRING(entry->key);
+		if (key->length == length && key->obj.hash == hash && memcmp(key->chars, chars, length) == 0) {
+			return key;
 		}
-		index = (index + 1) & (table->capacity-1);
-	}
+	});
+	return NULL;
 }
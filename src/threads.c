@@ -5,6 +5,8 @@
 #ifndef KRK_DISABLE_THREADS
 #include <kuroko/util.h>
 
+#include "private.h"
+
 #include <unistd.h>
 #include <pthread.h>
 
@@ -104,6 +106,7 @@ static void * _startthread(void * _threadObj) {
 	}
 	_release_lock(_threadLock);
 
+	krk_freeObjectCaches();
 	FREE_ARRAY(size_t, krk_currentThread.stack, krk_currentThread.stackSize);
 	free(krk_currentThread.frames);
 
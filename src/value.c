@@ -7,6 +7,7 @@
 #include <kuroko/util.h>
 
 #include "opcode_enum.h"
+#include "private.h"
 
 void krk_initValueArray(KrkValueArray * array) {
 	array->values = NULL;
@@ -84,7 +85,11 @@ void krk_printValueSafe(FILE * f, KrkValue printable) {
 				break;
 			}
 			default:
-				if (IS_FLOATING(printable)) fprintf(f, "%.16g", AS_FLOATING(printable));
+				if (IS_FLOATING(printable)) {
+					char tmp[32];
+					krk_doubleToString(AS_FLOATING(printable), tmp);
+					fprintf(f, "%s", tmp);
+				}
 				break;
 		}
 	} else if (IS_STRING(printable)) {
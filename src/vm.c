@@ -261,7 +261,7 @@ void krk_finalizeClass(KrkClass * _class) {
 		}
 	}
 
-	for (size_t i = 0; i < _class->subclasses.capacity; ++i) {
+	for (size_t i = 0; i < _class->subclasses.used; ++i) {
 		KrkTableEntry * entry = &_class->subclasses.entries[i];
 		if (IS_KWARGS(entry->key)) continue;
 		krk_finalizeClass(AS_CLASS(entry->key));
@@ -277,7 +277,7 @@ static void _callSetName(KrkClass * _class) {
 	extern FUNC_SIG(list,append);
 
 	/* The semantics of this require that we first collect all of the relevant items... */
-	for (size_t i = 0; i < _class->methods.capacity; ++i) {
+	for (size_t i = 0; i < _class->methods.used; ++i) {
 		KrkTableEntry * entry = &_class->methods.entries[i];
 		if (!IS_KWARGS(entry->key)) {
 			KrkClass * type = krk_getType(entry->value);
@@ -441,7 +441,7 @@ int krk_processComplexArguments(int argCount, KrkValueArray * positionals, KrkTa
 					krk_runtimeError(vm.exceptions->typeError, "%s(): **expression value is not a dict.", name);
 					return 0;
 				}
-				for (size_t i = 0; i < AS_DICT(value)->capacity; ++i) {
+				for (size_t i = 0; i < AS_DICT(value)->used; ++i) {
 					KrkTableEntry * entry = &AS_DICT(value)->entries[i];
 					if (!IS_KWARGS(entry->key)) {
 						if (!IS_STRING(entry->key)) {
@@ -550,7 +550,7 @@ static inline int _callManaged(KrkClosure * closure, int argCount, int returnDep
 		krk_currentThread.scratchSpace[0] = NONE_VAL();
 
 		/* Now place keyword arguments */
-		for (size_t i = 0; i < keywords->capacity; ++i) {
+		for (size_t i = 0; i < keywords->used; ++i) {
 			KrkTableEntry * entry = &keywords->entries[i];
 			if (!IS_KWARGS(entry->key)) {
 				KrkValue name = entry->key;
@@ -993,6 +993,7 @@ void krk_initVM(int flags) {
 	_createAndBind_listClass();
 	_createAndBind_tupleClass();
 	_createAndBind_bytesClass();
+	_createAndBind_memoryviewClass();
 	_createAndBind_dictClass();
 	_createAndBind_functionClass();
 	_createAndBind_rangeClass();
@@ -1034,6 +1035,7 @@ void krk_freeVM() {
 	if (vm.exceptions) free(vm.exceptions);
 	if (vm.baseClasses) free(vm.baseClasses);
 	krk_freeObjects();
+	krk_freeObjectCaches();
 
 	if (vm.binpath) free(vm.binpath);
 	if (vm.dbgState) free(vm.dbgState);
@@ -1124,6 +1126,64 @@ MAKE_COMPARE_OP(gt, ">", lt)
 MAKE_COMPARE_OP(le, "<=", ge)
 MAKE_COMPARE_OP(ge, ">=", le)
 
+_protected
+int krk_lessThan(KrkValue a, KrkValue b) {
+	if (IS_INTEGER(a) && IS_INTEGER(b)) return AS_INTEGER(a) < AS_INTEGER(b);
+	if (IS_FLOATING(a) && IS_FLOATING(b)) return AS_FLOATING(a) < AS_FLOATING(b);
+	if (IS_STRING(a) && IS_STRING(b)) {
+		size_t aLen = AS_STRING(a)->length;
+		size_t bLen = AS_STRING(b)->length;
+		int cmp = memcmp(AS_CSTRING(a), AS_CSTRING(b), aLen < bLen ? aLen : bLen);
+		return cmp < 0 || (cmp == 0 && aLen < bLen);
+	}
+	return !krk_isFalsey(krk_operator_lt(a,b));
+}
+
+_protected
+int krk_sequenceLength(KrkValue seq, krk_integer_type * out) {
+	if (IS_list(seq)) {
+		*out = AS_LIST(seq)->count;
+		return 1;
+	}
+	if (IS_TUPLE(seq)) {
+		*out = AS_TUPLE(seq)->values.count;
+		return 1;
+	}
+	KrkClass * type = krk_getType(seq);
+	if (unlikely(!type->_len)) {
+		krk_runtimeError(vm.exceptions->typeError, "object of type '%T' has no len()", seq);
+		return 0;
+	}
+	krk_push(seq);
+	KrkValue len = krk_callDirect(type->_len, 1);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return 0;
+	if (!IS_INTEGER(len)) {
+		krk_runtimeError(vm.exceptions->typeError, "__len__ result was not int");
+		return 0;
+	}
+	*out = AS_INTEGER(len);
+	return 1;
+}
+
+_protected
+KrkValue krk_sequenceItem(KrkValue seq, krk_integer_type i) {
+	/* Lists are re-checked on every access since callers may have run arbitrary code in between. */
+	if (IS_list(seq)) {
+		if (unlikely(i >= (krk_integer_type)AS_LIST(seq)->count)) {
+			return krk_runtimeError(vm.exceptions->indexError, "list index out of range");
+		}
+		return AS_LIST(seq)->values[i];
+	}
+	if (IS_TUPLE(seq)) return AS_TUPLE(seq)->values.values[i];
+	KrkClass * type = krk_getType(seq);
+	if (unlikely(!type->_getter)) {
+		return krk_runtimeError(vm.exceptions->typeError, "'%T' object is not subscriptable", seq);
+	}
+	krk_push(seq);
+	krk_push(INTEGER_VAL(i));
+	return krk_callDirect(type->_getter, 2);
+}
+
 _protected
 KrkValue krk_operator_eq(KrkValue a, KrkValue b) {
 	return BOOLEAN_VAL(krk_valuesEqual(a,b));
@@ -1683,7 +1743,7 @@ static KrkClass * checkCache(KrkClass * type, KrkString * name, KrkValue * metho
 static void clearCache(KrkClass * type) {
 	if (type->cacheIndex) {
 		type->cacheIndex = 0;
-		for (size_t i = 0; i < type->subclasses.capacity; ++i) {
+		for (size_t i = 0; i < type->subclasses.used; ++i) {
 			KrkTableEntry * entry = &type->subclasses.entries[i];
 			if (entry->key == KWARGS_VAL(0)) continue;
 			clearCache(AS_CLASS(entry->key));
@@ -1972,16 +2032,46 @@ KrkValue krk_valueSetAttribute(KrkValue owner, char * name, KrkValue to) {
 
 extern KrkValue krk_int_op_add(krk_integer_type a, krk_integer_type b);
 extern KrkValue krk_int_op_sub(krk_integer_type a, krk_integer_type b);
+extern KrkValue krk_int_op_mul(krk_integer_type a, krk_integer_type b);
 
-/* These operations are most likely to occur on integers, so we special case them */
-#define LIKELY_INT_BINARY_OP(op) { KrkValue b = krk_peek(0); KrkValue a = krk_peek(1); \
+/**
+ * Floats are stored directly in values, so arithmetic between two floats,
+ * or an int and a float, needs no allocation and can be done right here
+ * instead of through the type's methods. The results are the same as
+ * those of the int and float methods, which also convert ints to double.
+ */
+static inline int asFloatPair(KrkValue a, KrkValue b, double * x, double * y) {
+	if (IS_FLOATING(a)) *x = AS_FLOATING(a);
+	else if (IS_INTEGER(a)) *x = (double)AS_INTEGER(a);
+	else return 0;
+	if (IS_FLOATING(b)) *y = AS_FLOATING(b);
+	else if (IS_INTEGER(b)) *y = (double)AS_INTEGER(b);
+	else return 0;
+	return 1;
+}
+
+#ifdef __TINYC__
+#include <math.h>
+#define __builtin_floor floor
+#endif
+
+/* These operations are most likely to occur on integers, then floats, so we special case them */
+#define LIKELY_NUMERIC_BINARY_OP(op,operator,fallback) { KrkValue b = krk_peek(0); KrkValue a = krk_peek(1); double x, y; \
 	if (likely(IS_INTEGER(a) && IS_INTEGER(b))) a = krk_int_op_ ## op (AS_INTEGER(a), AS_INTEGER(b)); \
-	else a = krk_operator_ ## op (a,b); \
+	else if (asFloatPair(a,b,&x,&y)) a = FLOATING_VAL(x operator y); \
+	else a = fallback (a,b); \
+	krk_currentThread.stackTop[-2] = a; krk_pop(); break; }
+
+/* Division always produces a float, but int//int is left to int; division by zero raises from the methods. */
+#define LIKELY_FLOAT_DIVISION_OP(expr,fallback,allowInts) { KrkValue b = krk_peek(0); KrkValue a = krk_peek(1); double x, y; \
+	if ((allowInts || IS_FLOATING(a) || IS_FLOATING(b)) && asFloatPair(a,b,&x,&y) && y != 0.0) a = FLOATING_VAL(expr); \
+	else a = fallback (a,b); \
 	krk_currentThread.stackTop[-2] = a; krk_pop(); break; }
 
 /* Comparators like these are almost definitely going to happen on integers. */
-#define LIKELY_INT_COMPARE_OP(op,operator) { KrkValue b = krk_peek(0); KrkValue a = krk_peek(1); \
+#define LIKELY_NUMERIC_COMPARE_OP(op,operator) { KrkValue b = krk_peek(0); KrkValue a = krk_peek(1); double x, y; \
 	if (likely(IS_INTEGER(a) && IS_INTEGER(b))) a = BOOLEAN_VAL(AS_INTEGER(a) operator AS_INTEGER(b)); \
+	else if (asFloatPair(a,b,&x,&y)) a = BOOLEAN_VAL(x operator y); \
 	else a = krk_operator_ ## op (a,b); \
 	krk_currentThread.stackTop[-2] = a; krk_pop(); break; }
 
@@ -1990,6 +2080,12 @@ extern KrkValue krk_int_op_sub(krk_integer_type a, krk_integer_type b);
 	else a = krk_operator_ ## op (a); \
 	krk_currentThread.stackTop[-1] = a; break; }
 
+#define LIKELY_NUMERIC_UNARY_OP(op,operator) { KrkValue a = krk_peek(0); \
+	if (likely(IS_INTEGER(a))) a = INTEGER_VAL(operator AS_INTEGER(a)); \
+	else if (IS_FLOATING(a)) a = FLOATING_VAL(operator AS_FLOATING(a)); \
+	else a = krk_operator_ ## op (a); \
+	krk_currentThread.stackTop[-1] = a; break; }
+
 #define READ_BYTE() (*frame->ip++)
 #define READ_CONSTANT(s) (frame->closure->function->chunk.constants.values[OPERAND])
 #define READ_STRING(s) AS_STRING(READ_CONSTANT(s))
@@ -2082,6 +2178,208 @@ static inline void commonMethodInvoke(size_t methodOffset, int args, const char
 }
 
 
+/**
+ * @brief Advance a builtin iterator without calling it.
+ *
+ * Sets @p out to the next value, or to @p iter itself once the iterator
+ * is exhausted, exactly as calling the iterator would have.
+ *
+ * @return 1 if @p iter was a builtin iterator and has been advanced, 0 if it needs a real call.
+ */
+static inline int iterateBuiltin(KrkValue iter, KrkValue * out) {
+	if (!IS_INSTANCE(iter)) return 0;
+	KrkClass * type = AS_INSTANCE(iter)->_class;
+	if (type == vm.baseClasses->listiteratorClass) {
+		struct ListIterator * self = (struct ListIterator*)AS_OBJECT(iter);
+		KrkValueArray * list = AS_LIST(self->l);
+		*out = self->i < list->count ? list->values[self->i++] : iter;
+	} else if (type == vm.baseClasses->rangeiteratorClass) {
+		struct RangeIterator * self = (struct RangeIterator*)AS_OBJECT(iter);
+		if (self->step > 0 ? (self->i >= self->max) : (self->i <= self->max)) {
+			*out = iter;
+		} else {
+			*out = INTEGER_VAL(self->i);
+			self->i += self->step;
+		}
+	} else if (type == vm.baseClasses->tupleiteratorClass) {
+		struct TupleIter * self = (struct TupleIter*)AS_OBJECT(iter);
+		KrkTuple * tuple = AS_TUPLE(self->myTuple);
+		*out = self->i < tuple->values.count ? tuple->values.values[self->i++] : iter;
+	} else if (type == vm.baseClasses->dictkeysClass || type == vm.baseClasses->dictvaluesClass) {
+		/* DictKeys and DictValues share a layout */
+		struct DictKeys * self = (struct DictKeys*)AS_OBJECT(iter);
+		KrkTable * table = AS_DICT(self->dict);
+		while (self->i < table->used && IS_KWARGS(table->entries[self->i].key)) self->i++;
+		if (self->i >= table->used) {
+			*out = iter;
+		} else {
+			KrkTableEntry * entry = &table->entries[self->i++];
+			*out = type == vm.baseClasses->dictkeysClass ? entry->key : entry->value;
+		}
+	} else if (type == vm.baseClasses->striteratorClass) {
+		*out = krk_strIteratorNext((struct StrIterator*)AS_OBJECT(iter));
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+
+/**
+ * @brief Subscript a builtin container without calling __getitem__.
+ *
+ * Handles integer indexes into lists, tuples and bytearrays, and string or
+ * integer keys in dicts, when the container is exactly the builtin type.
+ * Subclasses, other index types, and anything that would raise are left
+ * to the regular method call.
+ *
+ * @return 1 if @p out was set, 0 if the method needs to be called.
+ */
+static inline int getterFast(KrkValue container, KrkValue index, KrkValue * out) {
+	if (!IS_OBJECT(container)) return 0;
+	if (IS_INTEGER(index)) {
+		krk_integer_type i = AS_INTEGER(index);
+		if (IS_TUPLE(container)) {
+			KrkTuple * tuple = AS_TUPLE(container);
+			if (i < 0) i += tuple->values.count;
+			if (i < 0 || i >= (krk_integer_type)tuple->values.count) return 0;
+			*out = tuple->values.values[i];
+			return 1;
+		}
+		if (!IS_INSTANCE(container)) return 0;
+		KrkClass * type = AS_INSTANCE(container)->_class;
+		if (type == vm.baseClasses->listClass) {
+			KrkList * list = (KrkList*)AS_OBJECT(container);
+			if (vm.globalFlags & KRK_GLOBAL_THREADS) pthread_rwlock_rdlock(&list->rwlock);
+			if (i < 0) i += list->values.count;
+			int valid = i >= 0 && i < (krk_integer_type)list->values.count;
+			if (valid) *out = list->values.values[i];
+			if (vm.globalFlags & KRK_GLOBAL_THREADS) pthread_rwlock_unlock(&list->rwlock);
+			return valid;
+		} else if (type == vm.baseClasses->bytearrayClass) {
+			struct ByteArray * bytes = (struct ByteArray*)AS_OBJECT(container);
+			if (i < 0) i += bytes->length;
+			if (i < 0 || i >= (krk_integer_type)bytes->length) return 0;
+			*out = INTEGER_VAL(bytes->bytes[i]);
+			return 1;
+		}
+	}
+	if ((IS_STRING(index) || IS_INTEGER(index)) && IS_INSTANCE(container) &&
+	    AS_INSTANCE(container)->_class == vm.baseClasses->dictClass) {
+		return krk_tableGet(AS_DICT(container), index, out);
+	}
+	return 0;
+}
+
+/**
+ * @brief Assign into a builtin container without calling __setitem__.
+ *
+ * The counterpart to getterFast() for lists, bytearrays and dicts.
+ *
+ * @return 1 if the assignment was done, 0 if the method needs to be called.
+ */
+static inline int setterFast(KrkValue container, KrkValue index, KrkValue value) {
+	if (!IS_INSTANCE(container)) return 0;
+	KrkClass * type = AS_INSTANCE(container)->_class;
+	if (IS_INTEGER(index)) {
+		krk_integer_type i = AS_INTEGER(index);
+		if (type == vm.baseClasses->listClass) {
+			KrkList * list = (KrkList*)AS_OBJECT(container);
+			if (vm.globalFlags & KRK_GLOBAL_THREADS) pthread_rwlock_rdlock(&list->rwlock);
+			if (i < 0) i += list->values.count;
+			int valid = i >= 0 && i < (krk_integer_type)list->values.count;
+			if (valid) list->values.values[i] = value;
+			if (vm.globalFlags & KRK_GLOBAL_THREADS) pthread_rwlock_unlock(&list->rwlock);
+			return valid;
+		} else if (type == vm.baseClasses->bytearrayClass && IS_INTEGER(value) && AS_INTEGER(value) >= 0 && AS_INTEGER(value) <= 255) {
+			struct ByteArray * bytes = (struct ByteArray*)AS_OBJECT(container);
+			if (i < 0) i += bytes->length;
+			if (i < 0 || i >= (krk_integer_type)bytes->length) return 0;
+			bytes->bytes[i] = AS_INTEGER(value);
+			return 1;
+		}
+	}
+	if ((IS_STRING(index) || IS_INTEGER(index)) && type == vm.baseClasses->dictClass) {
+		krk_tableSet(AS_DICT(container), index, value);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Set up the state for a counting @c for loop over @c range.
+ *
+ * Replaces the callee and @p argc arguments on the stack with three loop
+ * slots. If the callee is the builtin @c range and all of the arguments are
+ * integers, the slots hold the counter, the stop value and the step.
+ * Otherwise, the callee is called as normal and the slots hold an iterator
+ * over the result, followed by two @c None values.
+ */
+static inline void rangeStart(int argc) {
+	KrkValue * args = krk_currentThread.stackTop - argc;
+	if (args[-1] == OBJECT_VAL(vm.baseClasses->rangeClass)) {
+		krk_integer_type start = 0, stop = 0, step = 1;
+		int valid = 1;
+		for (int i = 0; i < argc; ++i) valid &= IS_INTEGER(args[i]);
+		if (valid) {
+			if (argc == 1) {
+				stop = AS_INTEGER(args[0]);
+			} else {
+				start = AS_INTEGER(args[0]);
+				stop  = AS_INTEGER(args[1]);
+				if (argc == 3) step = AS_INTEGER(args[2]);
+			}
+		}
+		if (valid && step != 0) {
+			krk_currentThread.stackTop -= argc + 1;
+			krk_push(INTEGER_VAL(start));
+			krk_push(INTEGER_VAL(stop));
+			krk_push(INTEGER_VAL(step));
+			return;
+		}
+	}
+	KrkValue iterable = krk_callStack(argc);
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return;
+	krk_push(iterable);
+	commonMethodInvoke(offsetof(KrkClass,_iter), 1, "'%T' object is not iterable");
+	if (unlikely(krk_currentThread.flags & KRK_THREAD_HAS_EXCEPTION)) return;
+	krk_push(NONE_VAL());
+	krk_push(NONE_VAL());
+}
+
+/**
+ * @brief Advance a loop set up by rangeStart().
+ *
+ * The loop variable is always the local directly below the three loop
+ * slots, so the next value is stored there without going through the stack.
+ *
+ * @return 1 if the loop variable was updated, 0 if the loop is finished.
+ */
+static inline int rangeNext(void) {
+	KrkValue * slots = krk_currentThread.stackTop - 3;
+	if (likely(IS_INTEGER(slots[2]))) {
+		krk_integer_type i = AS_INTEGER(slots[0]);
+		krk_integer_type stop = AS_INTEGER(slots[1]);
+		krk_integer_type step = AS_INTEGER(slots[2]);
+		if (step > 0 ? (i >= stop) : (i <= stop)) return 0;
+		/* Clamp to the stop value so the counter can never overflow its boxed range */
+		krk_integer_type next = i + step;
+		slots[0] = INTEGER_VAL((step > 0 ? (next > stop) : (next < stop)) ? stop : next);
+		slots[-1] = INTEGER_VAL(i);
+		return 1;
+	}
+	KrkValue iter = slots[0];
+	KrkValue next;
+	if (!iterateBuiltin(iter, &next)) {
+		krk_push(iter);
+		next = krk_callStack(0);
+	}
+	if (next == iter) return 0;
+	krk_currentThread.stackTop[-4] = next;
+	return 1;
+}
+
+
 /**
  * VM main loop.
  */
@@ -2204,15 +2502,15 @@ _finishReturn: (void)0;
 				frame = &krk_currentThread.frames[krk_currentThread.frameCount - 1];
 				break;
 			}
-			case OP_LESS:          LIKELY_INT_COMPARE_OP(lt,<)
-			case OP_GREATER:       LIKELY_INT_COMPARE_OP(gt,>)
-			case OP_LESS_EQUAL:    LIKELY_INT_COMPARE_OP(le,<=)
-			case OP_GREATER_EQUAL: LIKELY_INT_COMPARE_OP(ge,>=)
-			case OP_ADD:           LIKELY_INT_BINARY_OP(add)
-			case OP_SUBTRACT:      LIKELY_INT_BINARY_OP(sub)
-			case OP_MULTIPLY:      BINARY_OP(mul)
-			case OP_DIVIDE:        BINARY_OP(truediv)
-			case OP_FLOORDIV:      BINARY_OP(floordiv)
+			case OP_LESS:          LIKELY_NUMERIC_COMPARE_OP(lt,<)
+			case OP_GREATER:       LIKELY_NUMERIC_COMPARE_OP(gt,>)
+			case OP_LESS_EQUAL:    LIKELY_NUMERIC_COMPARE_OP(le,<=)
+			case OP_GREATER_EQUAL: LIKELY_NUMERIC_COMPARE_OP(ge,>=)
+			case OP_ADD:           LIKELY_NUMERIC_BINARY_OP(add,+,krk_operator_add)
+			case OP_SUBTRACT:      LIKELY_NUMERIC_BINARY_OP(sub,-,krk_operator_sub)
+			case OP_MULTIPLY:      LIKELY_NUMERIC_BINARY_OP(mul,*,krk_operator_mul)
+			case OP_DIVIDE:        LIKELY_FLOAT_DIVISION_OP(x / y,krk_operator_truediv,1)
+			case OP_FLOORDIV:      LIKELY_FLOAT_DIVISION_OP(__builtin_floor(x / y),krk_operator_floordiv,0)
 			case OP_MODULO:        BINARY_OP(mod)
 			case OP_BITOR:         BINARY_OP(or)
 			case OP_BITXOR:        BINARY_OP(xor)
@@ -2224,8 +2522,8 @@ _finishReturn: (void)0;
 			case OP_EQUAL:         BINARY_OP(eq);
 			case OP_IS:            BINARY_OP(is);
 			case OP_BITNEGATE:     LIKELY_INT_UNARY_OP(invert,~)
-			case OP_NEGATE:        LIKELY_INT_UNARY_OP(neg,-)
-			case OP_POS:           LIKELY_INT_UNARY_OP(pos,+)
+			case OP_NEGATE:        LIKELY_NUMERIC_UNARY_OP(neg,-)
+			case OP_POS:           LIKELY_NUMERIC_UNARY_OP(pos,+)
 			case OP_NONE:  krk_push(NONE_VAL()); break;
 			case OP_TRUE:  krk_push(BOOLEAN_VAL(1)); break;
 			case OP_FALSE: krk_push(BOOLEAN_VAL(0)); break;
@@ -2233,11 +2531,11 @@ _finishReturn: (void)0;
 			case OP_NOT:   krk_currentThread.stackTop[-1] = BOOLEAN_VAL(krk_isFalsey(krk_peek(0))); break;
 			case OP_POP:   krk_pop(); break;
 
-			case OP_INPLACE_ADD:        INPLACE_BINARY_OP(add)
-			case OP_INPLACE_SUBTRACT:   INPLACE_BINARY_OP(sub)
-			case OP_INPLACE_MULTIPLY:   INPLACE_BINARY_OP(mul)
-			case OP_INPLACE_DIVIDE:     INPLACE_BINARY_OP(truediv)
-			case OP_INPLACE_FLOORDIV:   INPLACE_BINARY_OP(floordiv)
+			case OP_INPLACE_ADD:        LIKELY_NUMERIC_BINARY_OP(add,+,krk_operator_iadd)
+			case OP_INPLACE_SUBTRACT:   LIKELY_NUMERIC_BINARY_OP(sub,-,krk_operator_isub)
+			case OP_INPLACE_MULTIPLY:   LIKELY_NUMERIC_BINARY_OP(mul,*,krk_operator_imul)
+			case OP_INPLACE_DIVIDE:     LIKELY_FLOAT_DIVISION_OP(x / y,krk_operator_itruediv,1)
+			case OP_INPLACE_FLOORDIV:   LIKELY_FLOAT_DIVISION_OP(__builtin_floor(x / y),krk_operator_ifloordiv,0)
 			case OP_INPLACE_MODULO:     INPLACE_BINARY_OP(mod)
 			case OP_INPLACE_BITOR:      INPLACE_BINARY_OP(or)
 			case OP_INPLACE_BITXOR:     INPLACE_BINARY_OP(xor)
@@ -2260,10 +2558,22 @@ _finishReturn: (void)0;
 				krk_pop();
 				break;
 			case OP_INVOKE_GETTER: {
+				KrkValue result;
+				if (getterFast(krk_peek(1), krk_peek(0), &result)) {
+					krk_pop();
+					krk_currentThread.stackTop[-1] = result;
+					break;
+				}
 				commonMethodInvoke(offsetof(KrkClass,_getter), 2, "'%T' object is not subscriptable");
 				break;
 			}
 			case OP_INVOKE_SETTER: {
+				if (setterFast(krk_peek(2), krk_peek(1), krk_peek(0))) {
+					KrkValue value = krk_pop();
+					krk_pop();
+					krk_currentThread.stackTop[-1] = value;
+					break;
+				}
 				commonMethodInvoke(offsetof(KrkClass,_setter), 3, "'%T' object doesn't support item assignment");
 				break;
 			}
@@ -2312,6 +2622,7 @@ _finishReturn: (void)0;
 				subclass->allocSize = AS_CLASS(superclass)->allocSize;
 				subclass->_ongcsweep = AS_CLASS(superclass)->_ongcsweep;
 				subclass->_ongcscan = AS_CLASS(superclass)->_ongcscan;
+				subclass->_ongetbuffer = AS_CLASS(superclass)->_ongetbuffer;
 				krk_tableSet(&AS_CLASS(superclass)->subclasses, krk_peek(1), NONE_VAL());
 				krk_pop(); /* Super class */
 				break;
@@ -2515,8 +2826,13 @@ _finishReturn: (void)0;
 			case OP_CALL_ITER: {
 				TWO_BYTE_OPERAND;
 				KrkValue iter = krk_peek(0);
-				krk_push(iter);
-				krk_push(krk_callStack(0));
+				KrkValue next;
+				if (iterateBuiltin(iter, &next)) {
+					krk_push(next);
+				} else {
+					krk_push(iter);
+					krk_push(krk_callStack(0));
+				}
 				/* krk_valuesSame() */
 				if (iter == krk_peek(0)) frame->ip += OPERAND;
 				break;
@@ -2524,11 +2840,26 @@ _finishReturn: (void)0;
 			case OP_LOOP_ITER: {
 				TWO_BYTE_OPERAND;
 				KrkValue iter = krk_peek(0);
-				krk_push(iter);
-				krk_push(krk_callStack(0));
+				KrkValue next;
+				if (iterateBuiltin(iter, &next)) {
+					krk_push(next);
+				} else {
+					krk_push(iter);
+					krk_push(krk_callStack(0));
+				}
 				if (iter != krk_peek(0)) frame->ip -= OPERAND;
 				break;
 			}
+			case OP_RANGE_ITER: {
+				TWO_BYTE_OPERAND;
+				if (!rangeNext()) frame->ip += OPERAND;
+				break;
+			}
+			case OP_RANGE_LOOP: {
+				TWO_BYTE_OPERAND;
+				if (rangeNext()) frame->ip -= OPERAND;
+				break;
+			}
 			case OP_TEST_ARG: {
 				TWO_BYTE_OPERAND;
 				if (krk_pop() != KWARGS_VAL(0)) frame->ip += OPERAND;
@@ -2620,6 +2951,13 @@ _finishReturn: (void)0;
 				krk_currentThread.stack[frame->slots + OPERAND] = krk_pop();
 				break;
 			}
+			case OP_RANGE_START_LONG:
+				THREE_BYTE_OPERAND;
+			case OP_RANGE_START: {
+				ONE_BYTE_OPERAND;
+				rangeStart(OPERAND);
+				break;
+			}
 			case OP_CALL_LONG:
 				THREE_BYTE_OPERAND;
 			case OP_CALL: {